@@ -3,11 +3,15 @@
 #include <csignal>
 #include <iostream>
 #include <map>
+#include <set>
+#include <sstream>
 #include <string>
+#include <vector>
 
 typedef void (*sighandler_t)(int sig);
 
 #include "cereal/services.h"
+#include "cereal/messaging/bridge_packet.h"
 #include "cereal/messaging/impl_msgq.h"
 #include "cereal/messaging/impl_zmq.h"
 
@@ -21,11 +25,24 @@ void sigpipe_handler(int sig) {
   std::cout << "SIGPIPE received" << std::endl;
 }
 
-static std::vector<std::string> get_services(std::string whitelist_str, bool zmq_to_msgq) {
+// Comma separated list of exact service names
+static std::set<std::string> parse_list(const std::string &list_str) {
+  std::set<std::string> list;
+  std::stringstream ss(list_str);
+  std::string name;
+  while (std::getline(ss, name, ',')) {
+    name.erase(0, name.find_first_not_of(" "));
+    name.erase(name.find_last_not_of(" ") + 1);
+    if (!name.empty()) list.insert(name);
+  }
+  return list;
+}
+
+static std::vector<std::string> get_services(const std::set<std::string> &whitelist, bool zmq_to_msgq) {
   std::vector<std::string> service_list;
   for (const auto& it : services) {
     std::string name = it.second.name;
-    bool in_whitelist = whitelist_str.find(name) != std::string::npos;
+    bool in_whitelist = whitelist.count(name) > 0;
     if (name == "plusFrame" || name == "uiLayoutState" || (zmq_to_msgq && !in_whitelist)) {
       continue;
     }
@@ -34,6 +51,115 @@ static std::vector<std::string> get_services(std::string whitelist_str, bool zmq
   return service_list;
 }
 
+static void send_retry(PubSocket *pub_sock, char *data, size_t size) {
+  int ret;
+  do {
+    ret = pub_sock->send(data, size);
+  } while (ret == -1 && errno == EINTR && !do_exit);
+  assert(ret >= 0 || do_exit);
+}
+
+// The messages of one service in a bridge packet, published as a batch
+struct PubBatch {
+  PubSocket *sock;
+  std::vector<char *> data;
+  std::vector<size_t> sizes;
+};
+
+static void send_batch_retry(PubBatch &batch) {
+  int ret;
+  do {
+    ret = batch.sock->sendMany(batch.data.data(), batch.sizes.data(), batch.data.size());
+  } while (ret == -1 && errno == EINTR && !do_exit);
+  assert(ret >= 0 || do_exit);
+  batch.data.clear();
+  batch.sizes.clear();
+}
+
+// Sends everything that arrived during a poll cycle as one packet on BRIDGE_COALESCED_PORT
+static int coalesced_msgq_to_zmq(const std::set<std::string> &compress) {
+  MSGQContext sub_context;
+  ZMQContext pub_context;
+  MSGQPoller poller;
+
+  ZMQPubSocket pub_sock;
+  pub_sock.connect(&pub_context, std::to_string(BRIDGE_COALESCED_PORT), false);
+
+  std::map<SubSocket*, std::pair<std::string, bool>> sub_names;
+  for (auto endpoint : get_services({}, false)) {
+    SubSocket *sub_sock = new MSGQSubSocket();
+    sub_sock->connect(&sub_context, endpoint, "127.0.0.1", false);
+    poller.registerSocket(sub_sock);
+    sub_names[sub_sock] = {endpoint, compress.count(endpoint) > 0};
+  }
+
+  BridgePacketWriter writer;
+  while (!do_exit) {
+    for (auto sub_sock : poller.poll(100)) {
+      auto &[name, compressed] = sub_names[sub_sock];
+      while (Message *msg = sub_sock->receive(true)) {
+        writer.add(name, msg->getData(), msg->getSize(), compressed);
+        delete msg;
+      }
+    }
+
+    if (writer.count() > 0) {
+      const std::vector<char> &packet = writer.finish();
+      send_retry(&pub_sock, (char *)packet.data(), packet.size());
+      writer.clear();
+    }
+  }
+
+  for (auto &it : sub_names) delete it.first;
+  return 0;
+}
+
+static int coalesced_zmq_to_msgq(const std::string &ip, const std::set<std::string> &whitelist) {
+  ZMQContext sub_context;
+  MSGQContext pub_context;
+
+  ZMQSubSocket sub_sock;
+  sub_sock.connect(&sub_context, std::to_string(BRIDGE_COALESCED_PORT), ip, false, false);
+  sub_sock.setTimeout(100);
+
+  std::map<std::string, PubBatch> pub_batches;
+  for (auto endpoint : get_services(whitelist, true)) {
+    PubSocket *pub_sock = new MSGQPubSocket();
+    pub_sock->connect(&pub_context, endpoint);
+    pub_batches[endpoint].sock = pub_sock;
+  }
+
+  BridgePacketReader reader;
+  std::vector<PubBatch *> pending;
+  while (!do_exit) {
+    Message *msg = sub_sock.receive();
+    if (msg == NULL) continue;
+
+    // the data stays valid until the next packet is parsed
+    bool ok = reader.parse(msg->getData(), msg->getSize(), [&](const std::string &name, char *data, size_t size) {
+      auto it = pub_batches.find(name);
+      if (it != pub_batches.end()) {
+        if (it->second.data.empty()) pending.push_back(&it->second);
+        it->second.data.push_back(data);
+        it->second.sizes.push_back(size);
+      }
+    });
+    if (!ok) {
+      std::cout << "Warning, dropping malformed bridge packet" << std::endl;
+    }
+
+    // every service is published once per packet, its readers are woken up once
+    for (PubBatch *batch : pending) {
+      send_batch_retry(*batch);
+    }
+    pending.clear();
+    delete msg;
+  }
+
+  for (auto &it : pub_batches) delete it.second.sock;
+  return 0;
+}
+
 int main(int argc, char** argv) {
   signal(SIGPIPE, (sighandler_t)sigpipe_handler);
   signal(SIGINT, (sighandler_t)set_do_exit);
@@ -41,7 +167,13 @@ int main(int argc, char** argv) {
 
   bool zmq_to_msgq = argc > 2;
   std::string ip = zmq_to_msgq ? argv[1] : "127.0.0.1";
-  std::string whitelist_str = zmq_to_msgq ? std::string(argv[2]) : "";
+  std::set<std::string> whitelist = parse_list(zmq_to_msgq ? std::string(argv[2]) : "");
+
+  // Both ends need BRIDGE_COALESCE, BRIDGE_COMPRESS lists the services to compress with zstd
+  if (std::getenv("BRIDGE_COALESCE")) {
+    const char *compress = std::getenv("BRIDGE_COMPRESS");
+    return zmq_to_msgq ? coalesced_zmq_to_msgq(ip, whitelist) : coalesced_msgq_to_zmq(parse_list(compress ? compress : ""));
+  }
 
   Poller *poller;
   Context *pub_context;
@@ -57,7 +189,7 @@ int main(int argc, char** argv) {
   }
 
   std::map<SubSocket*, PubSocket*> sub2pub;
-  for (auto endpoint : get_services(whitelist_str, zmq_to_msgq)) {
+  for (auto endpoint : get_services(whitelist, zmq_to_msgq)) {
     PubSocket * pub_sock;
     SubSocket * sub_sock;
     if (zmq_to_msgq) {
@@ -0,0 +1,111 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <zmq.h>
+
+#include "cereal/messaging/bridge_packet.h"
+
+// Loopback benchmark of the bridge wire formats: one ZMQ message per service message,
+// one coalesced packet per poll cycle, and coalesced with zstd.
+
+#define BENCH_ENDPOINT "tcp://127.0.0.1:8198"
+#define CYCLES 2000
+#define MSGS_PER_CYCLE 40
+#define MSG_SIZE 1200
+
+enum Mode { SINGLE, COALESCED, COMPRESSED };
+
+static std::vector<std::vector<char>> make_msgs() {
+  // Mostly static payloads with a few changing bytes, like can or carState
+  std::mt19937 gen(0);
+  std::vector<std::vector<char>> msgs(MSGS_PER_CYCLE, std::vector<char>(MSG_SIZE));
+  for (auto &msg : msgs) {
+    for (size_t i = 0; i < msg.size(); i++) {
+      msg[i] = (i % 16 < 4) ? gen() : (i / 16);
+    }
+  }
+  return msgs;
+}
+
+static void bench(Mode mode, const char *mode_name) {
+  void *ctx = zmq_ctx_new();
+  void *pub = zmq_socket(ctx, ZMQ_PUB);
+  void *sub = zmq_socket(ctx, ZMQ_SUB);
+  int hwm = 0;
+  zmq_setsockopt(pub, ZMQ_SNDHWM, &hwm, sizeof(hwm));
+  zmq_setsockopt(sub, ZMQ_RCVHWM, &hwm, sizeof(hwm));
+  zmq_setsockopt(sub, ZMQ_SUBSCRIBE, "", 0);
+  zmq_bind(pub, BENCH_ENDPOINT);
+  zmq_connect(sub, BENCH_ENDPOINT);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  const size_t total_msgs = (size_t)CYCLES * MSGS_PER_CYCLE;
+  std::atomic<size_t> received_msgs = 0;
+  size_t wire_bytes = 0;
+
+  std::thread receiver([&]() {
+    int timeout = 1000;
+    zmq_setsockopt(sub, ZMQ_RCVTIMEO, &timeout, sizeof(timeout));
+    BridgePacketReader reader;
+    zmq_msg_t msg;
+    zmq_msg_init(&msg);
+    while (received_msgs < total_msgs && zmq_msg_recv(&msg, sub, 0) >= 0) {
+      if (mode == SINGLE) {
+        received_msgs++;
+      } else {
+        reader.parse((char *)zmq_msg_data(&msg), zmq_msg_size(&msg), [&](const std::string &, char *, size_t) {
+          received_msgs++;
+        });
+      }
+    }
+    zmq_msg_close(&msg);
+  });
+
+  auto msgs = make_msgs();
+  BridgePacketWriter writer;
+  auto start = std::chrono::steady_clock::now();
+
+  for (int cycle = 0; cycle < CYCLES; cycle++) {
+    for (int i = 0; i < MSGS_PER_CYCLE; i++) {
+      auto &msg = msgs[i];
+      *(int *)msg.data() = cycle;
+      if (mode == SINGLE) {
+        zmq_send(pub, msg.data(), msg.size(), 0);
+        wire_bytes += msg.size();
+      } else {
+        writer.add("service" + std::to_string(i), msg.data(), msg.size(), mode == COMPRESSED);
+      }
+    }
+
+    if (mode != SINGLE) {
+      const std::vector<char> &packet = writer.finish();
+      zmq_send(pub, packet.data(), packet.size(), 0);
+      wire_bytes += packet.size();
+      writer.clear();
+    }
+  }
+
+  receiver.join();
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  double payload_bytes = (double)received_msgs * MSG_SIZE;
+
+  printf("%-10s %9.0f msgs/s %8.1f MB/s payload %8.1f MB/s on the wire, %zu/%zu received, %.2fx ratio\n",
+         mode_name, received_msgs / elapsed, payload_bytes / elapsed / 1e6, wire_bytes / elapsed / 1e6,
+         received_msgs.load(), total_msgs, (double)total_msgs * MSG_SIZE / wire_bytes);
+
+  zmq_close(sub);
+  zmq_close(pub);
+  zmq_ctx_term(ctx);
+}
+
+int main() {
+  bench(SINGLE, "single");
+  bench(COALESCED, "coalesced");
+  bench(COMPRESSED, "zstd");
+  return 0;
+}
@@ -0,0 +1,130 @@
+#include "cereal/messaging/bridge_packet.h"
+
+#include <cassert>
+#include <cstring>
+
+// Fast level, the bridge is limited by the link and not by the CPU
+#define BRIDGE_ZSTD_LEVEL 1
+
+struct __attribute__((packed)) bridge_packet_header {
+  uint32_t magic;
+  uint32_t count;
+};
+
+struct __attribute__((packed)) bridge_msg_header {
+  uint8_t name_len;
+  uint8_t flags;
+  uint32_t raw_size;
+  uint32_t payload_size;
+};
+
+BridgePacketWriter::BridgePacketWriter() {
+  cctx = ZSTD_createCCtx();
+  assert(cctx != nullptr);
+  clear();
+}
+
+BridgePacketWriter::~BridgePacketWriter() {
+  ZSTD_freeCCtx(cctx);
+}
+
+void BridgePacketWriter::clear() {
+  buf.resize(sizeof(bridge_packet_header));
+  num_msgs = 0;
+}
+
+void BridgePacketWriter::add(const std::string &name, const char *data, size_t size, bool compress) {
+  assert(name.size() <= UINT8_MAX);
+
+  size_t pos = buf.size();
+  size_t payload_pos = pos + sizeof(bridge_msg_header) + name.size();
+  size_t bound = compress ? ZSTD_compressBound(size) : size;
+  buf.resize(payload_pos + bound);
+
+  bridge_msg_header header = {
+    .name_len = (uint8_t)name.size(),
+    .flags = 0,
+    .raw_size = (uint32_t)size,
+    .payload_size = (uint32_t)size,
+  };
+
+  if (compress) {
+    size_t r = ZSTD_compressCCtx(cctx, &buf[payload_pos], bound, data, size, BRIDGE_ZSTD_LEVEL);
+    // Send small or incompressible messages as they are
+    if (!ZSTD_isError(r) && r < size) {
+      header.flags |= BRIDGE_FLAG_ZSTD;
+      header.payload_size = r;
+    }
+  }
+
+  if (!(header.flags & BRIDGE_FLAG_ZSTD)) {
+    memcpy(&buf[payload_pos], data, size);
+  }
+
+  memcpy(&buf[pos], &header, sizeof(header));
+  memcpy(&buf[pos + sizeof(header)], name.data(), name.size());
+  buf.resize(payload_pos + header.payload_size);
+  num_msgs++;
+}
+
+const std::vector<char> &BridgePacketWriter::finish() {
+  bridge_packet_header header = {.magic = BRIDGE_PACKET_MAGIC, .count = num_msgs};
+  memcpy(buf.data(), &header, sizeof(header));
+  return buf;
+}
+
+BridgePacketReader::BridgePacketReader() {
+  dctx = ZSTD_createDCtx();
+  assert(dctx != nullptr);
+}
+
+BridgePacketReader::~BridgePacketReader() {
+  ZSTD_freeDCtx(dctx);
+}
+
+bool BridgePacketReader::parse(const char *data, size_t size, const std::function<void(const std::string &, char *, size_t)> &f) {
+  bridge_packet_header packet_header;
+  if (size < sizeof(packet_header)) return false;
+  memcpy(&packet_header, data, sizeof(packet_header));
+  if (packet_header.magic != BRIDGE_PACKET_MAGIC) return false;
+
+  // Check and decompress the whole packet before handing out anything,
+  // a malformed packet must not be partly published
+  msgs.clear();
+  decompressed.clear();
+  size_t pos = sizeof(packet_header);
+  for (uint32_t i = 0; i < packet_header.count; i++) {
+    bridge_msg_header header;
+    if (size - pos < sizeof(header)) return false;
+    memcpy(&header, &data[pos], sizeof(header));
+    pos += sizeof(header);
+
+    if (size - pos < (size_t)header.name_len + header.payload_size) return false;
+    Msg &m = msgs.emplace_back();
+    m.name_pos = pos;
+    m.name_len = header.name_len;
+    pos += header.name_len;
+
+    if (header.flags & BRIDGE_FLAG_ZSTD) {
+      if (ZSTD_getFrameContentSize(&data[pos], header.payload_size) != header.raw_size) return false;
+      m.compressed = true;
+      m.pos = decompressed.size();
+      m.size = header.raw_size;
+      decompressed.resize(m.pos + m.size);
+      size_t r = ZSTD_decompressDCtx(dctx, &decompressed[m.pos], m.size, &data[pos], header.payload_size);
+      if (ZSTD_isError(r) || r != header.raw_size) return false;
+    } else {
+      m.compressed = false;
+      m.pos = pos;
+      m.size = header.payload_size;
+    }
+    pos += header.payload_size;
+  }
+  if (pos != size) return false;
+
+  for (const Msg &m : msgs) {
+    name.assign(&data[m.name_pos], m.name_len);
+    f(name, m.compressed ? &decompressed[m.pos] : (char *)&data[m.pos], m.size);
+  }
+  return true;
+}
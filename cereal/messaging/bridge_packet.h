@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <zstd.h>
+
+#define BRIDGE_PACKET_MAGIC 0x31475242 // "BRG1"
+#define BRIDGE_COALESCED_PORT 8199
+
+// A coalesced bridge packet is a header followed by the messages of one poll cycle:
+//   uint32_t magic, uint32_t count
+//   count times: uint8_t name_len, uint8_t flags, uint32_t raw_size, uint32_t payload_size, name, payload
+// Services are identified by name, so both ends don't need to be built from the same service list.
+
+#define BRIDGE_FLAG_ZSTD 1
+
+class BridgePacketWriter {
+public:
+  BridgePacketWriter();
+  ~BridgePacketWriter();
+  void add(const std::string &name, const char *data, size_t size, bool compress);
+  // Returns the packet with all messages added since the last clear()
+  const std::vector<char> &finish();
+  void clear();
+  inline uint32_t count() const { return num_msgs; }
+
+private:
+  std::vector<char> buf;
+  uint32_t num_msgs = 0;
+  ZSTD_CCtx *cctx;
+};
+
+class BridgePacketReader {
+public:
+  BridgePacketReader();
+  ~BridgePacketReader();
+  // Calls f for every message in the packet, returns false without calling f if the packet is malformed
+  bool parse(const char *data, size_t size, const std::function<void(const std::string &name, char *data, size_t size)> &f);
+
+private:
+  struct Msg {
+    size_t name_pos, name_len;
+    size_t pos, size;  // into the packet, or into decompressed if compressed
+    bool compressed;
+  };
+  std::vector<Msg> msgs;
+  std::vector<char> decompressed;
+  std::string name;
+  ZSTD_DCtx *dctx;
+};
@@ -0,0 +1,100 @@
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catch2/catch.hpp"
+#include "cereal/messaging/bridge_packet.h"
+
+typedef std::vector<std::pair<std::string, std::string>> bridge_msgs;
+
+static std::vector<char> bridge_test_packet(const bridge_msgs &msgs, bool compress){
+  BridgePacketWriter writer;
+  for (auto &[name, data] : msgs){
+    writer.add(name, data.data(), data.size(), compress);
+  }
+  return writer.finish();
+}
+
+static bool bridge_test_parse(const std::vector<char> &packet, bridge_msgs &out){
+  BridgePacketReader reader;
+  out.clear();
+  return reader.parse(packet.data(), packet.size(), [&](const std::string &name, char *data, size_t size){
+    out.emplace_back(name, std::string(data, size));
+  });
+}
+
+static bridge_msgs bridge_test_msgs(){
+  return {
+    {"carState", std::string(2000, 'a')},
+    {"can", "x"},
+    {"empty", ""},
+    {"controlsState", std::string(300, 'b') + std::string(300, 'c')},
+  };
+}
+
+TEST_CASE("BridgePacket round trip"){
+  bool compress = GENERATE(false, true);
+  bridge_msgs msgs = bridge_test_msgs();
+  auto packet = bridge_test_packet(msgs, compress);
+
+  bridge_msgs out;
+  REQUIRE(bridge_test_parse(packet, out));
+  REQUIRE(out == msgs);
+
+  // compressible messages get smaller, the rest is sent as is
+  if (compress){
+    REQUIRE(packet.size() < bridge_test_packet(msgs, false).size());
+  }
+}
+
+TEST_CASE("BridgePacket empty packet"){
+  bridge_msgs out;
+  REQUIRE(bridge_test_parse(bridge_test_packet({}, true), out));
+  REQUIRE(out.empty());
+}
+
+TEST_CASE("BridgePacket truncated packet is rejected"){
+  bool compress = GENERATE(false, true);
+  auto packet = bridge_test_packet(bridge_test_msgs(), compress);
+
+  for (size_t size = 0; size < packet.size(); size++){
+    std::vector<char> truncated(packet.begin(), packet.begin() + size);
+    bridge_msgs out;
+    REQUIRE_FALSE(bridge_test_parse(truncated, out));
+    // nothing from a malformed packet is delivered
+    REQUIRE(out.empty());
+  }
+}
+
+TEST_CASE("BridgePacket trailing data is rejected"){
+  auto packet = bridge_test_packet(bridge_test_msgs(), true);
+  packet.push_back(0);
+
+  bridge_msgs out;
+  REQUIRE_FALSE(bridge_test_parse(packet, out));
+  REQUIRE(out.empty());
+}
+
+TEST_CASE("BridgePacket corrupt packet is rejected"){
+  auto packet = bridge_test_packet(bridge_test_msgs(), true);
+  bridge_msgs out;
+
+  SECTION("bad magic"){
+    packet[0] ^= 0xff;
+  }
+  SECTION("message count too large"){
+    packet[4] += 1;
+  }
+  SECTION("corrupt compressed payload"){
+    // first message starts after the 8 byte packet header, its payload after the 10 byte message header and the name
+    size_t payload_pos = 8 + 10 + std::string("carState").size();
+    for (size_t i = 0; i < 4; i++) packet[payload_pos + i] ^= 0xff;
+  }
+  SECTION("raw size mismatch"){
+    // raw_size of the first message is at offset 2 in its header
+    packet[8 + 2] += 1;
+  }
+
+  REQUIRE_FALSE(bridge_test_parse(packet, out));
+  REQUIRE(out.empty());
+}
@@ -54,6 +54,19 @@ public:
 
     return TSubSocket::receive(non_blocking);
   }
+
+  // Always go through receive() so every message is synchronized with the fake events
+  size_t receiveBorrow(const char **data, bool non_blocking=false) override {
+    return SubSocket::receiveBorrow(data, non_blocking);
+  }
+
+  bool borrowValid() override {
+    return SubSocket::borrowValid();
+  }
+
+  bool releaseBorrow() override {
+    return SubSocket::releaseBorrow();
+  }
 };
 
 class FakePoller: public Poller {
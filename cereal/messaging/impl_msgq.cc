@@ -20,6 +20,14 @@ static bool service_exists(std::string path){
   return services.count(path) > 0;
 }
 
+static int service_new_queue(msgq_queue_t *q, std::string path){
+  auto it = services.find(path);
+  if (it == services.end()){
+    return msgq_new_queue(q, path.c_str(), DEFAULT_SEGMENT_SIZE);
+  }
+  return msgq_new_queue(q, path.c_str(), it->second.segment_size, it->second.num_readers);
+}
+
 
 MSGQContext::MSGQContext() {
 }
@@ -63,7 +71,7 @@ int MSGQSubSocket::connect(Context *context, std::string endpoint, std::string a
   }
 
   q = new msgq_queue_t;
-  int r = msgq_new_queue(q, endpoint.c_str(), DEFAULT_SEGMENT_SIZE);
+  int r = service_new_queue(q, endpoint);
   if (r != 0){
     return r;
   }
@@ -80,7 +88,7 @@ int MSGQSubSocket::connect(Context *context, std::string endpoint, std::string a
 }
 
 
-Message * MSGQSubSocket::receive(bool non_blocking){
+int MSGQSubSocket::recv(msgq_msg_t *msg, bool non_blocking, int (*recv_func)(msgq_msg_t *, msgq_queue_t *)){
   msgq_do_exit = 0;
 
   void (*prev_handler_sigint)(int);
@@ -90,11 +98,7 @@ Message * MSGQSubSocket::receive(bool non_blocking){
     prev_handler_sigterm = std::signal(SIGTERM, sig_handler);
   }
 
-  msgq_msg_t msg;
-
-  MSGQMessage *r = NULL;
-
-  int rc = msgq_msg_recv(&msg, q);
+  int rc = recv_func(msg, q);
 
   // Hack to implement blocking read with a poller. Don't use this
   while (!non_blocking && rc == 0 && msgq_do_exit == 0){
@@ -104,7 +108,7 @@ Message * MSGQSubSocket::receive(bool non_blocking){
     int t = (timeout != -1) ? timeout : 100;
 
     int n = msgq_poll(items, 1, t);
-    rc = msgq_msg_recv(&msg, q);
+    rc = recv_func(msg, q);
 
     // The poll indicated a message was ready, but the receive failed. Try again
     if (n == 1 && rc == 0){
@@ -124,6 +128,16 @@ Message * MSGQSubSocket::receive(bool non_blocking){
 
   errno = msgq_do_exit ? EINTR : 0;
 
+  return rc;
+}
+
+Message * MSGQSubSocket::receive(bool non_blocking){
+  msgq_msg_t msg;
+
+  MSGQMessage *r = NULL;
+
+  int rc = recv(&msg, non_blocking, msgq_msg_recv);
+
   if (rc > 0){
     if (msgq_do_exit){
       msgq_msg_close(&msg); // Free unused message on exit
@@ -136,6 +150,38 @@ Message * MSGQSubSocket::receive(bool non_blocking){
   return (Message*)r;
 }
 
+size_t MSGQSubSocket::receiveBorrow(const char **data, bool non_blocking){
+  assert(!borrowed);
+  msgq_msg_t msg;
+
+  int rc = recv(&msg, non_blocking, msgq_msg_recv_borrow);
+
+  if (rc > 0){
+    if (msgq_do_exit){
+      msgq_msg_borrow_release(q); // Skip unused message on exit
+    } else {
+      borrowed = true;
+      *data = msg.data;
+      return msg.size;
+    }
+  }
+
+  return 0;
+}
+
+bool MSGQSubSocket::borrowValid(){
+  return !borrowed || msgq_msg_borrow_valid(q);
+}
+
+bool MSGQSubSocket::releaseBorrow(){
+  if (!borrowed){
+    return true;
+  }
+
+  borrowed = false;
+  return msgq_msg_borrow_release(q);
+}
+
 void MSGQSubSocket::setTimeout(int t){
   timeout = t;
 }
@@ -155,7 +201,7 @@ int MSGQPubSocket::connect(Context *context, std::string endpoint, bool check_en
   }
 
   q = new msgq_queue_t;
-  int r = msgq_new_queue(q, endpoint.c_str(), DEFAULT_SEGMENT_SIZE);
+  int r = service_new_queue(q, endpoint);
   if (r != 0){
     return r;
   }
@@ -181,6 +227,16 @@ int MSGQPubSocket::send(char *data, size_t size){
   return msgq_msg_send(&msg, q);
 }
 
+int MSGQPubSocket::sendMany(char **data, size_t *sizes, size_t n){
+  batch.resize(n);
+  for (size_t i = 0; i < n; i++){
+    batch[i].data = data[i];
+    batch[i].size = sizes[i];
+  }
+
+  return msgq_msg_send_many(batch.data(), n, q);
+}
+
 bool MSGQPubSocket::all_readers_updated() {
   return msgq_all_readers_updated(q);
 }
@@ -203,13 +259,17 @@ void MSGQPoller::registerSocket(SubSocket * socket){
 
 std::vector<SubSocket*> MSGQPoller::poll(int timeout){
   std::vector<SubSocket*> r;
+  pollInto(timeout, r);
+  return r;
+}
+
+void MSGQPoller::pollInto(int timeout, std::vector<SubSocket*> &ready){
+  ready.clear();
 
   msgq_poll(polls, num_polls, timeout);
   for (size_t i = 0; i < num_polls; i++){
     if (polls[i].revents){
-      r.push_back(sockets[i]);
+      ready.push_back(sockets[i]);
     }
   }
-
-  return r;
 }
@@ -35,21 +35,28 @@ class MSGQSubSocket : public SubSocket {
 private:
   msgq_queue_t * q = NULL;
   int timeout;
+  bool borrowed = false;
+  int recv(msgq_msg_t *msg, bool non_blocking, int (*recv_func)(msgq_msg_t *, msgq_queue_t *));
 public:
   int connect(Context *context, std::string endpoint, std::string address, bool conflate=false, bool check_endpoint=true);
   void setTimeout(int timeout);
   void * getRawSocket() {return (void*)q;}
   Message *receive(bool non_blocking=false);
+  size_t receiveBorrow(const char **data, bool non_blocking=false);
+  bool borrowValid();
+  bool releaseBorrow();
   ~MSGQSubSocket();
 };
 
 class MSGQPubSocket : public PubSocket {
 private:
   msgq_queue_t * q = NULL;
+  std::vector<msgq_msg_t> batch;
 public:
   int connect(Context *context, std::string endpoint, bool check_endpoint=true);
   int sendMessage(Message *message);
   int send(char *data, size_t size);
+  int sendMany(char **data, size_t *sizes, size_t n);
   bool all_readers_updated();
   ~MSGQPubSocket();
 };
@@ -63,5 +70,6 @@ private:
 public:
   void registerSocket(SubSocket *socket);
   std::vector<SubSocket*> poll(int timeout);
+  void pollInto(int timeout, std::vector<SubSocket*> &ready);
   ~MSGQPoller(){}
 };
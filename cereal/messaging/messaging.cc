@@ -71,6 +71,23 @@ SubSocket * SubSocket::create(Context * context, std::string endpoint, std::stri
   }
 }
 
+size_t SubSocket::receiveBorrow(const char **data, bool non_blocking){
+  delete borrowed_msg;
+  borrowed_msg = receive(non_blocking);
+  if (borrowed_msg == nullptr) {
+    return 0;
+  }
+
+  *data = borrowed_msg->getData();
+  return borrowed_msg->getSize();
+}
+
+bool SubSocket::releaseBorrow(){
+  delete borrowed_msg;
+  borrowed_msg = nullptr;
+  return true;
+}
+
 PubSocket * PubSocket::create(){
   PubSocket * s;
   if (messaging_use_zmq()){
@@ -82,6 +99,16 @@ PubSocket * PubSocket::create(){
   return s;
 }
 
+int PubSocket::sendMany(char **data, size_t *sizes, size_t n){
+  for (size_t i = 0; i < n; i++){
+    int r = send(data[i], sizes[i]);
+    if (r < 0) {
+      return r;
+    }
+  }
+  return n;
+}
+
 PubSocket * PubSocket::create(Context * context, std::string endpoint, bool check_endpoint){
   PubSocket *s = PubSocket::create();
   int r = s->connect(context, endpoint, check_endpoint);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstring>
 #include <map>
 #include <string>
 #include <vector>
@@ -42,10 +43,19 @@ public:
   virtual int connect(Context *context, std::string endpoint, std::string address, bool conflate=false, bool check_endpoint=true) = 0;
   virtual void setTimeout(int timeout) = 0;
   virtual Message *receive(bool non_blocking=false) = 0;
+  // Receive without copying the message out of the transport. The data is owned by the socket,
+  // releaseBorrow() must be called before the next receive and returns false if the data was
+  // overwritten while it was in use.
+  virtual size_t receiveBorrow(const char **data, bool non_blocking=false);
+  virtual bool borrowValid() { return true; }
+  virtual bool releaseBorrow();
   virtual void * getRawSocket() = 0;
   static SubSocket * create();
   static SubSocket * create(Context * context, std::string endpoint, std::string address="127.0.0.1", bool conflate=false, bool check_endpoint=true);
-  virtual ~SubSocket(){}
+  virtual ~SubSocket(){ delete borrowed_msg; }
+
+protected:
+  Message *borrowed_msg = nullptr;
 };
 
 class PubSocket {
@@ -53,6 +63,8 @@ public:
   virtual int connect(Context *context, std::string endpoint, bool check_endpoint=true) = 0;
   virtual int sendMessage(Message *message) = 0;
   virtual int send(char *data, size_t size) = 0;
+  // Send a batch of messages, returns the number of messages sent. Readers are woken up once per batch where supported.
+  virtual int sendMany(char **data, size_t *sizes, size_t n);
   virtual bool all_readers_updated() = 0;
   static PubSocket * create();
   static PubSocket * create(Context * context, std::string endpoint, bool check_endpoint=true);
@@ -64,6 +76,8 @@ class Poller {
 public:
   virtual void registerSocket(SubSocket *socket) = 0;
   virtual std::vector<SubSocket*> poll(int timeout) = 0;
+  // Same as poll, but fills a caller owned vector so its storage can be reused
+  virtual void pollInto(int timeout, std::vector<SubSocket*> &ready) { ready = poll(timeout); }
   static Poller * create();
   static Poller * create(std::vector<SubSocket*> sockets);
   virtual ~Poller(){}
@@ -89,17 +103,35 @@ public:
   uint64_t rcv_time(const char *name) const;
   cereal::Event::Reader &operator[](const char *name) const;
 
+  // Index based access, resolve the index of a service once with index(name)
+  size_t index(const char *name) const;
+  bool updated(size_t idx) const;
+  bool alive(size_t idx) const;
+  bool valid(size_t idx) const;
+  uint64_t rcv_frame(size_t idx) const;
+  uint64_t rcv_time(size_t idx) const;
+  cereal::Event::Reader &operator[](size_t idx) const;
+
 private:
+  struct SubMessage;
   bool all_(const std::vector<const char *> &service_list, bool valid, bool alive);
+  void mark_updated(SubMessage *m, uint64_t current_time, cereal::Event::Reader event);
+  void update_alive(uint64_t current_time);
+  SubMessage *get(const char *name) const;
   Poller *poller_ = nullptr;
-  struct SubMessage;
-  std::map<SubSocket *, SubMessage *> messages_;
-  std::map<std::string, SubMessage *> services_;
+  std::vector<SubMessage *> messages_;
+  std::map<std::string, SubMessage *, std::less<>> services_;
+  std::vector<SubSocket *> polled_;
 };
 
 class MessageBuilder : public capnp::MallocMessageBuilder {
 public:
   MessageBuilder() = default;
+  // Builds in segment, which must be zeroed. The builder zeroes the part it used when it is
+  // destroyed, so one segment can be reused for every message. The first word is kept for
+  // the segment table: toBytes() of a message that fits is the segment itself, no copy.
+  explicit MessageBuilder(kj::ArrayPtr<capnp::word> segment)
+      : capnp::MallocMessageBuilder(segment.slice(1, segment.size())), segment_(segment) {}
 
   cereal::Event::Builder initEvent(bool valid = true) {
     cereal::Event::Builder event = initRoot<cereal::Event>();
@@ -112,6 +144,12 @@ public:
   }
 
   kj::ArrayPtr<capnp::byte> toBytes() {
+    auto segments = getSegmentsForOutput();
+    if (segment_.size() > 0 && segments.size() == 1 && segments[0].begin() == segment_.begin() + 1) {
+      const uint32_t table[2] = {0, (uint32_t)segments[0].size()};  // segment count - 1, size in words
+      memcpy(segment_.begin(), table, sizeof(table));
+      return segment_.slice(0, segments[0].size() + 1).asBytes();
+    }
     heapArray_ = capnp::messageToFlatArray(*this);
     return heapArray_.asBytes();
   }
@@ -130,6 +168,7 @@ public:
 
 private:
   kj::Array<capnp::word> heapArray_;
+  kj::ArrayPtr<capnp::word> segment_;
 };
 
 class PubMaster {
@@ -137,10 +176,13 @@ public:
   PubMaster(const std::vector<const char *> &service_list);
   inline int send(const char *name, capnp::byte *data, size_t size) { return sockets_.at(name)->send((char *)data, size); }
   int send(const char *name, MessageBuilder &msg);
+  int sendBatch(const char *name, const std::vector<MessageBuilder *> &msgs);
   ~PubMaster();
 
 private:
   std::map<std::string, PubSocket *> sockets_;
+  std::vector<char *> batch_data_;
+  std::vector<size_t> batch_sizes_;
 };
 
 class AlignedBuffer {
@@ -11,8 +11,10 @@
 #include <random>
 #include <string>
 #include <limits>
+#include <climits>
 
 #include <poll.h>
+#include <sys/file.h>
 #include <sys/ioctl.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
@@ -21,6 +23,10 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#ifdef __linux__
+#include <linux/futex.h>
+#endif
+
 #include <stdio.h>
 
 #include "cereal/messaging/msgq.h"
@@ -43,6 +49,84 @@ uint64_t msgq_get_uid(void){
   return uid;
 }
 
+static std::string msgq_shm_path(const char * path){
+  std::string full_path = "/dev/shm/";
+  const char* prefix = std::getenv("OPENPILOT_PREFIX");
+  if (prefix) {
+    full_path += std::string(prefix) + "/";
+  }
+  full_path += path;
+  return full_path;
+}
+
+static msgq_notify_slot_t * msgq_notify_table(void){
+#ifdef __linux__
+  static msgq_notify_slot_t * table = []() -> msgq_notify_slot_t * {
+    const size_t table_size = NUM_NOTIFY_SLOTS * sizeof(msgq_notify_slot_t);
+    std::string full_path = msgq_shm_path("msgq_notify");
+
+    auto fd = open(full_path.c_str(), O_RDWR | O_CREAT, 0664);
+    if (fd < 0) {
+      std::cout << "Warning, could not open: " << full_path << std::endl;
+      return NULL;
+    }
+
+    // Growing to the same size from multiple processes is harmless, the file is zero filled
+    if (ftruncate(fd, table_size) < 0) {
+      close(fd);
+      return NULL;
+    }
+
+    void * mem = mmap(NULL, table_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    return (mem == MAP_FAILED) ? NULL : (msgq_notify_slot_t *)mem;
+  }();
+  return table;
+#else
+  return NULL;
+#endif
+}
+
+struct msgq_thread_slot_t {
+  int idx = -1;
+
+  ~msgq_thread_slot_t(){
+    msgq_notify_slot_t * table = msgq_notify_table();
+    if (idx >= 0 && table != NULL){
+      uint32_t tid = syscall(SYS_gettid);
+      reinterpret_cast<std::atomic<uint32_t>*>(&table[idx].tid)->compare_exchange_strong(tid, 0);
+    }
+  }
+};
+
+// Claim a futex slot for the calling thread, returns -1 if futex notifications are unavailable
+static int msgq_notify_slot(void){
+  thread_local msgq_thread_slot_t slot;
+  if (slot.idx >= 0) return slot.idx;
+
+  msgq_notify_slot_t * table = msgq_notify_table();
+  if (table == NULL) return -1;
+
+  uint32_t tid = syscall(SYS_gettid);
+
+  // First look for a free slot, then take over slots of threads that exited without releasing theirs
+  for (int pass = 0; pass < 2; pass++){
+    for (int i = 0; i < NUM_NOTIFY_SLOTS; i++){
+      std::atomic<uint32_t> *owner = reinterpret_cast<std::atomic<uint32_t>*>(&table[i].tid);
+      uint32_t cur = *owner;
+
+      bool stale = (pass == 1) && (kill(cur, 0) != 0) && (errno == ESRCH);
+      if ((cur == tid || cur == 0 || stale) && owner->compare_exchange_strong(cur, tid)){
+        slot.idx = i;
+        return i;
+      }
+    }
+  }
+
+  std::cout << "Warning, no msgq notify slots left, falling back to signals" << std::endl;
+  return -1;
+}
+
 int msgq_msg_init_size(msgq_msg_t * msg, size_t size){
   msg->size = size;
   msg->data = new(std::nothrow) char[size];
@@ -83,62 +167,142 @@ void msgq_wait_for_subscriber(msgq_queue_t *q){
   return;
 }
 
-int msgq_new_queue(msgq_queue_t * q, const char * path, size_t size){
+size_t msgq_header_size(size_t max_readers){
+  return sizeof(msgq_header_t) + NUM_READER_FIELDS * max_readers * sizeof(uint64_t);
+}
+
+static uint64_t msgq_lag(uint64_t packed_read_pointer, uint64_t packed_write_pointer, size_t size){
+  uint32_t read_cycles, read_pointer, write_cycles, write_pointer;
+  UNPACK64(read_cycles, read_pointer, packed_read_pointer);
+  UNPACK64(write_cycles, write_pointer, packed_write_pointer);
+
+  if (read_cycles == write_cycles){
+    return write_pointer - read_pointer;
+  }
+  return (size - read_pointer) + write_pointer;
+}
+
+static void msgq_drop_reader(msgq_queue_t * q){
+  if (q->stats){
+    q->read_resets[q->reader_id]->fetch_add(1);
+  }
+  msgq_reset_reader(q);
+}
+
+int msgq_new_queue(msgq_queue_t * q, const char * path, size_t size, size_t max_readers){
   assert(size < 0xFFFFFFFF); // Buffer must be smaller than 2^32 bytes
+  assert(max_readers > 0);
   std::signal(SIGUSR2, sigusr2_handler);
 
-  std::string full_path = "/dev/shm/";
-  const char* prefix = std::getenv("OPENPILOT_PREFIX");
-  if (prefix) {
-    full_path += std::string(prefix) + "/";
-  }
-  full_path += path;
+  std::string full_path = msgq_shm_path(path);
 
-  auto fd = open(full_path.c_str(), O_RDWR | O_CREAT, 0664);
+  auto fd = open(full_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0664);
   if (fd < 0) {
     std::cout << "Warning, could not open: " << full_path << std::endl;
     return -1;
   }
 
-  int rc = ftruncate(fd, size + sizeof(msgq_header_t));
-  if (rc < 0){
+  // Every process with the queue mapped holds a shared lock on it. An opener that gets the exclusive
+  // lock is alone: it sizes a new segment and stores the layout, and recreates a queue with a different
+  // size or reader count, e.g. one left in /dev/shm by an older build. Resizing a queue in use would
+  // break everyone attached, so opening it with a different layout fails.
+  size_t header_size = msgq_header_size(max_readers);
+  bool exclusive = flock(fd, LOCK_EX | LOCK_NB) == 0;
+  struct stat st;
+  if ((!exclusive && flock(fd, LOCK_SH) != 0) || fstat(fd, &st) != 0){
+    close(fd);
+    return -1;
+  }
+  if (exclusive && st.st_size != 0 && (size_t)st.st_size != size + header_size){
+    std::cout << "Warning, recreating " << full_path << " with size " << size + header_size << ", was " << st.st_size << std::endl;
+    st.st_size = 0;
+  }
+  bool created = exclusive && st.st_size == 0;
+  // truncating to 0 first zero fills a recreated queue
+  if (created && (ftruncate(fd, 0) != 0 || ftruncate(fd, size + header_size) != 0)){
+    close(fd);
+    return -1;
+  }
+  if (!created && (size_t)st.st_size != size + header_size){
+    std::cout << "Error, " << full_path << " exists with size " << st.st_size << ", expected " << size + header_size << std::endl;
     close(fd);
     return -1;
   }
-  char * mem = (char*)mmap(NULL, size + sizeof(msgq_header_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
-  close(fd);
 
-  if (mem == NULL){
+  char * mem = (char*)mmap(NULL, size + header_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mem == MAP_FAILED){
+    close(fd);
     return -1;
   }
-  q->mmap_p = mem;
 
   msgq_header_t *header = (msgq_header_t *)mem;
+  if (exclusive && !created && header->max_readers != max_readers){
+    std::cout << "Warning, recreating " << full_path << " with " << max_readers << " readers, was " << header->max_readers << std::endl;
+    memset(mem, 0, size + header_size);
+    created = true;
+  }
+  if (created){
+    // Publisher and subscribers get the layout from the same service list, store it for tools inspecting the queue
+    header->max_readers = max_readers;
+  } else if (header->max_readers != max_readers){
+    std::cout << "Error, " << full_path << " exists with " << header->max_readers << " readers, expected " << max_readers << std::endl;
+    munmap(mem, size + header_size);
+    close(fd);
+    return -1;
+  }
+  if (exclusive){
+    // set up, let the other openers in
+    flock(fd, LOCK_SH);
+  }
+  q->fd = fd;
+  q->mmap_p = mem;
 
   // Setup pointers to header segment
   q->num_readers = reinterpret_cast<std::atomic<uint64_t>*>(&header->num_readers);
   q->write_pointer = reinterpret_cast<std::atomic<uint64_t>*>(&header->write_pointer);
   q->write_uid = reinterpret_cast<std::atomic<uint64_t>*>(&header->write_uid);
-
-  for (size_t i = 0; i < NUM_READERS; i++){
-    q->read_pointers[i] = reinterpret_cast<std::atomic<uint64_t>*>(&header->read_pointers[i]);
-    q->read_valids[i] = reinterpret_cast<std::atomic<uint64_t>*>(&header->read_valids[i]);
-    q->read_uids[i] = reinterpret_cast<std::atomic<uint64_t>*>(&header->read_uids[i]);
+  q->num_sent = reinterpret_cast<std::atomic<uint64_t>*>(&header->num_sent);
+  q->bytes_sent = reinterpret_cast<std::atomic<uint64_t>*>(&header->bytes_sent);
+
+  std::atomic<uint64_t> *readers = reinterpret_cast<std::atomic<uint64_t>*>(mem + sizeof(msgq_header_t));
+  q->read_pointers.resize(max_readers);
+  q->read_valids.resize(max_readers);
+  q->read_uids.resize(max_readers);
+  q->read_notify.resize(max_readers);
+  q->read_resets.resize(max_readers);
+  q->read_max_lag.resize(max_readers);
+
+  for (size_t i = 0; i < max_readers; i++){
+    q->read_pointers[i] = &readers[i];
+    q->read_valids[i] = &readers[max_readers + i];
+    q->read_uids[i] = &readers[2 * max_readers + i];
+    q->read_notify[i] = &readers[3 * max_readers + i];
+    q->read_resets[i] = &readers[4 * max_readers + i];
+    q->read_max_lag[i] = &readers[5 * max_readers + i];
   }
 
-  q->data = mem + sizeof(msgq_header_t);
+  q->data = mem + header_size;
   q->size = size;
+  q->max_readers = max_readers;
   q->reader_id = -1;
 
   q->endpoint = path;
   q->read_conflate = false;
+  q->notify_futex = std::getenv("MSGQ_FUTEX") != NULL;
+  q->stats = std::getenv("MSGQ_STATS") != NULL;
 
   return 0;
 }
 
 void msgq_close_queue(msgq_queue_t *q){
   if (q->mmap_p != NULL){
-    munmap(q->mmap_p, q->size + sizeof(msgq_header_t));
+    munmap(q->mmap_p, q->size + msgq_header_size(q->max_readers));
+    q->mmap_p = NULL;
+  }
+  if (q->fd >= 0){
+    // releases the shared lock
+    close(q->fd);
+    q->fd = -1;
   }
 }
 
@@ -149,10 +313,13 @@ void msgq_init_publisher(msgq_queue_t * q) {
 
   *q->write_uid = uid;
   *q->num_readers = 0;
+  *q->num_sent = 0;
+  *q->bytes_sent = 0;
 
-  for (size_t i = 0; i < NUM_READERS; i++){
+  for (size_t i = 0; i < q->max_readers; i++){
     *q->read_valids[i] = false;
     *q->read_uids[i] = 0;
+    *q->read_notify[i] = 0;
   }
 
   q->write_uid_local = uid;
@@ -167,6 +334,29 @@ static void thread_signal(uint32_t tid) {
   #endif
 }
 
+static void futex_notify(uint64_t slot) {
+#ifdef __linux__
+  msgq_notify_slot_t * table = msgq_notify_table();
+  if (table == NULL || slot >= NUM_NOTIFY_SLOTS) return;
+
+  // Only pay for the syscall if the owner announced that it is about to sleep
+  std::atomic<uint32_t> *seq = reinterpret_cast<std::atomic<uint32_t>*>(&table[slot].seq);
+  if (seq->fetch_add(2) & 1){
+    syscall(SYS_futex, seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+  }
+#else
+  UNUSED(slot);
+#endif
+}
+
+static void reader_notify(uint64_t uid, uint64_t notify) {
+  if (notify != 0){
+    futex_notify(notify - 1);
+  } else {
+    thread_signal(uid & 0xFFFFFFFF);
+  }
+}
+
 void msgq_init_subscriber(msgq_queue_t * q) {
   assert(q != NULL);
   assert(q->num_readers != NULL);
@@ -179,18 +369,20 @@ void msgq_init_subscriber(msgq_queue_t * q) {
     uint64_t new_num_readers = cur_num_readers + 1;
 
     // No more slots available. Reset all subscribers to kick out inactive ones
-    if (new_num_readers > NUM_READERS){
+    if (new_num_readers > q->max_readers){
       //std::cout << "Warning, evicting all subscribers!" << std::endl;
       *q->num_readers = 0;
 
-      for (size_t i = 0; i < NUM_READERS; i++){
+      for (size_t i = 0; i < q->max_readers; i++){
         *q->read_valids[i] = false;
 
         uint64_t old_uid = *q->read_uids[i];
+        uint64_t old_notify = *q->read_notify[i];
         *q->read_uids[i] = 0;
+        *q->read_notify[i] = 0;
 
         // Wake up reader in case they are in a poll
-        thread_signal(old_uid & 0xFFFFFFFF);
+        reader_notify(old_uid, old_notify);
       }
 
       continue;
@@ -208,6 +400,9 @@ void msgq_init_subscriber(msgq_queue_t * q) {
       // on the first read the read pointer will be synchronized with the write pointer
       *q->read_valids[cur_num_readers] = false;
       *q->read_pointers[cur_num_readers] = 0;
+      *q->read_notify[cur_num_readers] = q->notify_futex ? msgq_notify_slot() + 1 : 0;
+      *q->read_resets[cur_num_readers] = 0;
+      *q->read_max_lag[cur_num_readers] = 0;
       *q->read_uids[cur_num_readers] = uid;
       break;
     }
@@ -217,24 +412,17 @@ void msgq_init_subscriber(msgq_queue_t * q) {
   msgq_reset_reader(q);
 }
 
-int msgq_msg_send(msgq_msg_t * msg, msgq_queue_t *q){
-  // Die if we are no longer the active publisher
-  if (q->write_uid_local != *q->write_uid){
-    std::cout << "Killing old publisher: " << q->endpoint << std::endl;
-    errno = EADDRINUSE;
-    return -1;
-  }
-
+// Write a single message at the local write pointer without publishing it.
+// Only a wraparound updates the global write pointer.
+static void msgq_msg_write(msgq_msg_t * msg, msgq_queue_t *q, uint64_t num_readers, uint32_t *write_cycles_p, uint32_t *write_pointer_p){
   uint64_t total_msg_size = ALIGN(msg->size + sizeof(int64_t));
 
   // We need to fit at least three messages in the queue,
   // then we can always safely access the last message
   assert(3 * total_msg_size <= q->size);
 
-  uint64_t num_readers = *q->num_readers;
-
-  uint32_t write_cycles, write_pointer;
-  UNPACK64(write_cycles, write_pointer, *q->write_pointer);
+  uint32_t write_cycles = *write_cycles_p;
+  uint32_t write_pointer = *write_pointer_p;
 
   char *p = q->data + write_pointer; // add base offset
 
@@ -286,19 +474,69 @@ int msgq_msg_send(msgq_msg_t * msg, msgq_queue_t *q){
 
   // Copy data
   memcpy(p + sizeof(int64_t), msg->data, msg->size);
+
+  *write_cycles_p = write_cycles;
+  *write_pointer_p = ALIGN(write_pointer + msg->size + sizeof(int64_t));
+}
+
+int msgq_msg_send_many(msgq_msg_t * msgs, size_t nmsgs, msgq_queue_t *q){
+  // Die if we are no longer the active publisher
+  if (q->write_uid_local != *q->write_uid){
+    std::cout << "Killing old publisher: " << q->endpoint << std::endl;
+    errno = EADDRINUSE;
+    return -1;
+  }
+
+  if (nmsgs == 0){
+    return 0;
+  }
+
+  uint64_t num_readers = std::min<uint64_t>(*q->num_readers, q->max_readers);
+
+  uint32_t write_cycles, write_pointer;
+  UNPACK64(write_cycles, write_pointer, *q->write_pointer);
+
+  // The messages are published in parts that fit in a third of the queue, like the largest single
+  // message. A part is only visible once the write pointer is updated, one that wrapped around onto
+  // itself would overwrite its first messages, and the readers reset to the write pointer, before
+  // they were published.
+  size_t part_size = 0;
+  for (size_t i = 0; i < nmsgs; i++){
+    size_t msg_size = ALIGN(msgs[i].size + sizeof(int64_t));
+    if (part_size > 0 && 3 * (part_size + msg_size) > q->size){
+      __sync_synchronize();
+      PACK64(*q->write_pointer, write_cycles, write_pointer);
+      part_size = 0;
+    }
+    msgq_msg_write(&msgs[i], q, num_readers, &write_cycles, &write_pointer);
+    part_size += msg_size;
+  }
   __sync_synchronize();
 
-  // Update write pointer
-  uint32_t new_ptr = ALIGN(write_pointer + msg->size + sizeof(int64_t));
-  PACK64(*q->write_pointer, write_cycles, new_ptr);
+  // Update write pointer, publishing the (last part of the) messages at once
+  PACK64(*q->write_pointer, write_cycles, write_pointer);
+
+  if (q->stats){
+    size_t bytes = 0;
+    for (size_t i = 0; i < nmsgs; i++){
+      bytes += msgs[i].size;
+    }
+    // Single writer, no need for an atomic increment
+    *q->num_sent = *q->num_sent + nmsgs;
+    *q->bytes_sent = *q->bytes_sent + bytes;
+  }
 
   // Notify readers
   for (uint64_t i = 0; i < num_readers; i++){
-    uint64_t reader_uid = *q->read_uids[i];
-    thread_signal(reader_uid & 0xFFFFFFFF);
+    reader_notify(*q->read_uids[i], *q->read_notify[i]);
   }
 
-  return msg->size;
+  return nmsgs;
+}
+
+int msgq_msg_send(msgq_msg_t * msg, msgq_queue_t *q){
+  int r = msgq_msg_send_many(msg, 1, q);
+  return (r < 0) ? r : msg->size;
 }
 
 
@@ -315,7 +553,7 @@ int msgq_msg_ready(msgq_queue_t * q){
 
   // Check valid
   if (!*q->read_valids[id]){
-    msgq_reset_reader(q);
+    msgq_drop_reader(q);
     goto start;
   }
 
@@ -331,7 +569,7 @@ int msgq_msg_ready(msgq_queue_t * q){
   return (read_pointer != write_pointer);
 }
 
-int msgq_msg_recv(msgq_msg_t * msg, msgq_queue_t * q){
+int msgq_msg_recv_borrow(msgq_msg_t * msg, msgq_queue_t * q){
  start:
   int id = q->reader_id;
   assert(id >= 0); // Make sure subscriber is initialized
@@ -344,7 +582,7 @@ int msgq_msg_recv(msgq_msg_t * msg, msgq_queue_t * q){
 
   // Check valid
   if (!*q->read_valids[id]){
-    msgq_reset_reader(q);
+    msgq_drop_reader(q);
     goto start;
   }
 
@@ -369,7 +607,7 @@ int msgq_msg_recv(msgq_msg_t * msg, msgq_queue_t * q){
 
   // Check if the size that was read is valid
   if (!*q->read_valids[id]){
-    msgq_reset_reader(q);
+    msgq_drop_reader(q);
     goto start;
   }
 
@@ -396,37 +634,136 @@ int msgq_msg_recv(msgq_msg_t * msg, msgq_queue_t * q){
     }
   }
 
-  // Copy message
-  if (msgq_msg_init_size(msg, size) < 0)
-    return -1;
+  if (q->stats){
+    uint64_t lag = msgq_lag(*q->read_pointers[id], *q->write_pointer, q->size);
+    if (lag > *q->read_max_lag[id]){
+      *q->read_max_lag[id] = lag;
+    }
+  }
 
+  // The read pointer stays at the start of the message until it is released,
+  // so the writer keeps invalidating this reader if it overwrites the message
+  PACK64(q->borrow_read_pointer, read_cycles, new_read_pointer);
   __sync_synchronize();
-  memcpy(msg->data, p + sizeof(int64_t), size);
+
+  msg->size = size;
+  msg->data = p + sizeof(int64_t);
+  return msg->size;
+}
+
+bool msgq_msg_borrow_valid(msgq_queue_t * q){
   __sync_synchronize();
+  int id = q->reader_id;
+  return q->read_uid_local == *q->read_uids[id] && *q->read_valids[id];
+}
+
+bool msgq_msg_borrow_release(msgq_queue_t * q){
+  bool valid = msgq_msg_borrow_valid(q);
 
   // Update read pointer
-  PACK64(*q->read_pointers[id], read_cycles, new_read_pointer);
+  *q->read_pointers[q->reader_id] = q->borrow_read_pointer;
+
+  // Check if the data was still intact after it was used
+  if (!valid){
+    msgq_drop_reader(q);
+  }
+  return valid;
+}
+
+int msgq_msg_recv(msgq_msg_t * msg, msgq_queue_t * q){
+ start:
+  msgq_msg_t view;
+  int r = msgq_msg_recv_borrow(&view, q);
+  if (r <= 0){
+    msg->size = 0;
+    return r;
+  }
+
+  // Copy message
+  if (msgq_msg_init_size(msg, view.size) < 0)
+    return -1;
+
+  memcpy(msg->data, view.data, view.size);
 
   // Check if the actual data that was copied is valid
-  if (!*q->read_valids[id]){
+  if (!msgq_msg_borrow_release(q)){
     msgq_msg_close(msg);
-    msgq_reset_reader(q);
     goto start;
   }
 
-
   return msg->size;
 }
 
 
 
+static int msgq_poll_futex(msgq_pollitem_t * items, size_t nitems, int timeout, int slot){
+#ifdef __linux__
+  int num = 0;
+  std::atomic<uint32_t> *seq = reinterpret_cast<std::atomic<uint32_t>*>(&msgq_notify_table()[slot].seq);
+
+  // Make sure publishers wake this thread, the poll might not run on the thread that subscribed
+  for (size_t i = 0; i < nitems; i++) {
+    msgq_queue_t *q = items[i].q;
+    if (*q->read_notify[q->reader_id] != (uint64_t)slot + 1){
+      *q->read_notify[q->reader_id] = slot + 1;
+    }
+  }
+
+  int ms = (timeout == -1) ? 100 : timeout;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+
+  while (true) {
+    // Announce the sleep before checking, any notify after this point changes the futex word
+    uint32_t val = seq->fetch_or(1) | 1;
+
+    for (size_t i = 0; i < nitems; i++) {
+      if (items[i].revents == 0 && msgq_msg_ready(items[i].q)){
+        num += 1;
+        items[i].revents = 1;
+      }
+    }
+    if (num > 0) break;
+
+    auto now = std::chrono::steady_clock::now();
+    if (now >= deadline){
+      if (timeout != -1) break;
+      deadline = now + std::chrono::milliseconds(ms);
+    }
+
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now).count();
+    struct timespec ts;
+    ts.tv_sec = ns / 1000000000;
+    ts.tv_nsec = ns % 1000000000;
+    syscall(SYS_futex, seq, FUTEX_WAIT, val, &ts, NULL, 0);
+  }
+
+  seq->fetch_and(~1u);
+  return num;
+#else
+  UNUSED(items);
+  UNUSED(nitems);
+  UNUSED(timeout);
+  UNUSED(slot);
+  return 0;
+#endif
+}
+
 int msgq_poll(msgq_pollitem_t * items, size_t nitems, int timeout){
   int num = 0;
+  bool futex = nitems > 0;
 
   // Check if messages ready
   for (size_t i = 0; i < nitems; i++) {
     items[i].revents = msgq_msg_ready(items[i].q);
     if (items[i].revents) num++;
+    futex = futex && items[i].q->notify_futex;
+  }
+
+  if (num == 0 && futex){
+    int slot = msgq_notify_slot();
+    if (slot >= 0){
+      return msgq_poll_futex(items, nitems, timeout, slot);
+    }
   }
 
   int ms = (timeout == -1) ? 100 : timeout;
@@ -458,7 +795,7 @@ int msgq_poll(msgq_pollitem_t * items, size_t nitems, int timeout){
 }
 
 bool msgq_all_readers_updated(msgq_queue_t *q) {
-  uint64_t num_readers = *q->num_readers;
+  uint64_t num_readers = std::min<uint64_t>(*q->num_readers, q->max_readers);
   for (uint64_t i = 0; i < num_readers; i++) {
     if (*q->read_valids[i] && *q->write_pointer != *q->read_pointers[i]) {
       return false;
@@ -466,3 +803,51 @@ bool msgq_all_readers_updated(msgq_queue_t *q) {
   }
   return num_readers > 0;
 }
+
+
+int msgq_read_stats(const char * full_path, msgq_stats_t * stats){
+  auto fd = open(full_path, O_RDONLY);
+  if (fd < 0){
+    return -1;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) < 0 || (size_t)st.st_size < msgq_header_size(1)){
+    close(fd);
+    return -1;
+  }
+
+  char * mem = (char*)mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mem == MAP_FAILED){
+    return -1;
+  }
+
+  int r = -1;
+  msgq_header_t *header = (msgq_header_t *)mem;
+  uint64_t max_readers = header->max_readers;
+
+  // Skip files that don't look like a queue
+  if (max_readers > 0 && max_readers <= 1024 && (size_t)st.st_size > msgq_header_size(max_readers)){
+    const uint64_t *readers = reinterpret_cast<const uint64_t*>(mem + sizeof(msgq_header_t));
+    uint64_t num_readers = std::min<uint64_t>(header->num_readers, max_readers);
+
+    stats->size = st.st_size - msgq_header_size(max_readers);
+    stats->num_sent = header->num_sent;
+    stats->bytes_sent = header->bytes_sent;
+    stats->readers.resize(num_readers);
+
+    for (uint64_t i = 0; i < num_readers; i++){
+      msgq_reader_stats_t &reader = stats->readers[i];
+      reader.lag = msgq_lag(readers[i], header->write_pointer, stats->size);
+      reader.valid = readers[max_readers + i];
+      reader.tid = readers[2 * max_readers + i] & 0xFFFFFFFF;
+      reader.resets = readers[4 * max_readers + i];
+      reader.max_lag = readers[5 * max_readers + i];
+    }
+    r = 0;
+  }
+
+  munmap(mem, st.st_size);
+  return r;
+}
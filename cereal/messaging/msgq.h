@@ -3,40 +3,65 @@
 #include <cstdint>
 #include <cstring>
 #include <string>
+#include <vector>
 #include <atomic>
 
 #define DEFAULT_SEGMENT_SIZE (10 * 1024 * 1024)
-#define NUM_READERS 12
+#define DEFAULT_NUM_READERS 12
+#define NUM_NOTIFY_SLOTS 1024
 #define ALIGN(n) ((n + (8 - 1)) & -8)
 
 #define UNUSED(x) (void)x
 #define UNPACK64(higher, lower, input) do {uint64_t tmp = input; higher = tmp >> 32; lower = tmp & 0xFFFFFFFF;} while (0)
 #define PACK64(output, higher, lower) output = ((uint64_t)higher << 32) | ((uint64_t)lower & 0xFFFFFFFF)
 
+#define NUM_READER_FIELDS 6
+
+// Followed by the per reader arrays, each max_readers long:
+// read_pointers, read_valids, read_uids, read_notify (futex slot + 1 of the reader, 0 if it wants SIGUSR2),
+// read_resets and read_max_lag
 struct  msgq_header_t {
   uint64_t num_readers;
   uint64_t write_pointer;
   uint64_t write_uid;
-  uint64_t read_pointers[NUM_READERS];
-  uint64_t read_valids[NUM_READERS];
-  uint64_t read_uids[NUM_READERS];
+  uint64_t max_readers;
+
+  // Only maintained when MSGQ_STATS is set
+  uint64_t num_sent;
+  uint64_t bytes_sent;
+};
+
+// Futex word shared by every queue a reader thread polls, lives in /dev/shm/msgq_notify
+struct msgq_notify_slot_t {
+  uint32_t seq; // bumped by 2 on every notify, bit 0 is set while the owner sleeps
+  uint32_t tid;
 };
 
 struct msgq_queue_t {
   std::atomic<uint64_t> *num_readers;
   std::atomic<uint64_t> *write_pointer;
   std::atomic<uint64_t> *write_uid;
-  std::atomic<uint64_t> *read_pointers[NUM_READERS];
-  std::atomic<uint64_t> *read_valids[NUM_READERS];
-  std::atomic<uint64_t> *read_uids[NUM_READERS];
+  std::atomic<uint64_t> *num_sent;
+  std::atomic<uint64_t> *bytes_sent;
+  std::vector<std::atomic<uint64_t> *> read_pointers;
+  std::vector<std::atomic<uint64_t> *> read_valids;
+  std::vector<std::atomic<uint64_t> *> read_uids;
+  std::vector<std::atomic<uint64_t> *> read_notify;
+  std::vector<std::atomic<uint64_t> *> read_resets;
+  std::vector<std::atomic<uint64_t> *> read_max_lag;
   char * mmap_p;
+  int fd; // open while the queue is mapped, holds a shared flock on it
   char * data;
   size_t size;
+  size_t max_readers;
   int reader_id;
   uint64_t read_uid_local;
   uint64_t write_uid_local;
+  uint64_t borrow_read_pointer;
 
   bool read_conflate;
+  bool notify_futex;
+  bool stats;
   std::string endpoint;
 };
 
@@ -50,6 +75,21 @@ struct msgq_pollitem_t {
   int revents;
 };
 
+struct msgq_reader_stats_t {
+  uint32_t tid;
+  bool valid;
+  uint64_t lag;     // bytes between read and write pointer
+  uint64_t resets;  // times the reader fell behind and skipped to the write pointer
+  uint64_t max_lag;
+};
+
+struct msgq_stats_t {
+  size_t size;
+  uint64_t num_sent;
+  uint64_t bytes_sent;
+  std::vector<msgq_reader_stats_t> readers;
+};
+
 void msgq_wait_for_subscriber(msgq_queue_t *q);
 void msgq_reset_reader(msgq_queue_t *q);
 
@@ -57,14 +97,27 @@ int msgq_msg_init_size(msgq_msg_t *msg, size_t size);
 int msgq_msg_init_data(msgq_msg_t *msg, char * data, size_t size);
 int msgq_msg_close(msgq_msg_t *msg);
 
-int msgq_new_queue(msgq_queue_t * q, const char * path, size_t size);
+size_t msgq_header_size(size_t max_readers);
+int msgq_new_queue(msgq_queue_t * q, const char * path, size_t size, size_t max_readers = DEFAULT_NUM_READERS);
 void msgq_close_queue(msgq_queue_t *q);
 void msgq_init_publisher(msgq_queue_t * q);
 void msgq_init_subscriber(msgq_queue_t * q);
 
 int msgq_msg_send(msgq_msg_t *msg, msgq_queue_t *q);
+// Send a batch of messages with a single write pointer update and reader notification
+int msgq_msg_send_many(msgq_msg_t *msgs, size_t nmsgs, msgq_queue_t *q);
 int msgq_msg_recv(msgq_msg_t *msg, msgq_queue_t *q);
+
+// Zero copy receive, msg->data points into the shared ring buffer and must not be closed.
+// The data can be overwritten by the writer at any time, check msgq_msg_borrow_valid after using it.
+// The message has to be released before the next receive.
+int msgq_msg_recv_borrow(msgq_msg_t *msg, msgq_queue_t *q);
+bool msgq_msg_borrow_valid(msgq_queue_t *q);
+bool msgq_msg_borrow_release(msgq_queue_t *q);
 int msgq_msg_ready(msgq_queue_t * q);
 int msgq_poll(msgq_pollitem_t * items, size_t nitems, int timeout);
 
 bool msgq_all_readers_updated(msgq_queue_t *q);
+
+// Read the counters of the queue at full_path without joining it
+int msgq_read_stats(const char * full_path, msgq_stats_t * stats);
@@ -0,0 +1,64 @@
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <thread>
+
+#include "cereal/messaging/msgq.h"
+
+// Dumps the msgq counters of all endpoints, publishers and subscribers need to run with MSGQ_STATS=1
+int main(int argc, char *argv[]) {
+  std::string shm_path = "/dev/shm/";
+  const char* prefix = std::getenv("OPENPILOT_PREFIX");
+  if (prefix) {
+    shm_path += std::string(prefix) + "/";
+  }
+
+  const char *filter = argc > 1 ? argv[1] : nullptr;
+  std::map<std::string, msgq_stats_t> prev;
+  auto prev_time = std::chrono::steady_clock::now();
+
+  while (true) {
+    std::map<std::string, msgq_stats_t> cur;
+    for (auto &entry : std::filesystem::directory_iterator(shm_path)) {
+      std::string name = entry.path().filename();
+      if (!entry.is_regular_file() || name == "msgq_notify") continue;
+      if (filter && name.find(filter) == std::string::npos) continue;
+
+      msgq_stats_t stats;
+      if (msgq_read_stats(entry.path().c_str(), &stats) == 0) {
+        cur[name] = stats;
+      }
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    double dt = std::chrono::duration<double>(now - prev_time).count();
+    prev_time = now;
+
+    printf("\033[2J\033[H");
+    printf("%-32s %8s %9s %10s  %s\n", "endpoint", "size kB", "msgs/s", "kB/s", "readers (tid lag/max lag kB, resets)");
+    for (auto &[name, stats] : cur) {
+      double msgs = 0, bytes = 0;
+      auto it = prev.find(name);
+      if (it != prev.end() && stats.num_sent >= it->second.num_sent) {
+        msgs = (stats.num_sent - it->second.num_sent) / dt;
+        bytes = (stats.bytes_sent - it->second.bytes_sent) / dt;
+      }
+
+      printf("%-32s %8zu %9.1f %10.1f ", name.c_str(), stats.size / 1024, msgs, bytes / 1024);
+      for (auto &reader : stats.readers) {
+        printf(" %u %.1f/%.1f%s %lu", reader.tid, reader.lag / 1024., reader.max_lag / 1024.,
+               reader.valid ? "" : "!", (unsigned long)reader.resets);
+      }
+      printf("\n");
+    }
+    fflush(stdout);
+
+    prev = std::move(cur);
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+  }
+
+  return 0;
+}
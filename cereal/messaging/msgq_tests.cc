@@ -1,6 +1,18 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+
 #include "catch2/catch.hpp"
 #include "cereal/messaging/msgq.h"
 
+static uint64_t msgq_test_nanos(){
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 TEST_CASE("ALIGN"){
   REQUIRE(ALIGN(0) == 0);
   REQUIRE(ALIGN(1) == 8);
@@ -219,6 +231,81 @@ TEST_CASE("msgq_init_subscriber init 2 subscribers"){
 }
 
 
+TEST_CASE("msgq_init_subscriber more than default readers"){
+  remove("/dev/shm/test_queue");
+  const size_t max_readers = 2 * DEFAULT_NUM_READERS;
+  std::vector<msgq_queue_t> readers(max_readers + 1);
+
+  for (size_t i = 0; i < max_readers; i++){
+    msgq_new_queue(&readers[i], "test_queue", 1024, max_readers);
+    msgq_init_subscriber(&readers[i]);
+    REQUIRE(readers[i].reader_id == (int)i);
+  }
+  REQUIRE(*readers[0].num_readers == max_readers);
+  REQUIRE(readers[0].data == readers[0].mmap_p + msgq_header_size(max_readers));
+
+  // No reader was evicted
+  for (size_t i = 0; i < max_readers; i++){
+    REQUIRE(readers[i].read_uid_local == *readers[0].read_uids[i]);
+  }
+
+  // One more evicts everyone
+  msgq_new_queue(&readers[max_readers], "test_queue", 1024, max_readers);
+  msgq_init_subscriber(&readers[max_readers]);
+  REQUIRE(readers[max_readers].reader_id == 0);
+  REQUIRE(*readers[0].num_readers == 1);
+
+  for (auto &q : readers){
+    msgq_close_queue(&q);
+  }
+}
+
+TEST_CASE("msgq_new_queue existing queue with a different layout"){
+  remove("/dev/shm/test_queue");
+  msgq_queue_t q, other;
+  REQUIRE(msgq_new_queue(&q, "test_queue", 1024, 4) == 0);
+  const size_t file_size = 1024 + msgq_header_size(4);
+
+  REQUIRE(msgq_new_queue(&other, "test_queue", 2048, 4) == -1);
+  REQUIRE(msgq_new_queue(&other, "test_queue", 1024, 8) == -1);
+
+  // The same size from a different reader count
+  const size_t size = 1024 + msgq_header_size(4) - msgq_header_size(2);
+  REQUIRE(msgq_new_queue(&other, "test_queue", size, 2) == -1);
+
+  // The queue is untouched
+  struct stat st;
+  REQUIRE(stat("/dev/shm/test_queue", &st) == 0);
+  REQUIRE((size_t)st.st_size == file_size);
+  REQUIRE(((msgq_header_t *)q.mmap_p)->max_readers == 4);
+
+  REQUIRE(msgq_new_queue(&other, "test_queue", 1024, 4) == 0);
+  msgq_close_queue(&other);
+  msgq_close_queue(&q);
+}
+
+TEST_CASE("msgq_new_queue recreates a stale queue with a different layout"){
+  remove("/dev/shm/test_queue");
+  msgq_queue_t q;
+  REQUIRE(msgq_new_queue(&q, "test_queue", 1024, 4) == 0);
+  msgq_init_publisher(&q);
+  msgq_close_queue(&q);
+
+  // nobody is attached, the queue is recreated with the new layout
+  REQUIRE(msgq_new_queue(&q, "test_queue", 2048, 4) == 0);
+  struct stat st;
+  REQUIRE(stat("/dev/shm/test_queue", &st) == 0);
+  REQUIRE((size_t)st.st_size == 2048 + msgq_header_size(4));
+  msgq_init_publisher(&q);
+  msgq_close_queue(&q);
+
+  // the same size from a different reader count, the header is cleared
+  REQUIRE(msgq_new_queue(&q, "test_queue", 2048 + msgq_header_size(4) - msgq_header_size(8), 8) == 0);
+  REQUIRE(((msgq_header_t *)q.mmap_p)->max_readers == 8);
+  REQUIRE(*q.write_uid == 0);
+  msgq_close_queue(&q);
+}
+
 TEST_CASE("Write 1 msg, read 1 msg", "[integration]"){
   remove("/dev/shm/test_queue");
   const size_t msg_size = 128;
@@ -392,3 +479,267 @@ TEST_CASE("1 publisher, 2 subscribers", "[integration]"){
     msgq_msg_close(&msg2);
   }
 }
+
+TEST_CASE("Write 3 msg batch, read 3 msg", "[integration]"){
+  remove("/dev/shm/test_queue");
+  const size_t msg_size = 120;
+  msgq_queue_t writer, reader;
+
+  msgq_new_queue(&writer, "test_queue", 1024);
+  msgq_new_queue(&reader, "test_queue", 1024);
+
+  msgq_init_publisher(&writer);
+  msgq_init_subscriber(&reader);
+
+  SECTION("Without wraparound"){
+  }
+  SECTION("With wraparound"){
+    msgq_msg_t msg;
+    msgq_msg_init_size(&msg, msg_size);
+    for (int i = 0; i < 5; i++) {
+      msgq_msg_send(&msg, &writer);
+      msgq_msg_t incoming_msg;
+      msgq_msg_recv(&incoming_msg, &reader);
+      msgq_msg_close(&incoming_msg);
+    }
+    msgq_msg_close(&msg);
+  }
+
+  msgq_msg_t outgoing_msgs[3];
+  for (int i = 0; i < 3; i++){
+    msgq_msg_init_size(&outgoing_msgs[i], msg_size);
+    memset(outgoing_msgs[i].data, i, msg_size);
+  }
+
+  uint32_t write_cycles = *writer.write_pointer >> 32;
+  REQUIRE(msgq_msg_send_many(outgoing_msgs, 3, &writer) == 3);
+
+  for (int i = 0; i < 3; i++){
+    msgq_msg_t incoming_msg;
+    REQUIRE(msgq_msg_recv(&incoming_msg, &reader) == msg_size);
+    REQUIRE(memcmp(incoming_msg.data, outgoing_msgs[i].data, msg_size) == 0);
+    msgq_msg_close(&incoming_msg);
+  }
+
+  // Verify that there are no more messages
+  msgq_msg_t incoming_msg;
+  REQUIRE(msgq_msg_recv(&incoming_msg, &reader) == 0);
+  REQUIRE((*reader.read_pointers[0] >> 32) >= write_cycles);
+
+  for (int i = 0; i < 3; i++){
+    msgq_msg_close(&outgoing_msgs[i]);
+  }
+}
+
+TEST_CASE("Write batch larger than the queue", "[integration]"){
+  remove("/dev/shm/test_queue");
+  const size_t msg_size = 120;
+  const int num_msgs = 20;
+  msgq_queue_t writer, reader;
+
+  msgq_new_queue(&writer, "test_queue", 1024);
+  msgq_new_queue(&reader, "test_queue", 1024);
+
+  msgq_init_publisher(&writer);
+  msgq_init_subscriber(&reader);
+
+  msgq_msg_t outgoing_msgs[num_msgs];
+  for (int i = 0; i < num_msgs; i++){
+    msgq_msg_init_size(&outgoing_msgs[i], msg_size);
+    memset(outgoing_msgs[i].data, i, msg_size);
+  }
+  REQUIRE(msgq_msg_send_many(outgoing_msgs, num_msgs, &writer) == num_msgs);
+
+  // The reader is overtaken and skips to the newest message, nothing it reads is corrupt
+  int last = -1;
+  msgq_msg_t incoming_msg;
+  while (msgq_msg_recv(&incoming_msg, &reader) > 0){
+    REQUIRE(incoming_msg.size == msg_size);
+    int idx = incoming_msg.data[0];
+    REQUIRE(idx > last);
+    REQUIRE(memcmp(incoming_msg.data, outgoing_msgs[idx].data, msg_size) == 0);
+    last = idx;
+    msgq_msg_close(&incoming_msg);
+  }
+
+  REQUIRE(msgq_msg_send_many(outgoing_msgs, 1, &writer) == 1);
+  REQUIRE(msgq_msg_recv(&incoming_msg, &reader) == msg_size);
+  REQUIRE(memcmp(incoming_msg.data, outgoing_msgs[0].data, msg_size) == 0);
+  msgq_msg_close(&incoming_msg);
+  REQUIRE(msgq_msg_recv(&incoming_msg, &reader) == 0);
+
+  for (int i = 0; i < num_msgs; i++){
+    msgq_msg_close(&outgoing_msgs[i]);
+  }
+}
+
+TEST_CASE("Write 1 msg, borrow 1 msg", "[integration]"){
+  remove("/dev/shm/test_queue");
+  const size_t msg_size = 120;
+  msgq_queue_t writer, reader;
+
+  msgq_new_queue(&writer, "test_queue", 1024);
+  msgq_new_queue(&reader, "test_queue", 1024);
+
+  msgq_init_publisher(&writer);
+  msgq_init_subscriber(&reader);
+
+  msgq_msg_t outgoing_msg;
+  msgq_msg_init_size(&outgoing_msg, msg_size);
+  for (size_t i = 0; i < msg_size; i++){
+    outgoing_msg.data[i] = i;
+  }
+  REQUIRE(msgq_msg_send(&outgoing_msg, &writer) == msg_size);
+
+  msgq_msg_t view;
+  REQUIRE(msgq_msg_recv_borrow(&view, &reader) == msg_size);
+  REQUIRE(view.data == reader.data + sizeof(int64_t)); // Points into the ring buffer
+  REQUIRE(((uintptr_t)view.data % sizeof(uint64_t)) == 0);
+  REQUIRE(memcmp(view.data, outgoing_msg.data, msg_size) == 0);
+
+  SECTION("Intact message"){
+    REQUIRE(msgq_msg_borrow_valid(&reader));
+    REQUIRE(msgq_msg_borrow_release(&reader));
+
+    // Verify that there are no more messages
+    REQUIRE(msgq_msg_recv_borrow(&view, &reader) == 0);
+  }
+  SECTION("Overwritten while borrowed"){
+    for (int i = 0; i < 8; i++) {
+      msgq_msg_send(&outgoing_msg, &writer);
+    }
+    REQUIRE(!msgq_msg_borrow_valid(&reader));
+    REQUIRE(!msgq_msg_borrow_release(&reader));
+    REQUIRE(*reader.read_pointers[0] == *writer.write_pointer);
+  }
+
+  msgq_msg_close(&outgoing_msg);
+}
+
+TEST_CASE("msgq stats", "[integration]"){
+  remove("/dev/shm/test_queue");
+  const size_t msg_size = 120;
+  msgq_queue_t writer, reader;
+
+  msgq_new_queue(&writer, "test_queue", 1024);
+  msgq_new_queue(&reader, "test_queue", 1024);
+  writer.stats = reader.stats = true;
+
+  msgq_init_publisher(&writer);
+  msgq_init_subscriber(&reader);
+
+  msgq_msg_t msg;
+  msgq_msg_init_size(&msg, msg_size);
+  for (int i = 0; i < 3; i++) {
+    msgq_msg_send(&msg, &writer);
+  }
+
+  msgq_msg_t incoming_msg;
+  REQUIRE(msgq_msg_recv(&incoming_msg, &reader) == msg_size);
+  msgq_msg_close(&incoming_msg);
+  REQUIRE(*reader.read_max_lag[0] == 3 * (msg_size + sizeof(int64_t)));
+
+  // Overrun the reader
+  for (int i = 0; i < 8; i++) {
+    msgq_msg_send(&msg, &writer);
+  }
+  REQUIRE(msgq_msg_recv(&incoming_msg, &reader) == 0);
+
+  msgq_stats_t stats;
+  REQUIRE(msgq_read_stats("/dev/shm/test_queue", &stats) == 0);
+  REQUIRE(stats.size == 1024);
+  REQUIRE(stats.num_sent == 11);
+  REQUIRE(stats.bytes_sent == 11 * msg_size);
+  REQUIRE(stats.readers.size() == 1);
+  REQUIRE(stats.readers[0].valid);
+  REQUIRE(stats.readers[0].lag == 0);
+  REQUIRE(stats.readers[0].resets == 1);
+  REQUIRE(stats.readers[0].max_lag == 3 * (msg_size + sizeof(int64_t)));
+
+  msgq_msg_close(&msg);
+}
+
+TEST_CASE("msgq_poll futex wakeup", "[integration]"){
+  remove("/dev/shm/test_queue");
+  msgq_queue_t writer, reader;
+
+  msgq_new_queue(&writer, "test_queue", 1024);
+  msgq_new_queue(&reader, "test_queue", 1024);
+  reader.notify_futex = true;
+
+  msgq_init_publisher(&writer);
+  msgq_init_subscriber(&reader);
+  REQUIRE(*reader.read_notify[0] != 0);
+
+  std::thread t([&](){
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    msgq_msg_t msg;
+    msgq_msg_init_size(&msg, 8);
+    msgq_msg_send(&msg, &writer);
+    msgq_msg_close(&msg);
+  });
+
+  msgq_pollitem_t item = {.q = &reader};
+  uint64_t start = msgq_test_nanos();
+  REQUIRE(msgq_poll(&item, 1, 1000) == 1);
+  REQUIRE(msgq_test_nanos() - start < 500 * 1e6);
+  REQUIRE(item.revents == 1);
+  t.join();
+}
+
+static std::vector<uint64_t> msgq_notify_latency(bool futex, int n){
+  remove("/dev/shm/test_queue");
+  msgq_queue_t writer;
+  msgq_new_queue(&writer, "test_queue", 1024 * 1024);
+  msgq_init_publisher(&writer);
+
+  std::vector<uint64_t> latencies;
+  std::atomic<bool> ready = false;
+
+  std::thread t([&](){
+    msgq_queue_t reader;
+    msgq_new_queue(&reader, "test_queue", 1024 * 1024);
+    reader.notify_futex = futex;
+    msgq_init_subscriber(&reader);
+    ready = true;
+
+    msgq_pollitem_t item = {.q = &reader};
+    while (latencies.size() < (size_t)n){
+      if (msgq_poll(&item, 1, 100) == 0) continue;
+
+      msgq_msg_t msg;
+      if (msgq_msg_recv(&msg, &reader) > 0){
+        latencies.push_back(msgq_test_nanos() - *(uint64_t*)msg.data);
+        msgq_msg_close(&msg);
+      }
+    }
+    msgq_close_queue(&reader);
+  });
+
+  while (!ready) {}
+  for (int i = 0; i < n; i++){
+    // Give the reader time to go to sleep, so every message measures a wakeup
+    std::this_thread::sleep_for(std::chrono::microseconds(500));
+    uint64_t now = msgq_test_nanos();
+    msgq_msg_t msg;
+    msgq_msg_init_data(&msg, (char*)&now, sizeof(now));
+    msgq_msg_send(&msg, &writer);
+    msgq_msg_close(&msg);
+  }
+
+  t.join();
+  msgq_close_queue(&writer);
+  std::sort(latencies.begin(), latencies.end());
+  return latencies;
+}
+
+TEST_CASE("msgq notify latency benchmark", "[.][benchmark]"){
+  const int n = 2000;
+  for (bool futex : {false, true}){
+    auto latencies = msgq_notify_latency(futex, n);
+    REQUIRE(latencies.size() == (size_t)n);
+
+    printf("%-7s median %6.1f us, p99 %6.1f us, max %7.1f us\n", futex ? "futex" : "signal",
+           latencies[n / 2] / 1e3, latencies[n * 99 / 100] / 1e3, latencies.back() / 1e3);
+  }
+}
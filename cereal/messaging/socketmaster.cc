@@ -1,6 +1,8 @@
 #include <time.h>
 #include <assert.h>
 #include <stdlib.h>
+#include <algorithm>
+#include <stdexcept>
 #include <string>
 #include <mutex>
 
@@ -46,7 +48,9 @@ struct SubMaster::SubMessage {
   void *allocated_msg_reader = nullptr;
   bool is_polled = false;
   capnp::FlatArrayMessageReader *msg_reader = nullptr;
-  AlignedBuffer aligned_buf;
+  // the current event stays readable while the next message is copied into the other buffer
+  AlignedBuffer aligned_buf[2];
+  int buf_idx = 0;
   cereal::Event::Reader event;
 };
 
@@ -69,42 +73,46 @@ SubMaster::SubMaster(const std::vector<const char *> &service_list, const std::v
       .allocated_msg_reader = malloc(sizeof(capnp::FlatArrayMessageReader)),
       .is_polled = is_polled};
     m->msg_reader = new (m->allocated_msg_reader) capnp::FlatArrayMessageReader({});
-    messages_[socket] = m;
+    messages_.push_back(m);
     services_[name] = m;
   }
+  polled_.reserve(messages_.size());
 }
 
 void SubMaster::update(int timeout) {
-  for (auto &kv : messages_) kv.second->updated = false;
+  for (auto m : messages_) m->updated = false;
 
-  auto sockets = poller_->poll(timeout);
-
-  // add non-polled sockets for non-blocking receive
-  for (auto &kv : messages_) {
-    SubMessage *m = kv.second;
-    SubSocket *s = kv.first;
-    if (!m->is_polled) sockets.push_back(s);
-  }
+  poller_->pollInto(timeout, polled_);
 
   uint64_t current_time = nanos_since_boot();
+  if (++frame == UINT64_MAX) frame = 1;
 
-  std::vector<std::pair<std::string, cereal::Event::Reader>> messages;
+  for (auto m : messages_) {
+    // non-polled sockets get a non-blocking receive every update
+    if (m->is_polled && std::find(polled_.begin(), polled_.end(), m->socket) == polled_.end()) continue;
 
-  for (auto s : sockets) {
-    Message *msg = s->receive(true);
-    if (msg == nullptr) continue;
+    SubSocket *s = m->socket;
+    const char *data = nullptr;
+    size_t size = s->receiveBorrow(&data, true);
+    if (size == 0) {
+      s->releaseBorrow();
+      continue;
+    }
 
-    SubMessage *m = messages_.at(s);
+    // copy straight out of the socket, and drop the message if it was overwritten while copying
+    int idx = m->buf_idx ^ 1;
+    auto words = m->aligned_buf[idx].align(data, size);
+    if (!s->releaseBorrow()) continue;
+    m->buf_idx = idx;
 
     m->msg_reader->~FlatArrayMessageReader();
     capnp::ReaderOptions options;
     options.traversalLimitInWords = kj::maxValue; // Don't limit
-    m->msg_reader = new (m->allocated_msg_reader) capnp::FlatArrayMessageReader(m->aligned_buf.align(msg), options);
-    delete msg;
-    messages.push_back({m->name, m->msg_reader->getRoot<cereal::Event>()});
+    m->msg_reader = new (m->allocated_msg_reader) capnp::FlatArrayMessageReader(words, options);
+    mark_updated(m, current_time, m->msg_reader->getRoot<cereal::Event>());
   }
 
-  update_msgs(current_time, messages);
+  update_alive(current_time);
 }
 
 void SubMaster::update_msgs(uint64_t current_time, const std::vector<std::pair<std::string, cereal::Event::Reader>> &messages){
@@ -115,18 +123,24 @@ void SubMaster::update_msgs(uint64_t current_time, const std::vector<std::pair<s
     if (m_find == services_.end()){
       continue;
     }
-    SubMessage *m = m_find->second;
-    m->event = kv.second;
-    m->updated = true;
-    m->rcv_time = current_time;
-    m->rcv_frame = frame;
-    m->valid = m->event.getValid();
-    if (SIMULATION) m->alive = true;
+    mark_updated(m_find->second, current_time, kv.second);
   }
 
+  update_alive(current_time);
+}
+
+void SubMaster::mark_updated(SubMessage *m, uint64_t current_time, cereal::Event::Reader event) {
+  m->event = event;
+  m->updated = true;
+  m->rcv_time = current_time;
+  m->rcv_frame = frame;
+  m->valid = m->event.getValid();
+  if (SIMULATION) m->alive = true;
+}
+
+void SubMaster::update_alive(uint64_t current_time) {
   if (!SIMULATION) {
-    for (auto &kv : messages_) {
-      SubMessage *m = kv.second;
+    for (auto m : messages_) {
       m->alive = (m->freq <= (1e-5) || ((current_time - m->rcv_time) * (1e-9)) < (10.0 / m->freq));
     }
   }
@@ -134,8 +148,7 @@ void SubMaster::update_msgs(uint64_t current_time, const std::vector<std::pair<s
 
 bool SubMaster::all_(const std::vector<const char *> &service_list, bool valid, bool alive) {
   int found = 0;
-  for (auto &kv : messages_) {
-    SubMessage *m = kv.second;
+  for (auto m : messages_) {
     if (service_list.size() == 0 || inList(service_list, m->name.c_str())) {
       found += (!valid || m->valid) && (!alive || (m->alive || m->ignore_alive));
     }
@@ -156,34 +169,70 @@ void SubMaster::drain() {
   }
 }
 
+SubMaster::SubMessage *SubMaster::get(const char *name) const {
+  // transparent lookup, no std::string is constructed
+  auto it = services_.find(name);
+  if (it == services_.end()) {
+    throw std::out_of_range(std::string("SubMaster: unknown service ") + name);
+  }
+  return it->second;
+}
+
 bool SubMaster::updated(const char *name) const {
-  return services_.at(name)->updated;
+  return get(name)->updated;
 }
 
 bool SubMaster::alive(const char *name) const {
-  return services_.at(name)->alive;
+  return get(name)->alive;
 }
 
 bool SubMaster::valid(const char *name) const {
-  return services_.at(name)->valid;
+  return get(name)->valid;
 }
 
 uint64_t SubMaster::rcv_frame(const char *name) const {
-  return services_.at(name)->rcv_frame;
+  return get(name)->rcv_frame;
 }
 
 uint64_t SubMaster::rcv_time(const char *name) const {
-  return services_.at(name)->rcv_time;
+  return get(name)->rcv_time;
 }
 
 cereal::Event::Reader &SubMaster::operator[](const char *name) const {
-  return services_.at(name)->event;
+  return get(name)->event;
+}
+
+size_t SubMaster::index(const char *name) const {
+  return std::find(messages_.begin(), messages_.end(), get(name)) - messages_.begin();
+}
+
+bool SubMaster::updated(size_t idx) const {
+  return messages_[idx]->updated;
+}
+
+bool SubMaster::alive(size_t idx) const {
+  return messages_[idx]->alive;
+}
+
+bool SubMaster::valid(size_t idx) const {
+  return messages_[idx]->valid;
+}
+
+uint64_t SubMaster::rcv_frame(size_t idx) const {
+  return messages_[idx]->rcv_frame;
+}
+
+uint64_t SubMaster::rcv_time(size_t idx) const {
+  return messages_[idx]->rcv_time;
+}
+
+cereal::Event::Reader &SubMaster::operator[](size_t idx) const {
+  return messages_[idx]->event;
 }
 
 SubMaster::~SubMaster() {
   delete poller_;
-  for (auto &kv : messages_) {
-    SubMessage *m = kv.second;
+  for (auto m : messages_) {
     m->msg_reader->~FlatArrayMessageReader();
     free(m->allocated_msg_reader);
     delete m->socket;
@@ -205,6 +254,20 @@ int PubMaster::send(const char *name, MessageBuilder &msg) {
   return send(name, bytes.begin(), bytes.size());
 }
 
+int PubMaster::sendBatch(const char *name, const std::vector<MessageBuilder *> &msgs) {
+  // the storage is kept between calls, it only grows with the largest batch
+  batch_data_.clear();
+  batch_sizes_.clear();
+
+  // each builder keeps its serialized bytes alive until the next toBytes()
+  for (auto msg : msgs) {
+    auto bytes = msg->toBytes();
+    batch_data_.push_back((char *)bytes.begin());
+    batch_sizes_.push_back(bytes.size());
+  }
+  return sockets_.at(name)->sendMany(batch_data_.data(), batch_sizes_.data(), msgs.size());
+}
+
 PubMaster::~PubMaster() {
   for (auto s : sockets_) delete s.second;
 }
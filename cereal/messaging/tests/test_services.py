@@ -17,6 +17,8 @@ class TestServices(unittest.TestCase):
     self.assertTrue(service.port != RESERVED_PORT)
     self.assertTrue(service.port >= STARTING_PORT)
     self.assertTrue(service.frequency <= 104)
+    self.assertTrue(4096 <= service.segment_size < 2**32)
+    self.assertTrue(service.num_readers >= 1)
 
   def test_no_duplicate_port(self):
     ports: Dict[int, str] = {}
@@ -4,6 +4,10 @@ from typing import Optional
 RESERVED_PORT = 8022  # sshd
 STARTING_PORT = 8001
 
+# msgq shared memory defaults, see cereal/messaging/msgq.h
+DEFAULT_SEGMENT_SIZE = 10 * 1024 * 1024
+DEFAULT_NUM_READERS = 12
+
 
 def new_port(port: int):
   port += STARTING_PORT
@@ -11,11 +15,14 @@ def new_port(port: int):
 
 
 class Service:
-  def __init__(self, port: int, should_log: bool, frequency: float, decimation: Optional[int] = None):
+  def __init__(self, port: int, should_log: bool, frequency: float, decimation: Optional[int] = None,
+               segment_size: int = DEFAULT_SEGMENT_SIZE, num_readers: int = DEFAULT_NUM_READERS):
     self.port = port
     self.should_log = should_log
     self.frequency = frequency
     self.decimation = decimation
+    self.segment_size = segment_size
+    self.num_readers = num_readers
 
 
 services: dict[str, tuple] = {
@@ -108,7 +115,26 @@ services: dict[str, tuple] = {
   "customReservedRawData1": (True, 0.),
   "customReservedRawData2": (True, 0.),
 }
-SERVICE_LIST = {name: Service(new_port(idx), *vals) for
+# msgq ring buffer size in bytes and max number of readers, for services that differ from the defaults.
+# The segment needs to fit at least three of the largest messages.
+msgq_config: dict[str, dict[str, int]] = {
+  "can": {"num_readers": 24},
+  "sendcan": {"num_readers": 24},
+  "carState": {"num_readers": 24},
+  "modelV2": {"num_readers": 24},
+  "temperatureSensor": {"segment_size": 64 * 1024},
+  "temperatureSensor2": {"segment_size": 64 * 1024},
+  "peripheralState": {"segment_size": 64 * 1024},
+  "liveCalibration": {"segment_size": 64 * 1024},
+  "liveTorqueParameters": {"segment_size": 64 * 1024},
+  "gpsLocation": {"segment_size": 64 * 1024},
+  "clocks": {"segment_size": 64 * 1024},
+  "onroadEvents": {"segment_size": 64 * 1024},
+  "userFlag": {"segment_size": 64 * 1024},
+  "frogpilotNavigation": {"segment_size": 64 * 1024},
+}
+
+SERVICE_LIST = {name: Service(new_port(idx), *vals, **msgq_config.get(name, {})) for
                 idx, (name, vals) in enumerate(services.items())}
 
 
@@ -121,13 +147,13 @@ def build_header():
   h += "#include <map>\n"
   h += "#include <string>\n"
 
-  h += "struct service { std::string name; int port; bool should_log; int frequency; int decimation; };\n"
+  h += "struct service { std::string name; int port; bool should_log; int frequency; int decimation; int segment_size; int num_readers; };\n"
   h += "static std::map<std::string, service> services = {\n"
   for k, v in SERVICE_LIST.items():
     should_log = "true" if v.should_log else "false"
     decimation = -1 if v.decimation is None else v.decimation
-    h += '  { "%s", {"%s", %d, %s, %d, %d}},\n' % \
-         (k, k, v.port, should_log, v.frequency, decimation)
+    h += '  { "%s", {"%s", %d, %s, %d, %d, %d, %d}},\n' % \
+         (k, k, v.port, should_log, v.frequency, decimation, v.segment_size, v.num_readers)
   h += "};\n"
 
   h += "#endif\n"
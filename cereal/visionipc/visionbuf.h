@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+
 #include "cereal/visionipc/visionipc.h"
 
 #define CL_USE_DEPRECATED_OPENCL_1_2_APIS
@@ -21,12 +23,22 @@ enum VisionStreamType {
   VISION_STREAM_MAX,
 };
 
+// Shared by the server and all clients, lives in the same mapping right after the frame data
+struct VisionBufState {
+  uint64_t frame_id;
+  // Odd while the server is writing a new frame into the buffer
+  std::atomic<uint64_t> seq;
+  // One bit per client slot that currently holds the buffer
+  std::atomic<uint64_t> readers;
+};
+
 class VisionBuf {
  public:
   size_t len = 0;
   size_t mmap_len = 0;
   void * addr = nullptr;
   uint64_t *frame_id;
+  VisionBufState *state = nullptr;
   int fd = 0;
 
   bool rgb = false;
@@ -42,6 +54,7 @@ class VisionBuf {
   // Visionipc
   uint64_t server_id = 0;
   size_t idx = 0;
+  uint32_t reader_slot = 0;
   VisionStreamType type;
 
   // OpenCL
@@ -63,4 +76,9 @@ class VisionBuf {
   uint64_t get_frame_id();
 };
 
+// The state is placed at a cache line aligned offset, so its atomics are naturally aligned
+inline size_t visionbuf_state_offset(size_t len) {
+  return (len + 63) & ~(size_t)63;
+}
+
 void visionbuf_compute_aligned_width_and_height(int width, int height, int *aligned_w, int *aligned_h);
@@ -34,9 +34,10 @@ static void *malloc_with_fd(size_t len, int *fd) {
 
 void VisionBuf::allocate(size_t length) {
   this->len = length;
-  this->mmap_len = this->len + sizeof(uint64_t);
+  this->mmap_len = visionbuf_state_offset(this->len) + sizeof(VisionBufState);
   this->addr = malloc_with_fd(this->mmap_len, &this->fd);
-  this->frame_id = (uint64_t*)((uint8_t*)this->addr + this->len);
+  this->state = (VisionBufState*)((uint8_t*)this->addr + visionbuf_state_offset(this->len));
+  this->frame_id = &this->state->frame_id;
 }
 
 void VisionBuf::init_cl(cl_device_id device_id, cl_context ctx){
@@ -55,7 +56,8 @@ void VisionBuf::import(){
   this->addr = mmap(NULL, this->mmap_len, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
   assert(this->addr != MAP_FAILED);
 
-  this->frame_id = (uint64_t*)((uint8_t*)this->addr + this->len);
+  this->state = (VisionBufState*)((uint8_t*)this->addr + visionbuf_state_offset(this->len));
+  this->frame_id = &this->state->frame_id;
 }
 
 
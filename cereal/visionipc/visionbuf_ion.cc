@@ -58,7 +58,7 @@ int ion_fd() {
 
 void VisionBuf::allocate(size_t length) {
   struct ion_allocation_data ion_alloc = {0};
-  ion_alloc.len = length + PADDING_CL + sizeof(uint64_t);
+  ion_alloc.len = visionbuf_state_offset(length + PADDING_CL) + sizeof(VisionBufState);
   ion_alloc.align = 4096;
   ion_alloc.heap_id_mask = 1 << ION_IOMMU_HEAP_ID;
   ion_alloc.flags = ION_FLAG_CACHED;
@@ -83,7 +83,8 @@ void VisionBuf::allocate(size_t length) {
   this->addr = mmap_addr;
   this->handle = ion_alloc.handle;
   this->fd = ion_fd_data.fd;
-  this->frame_id = (uint64_t*)((uint8_t*)this->addr + this->len + PADDING_CL);
+  this->state = (VisionBufState*)((uint8_t*)this->addr + visionbuf_state_offset(this->len + PADDING_CL));
+  this->frame_id = &this->state->frame_id;
 }
 
 void VisionBuf::import(){
@@ -100,7 +101,8 @@ void VisionBuf::import(){
   this->addr = mmap(NULL, this->mmap_len, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
   assert(this->addr != MAP_FAILED);
 
-  this->frame_id = (uint64_t*)((uint8_t*)this->addr + this->len + PADDING_CL);
+  this->state = (VisionBufState*)((uint8_t*)this->addr + visionbuf_state_offset(this->len + PADDING_CL));
+  this->frame_id = &this->state->frame_id;
 }
 
 void VisionBuf::init_cl(cl_device_id device_id, cl_context ctx) {
@@ -4,6 +4,7 @@
 #include <cstddef>
 
 constexpr int VISIONIPC_MAX_FDS = 128;
+constexpr int VISIONIPC_MAX_READERS = 64;
 
 struct VisionIpcBufExtra {
   uint32_t frame_id;
@@ -15,5 +16,7 @@ struct VisionIpcBufExtra {
 struct VisionIpcPacket {
   uint64_t server_id;
   size_t idx;
+  // VisionBufState::seq of the buffer when the frame was sent
+  uint64_t seq;
   struct VisionIpcBufExtra extra;
 };
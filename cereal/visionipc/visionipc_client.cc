@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <chrono>
 #include <cassert>
 #include <iostream>
@@ -31,6 +32,7 @@ VisionIpcClient::VisionIpcClient(std::string name, VisionStreamType type, bool c
 // Connect is not thread safe. Do not use the buffers while calling connect
 bool VisionIpcClient::connect(bool blocking){
   connected = false;
+  release();
 
   // Cleanup old buffers on reconnect
   for (size_t i = 0; i < num_buffers; i++){
@@ -40,7 +42,20 @@ bool VisionIpcClient::connect(bool blocking){
   }
 
   num_buffers = 0;
+  if (reader_fd >= 0) {
+    close(reader_fd);
+    reader_fd = -1;
+  }
+
+  if (!fetch_buffers(blocking)) {
+    return false;
+  }
+  connected = true;
+  return true;
+}
 
+// Imports the buffers this client doesn't have yet, the server can grow its pool while running
+bool VisionIpcClient::fetch_buffers(bool blocking) {
   int socket_fd = connect_to_vipc_server(name, blocking);
   if (socket_fd < 0) {
     return false;
@@ -52,13 +67,26 @@ bool VisionIpcClient::connect(bool blocking){
   // Get FDs
   int fds[VISIONIPC_MAX_FDS];
   VisionBuf bufs[VISIONIPC_MAX_FDS];
-  r = ipc_sendrecv_with_fds(false, socket_fd, &bufs, sizeof(bufs), fds, VISIONIPC_MAX_FDS, &num_buffers);
+  int num_fds = 0;
+  r = ipc_sendrecv_with_fds(false, socket_fd, &bufs, sizeof(bufs), fds, VISIONIPC_MAX_FDS, &num_fds);
 
-  assert(num_buffers >= 0);
-  assert(r == sizeof(VisionBuf) * num_buffers);
+  assert(num_fds >= 0);
+  assert(r == sizeof(VisionBuf) * num_fds);
+
+  // The server closes the connection without sending buffers when all reader slots are taken
+  if (num_fds == 0) {
+    LOGE("VisionIpcClient %s stream %d: server has no reader slot left", name.c_str(), type);
+    close(socket_fd);
+    return false;
+  }
 
   // Import buffers
-  for (size_t i = 0; i < num_buffers; i++){
+  for (int i = 0; i < num_fds; i++){
+    if (i < num_buffers) {
+      close(fds[i]);
+      continue;
+    }
+
     buffers[i] = bufs[i];
     buffers[i].fd = fds[i];
     buffers[i].import();
@@ -71,8 +99,12 @@ bool VisionIpcClient::connect(bool blocking){
     if (device_id) buffers[i].init_cl(device_id, ctx);
   }
 
-  close(socket_fd);
-  connected = true;
+  reader_mask = 1ULL << bufs[0].reader_slot;
+  num_buffers = std::max(num_buffers, num_fds);
+
+  // The connection stays open while the client lives, the server frees the reader slot when it closes
+  if (reader_fd >= 0) close(reader_fd);
+  reader_fd = socket_fd;
   return true;
 }
 
@@ -92,7 +124,14 @@ VisionBuf * VisionIpcClient::recv(VisionIpcBufExtra * extra, const int timeout_m
   assert(r->getSize() == sizeof(VisionIpcPacket));
   VisionIpcPacket *packet = (VisionIpcPacket*)r->getData();
 
-  assert(packet->idx < num_buffers);
+  if (packet->idx >= (size_t)num_buffers) {
+    fetch_buffers(false);
+  }
+  if (packet->idx >= (size_t)num_buffers) {
+    connected = false;
+    delete r;
+    return nullptr;
+  }
   VisionBuf * buf = &buffers[packet->idx];
 
   if (buf->server_id != packet->server_id){
@@ -101,6 +140,19 @@ VisionBuf * VisionIpcClient::recv(VisionIpcBufExtra * extra, const int timeout_m
     return nullptr;
   }
 
+  // Take the buffer, unless the server already started writing the next frame into it
+  release();
+  buf->state->readers |= reader_mask;
+  if (buf->state->seq != packet->seq) {
+    buf->state->readers &= ~reader_mask;
+    dropped_stale++;
+    delete r;
+    return nullptr;
+  }
+  held = buf;
+  held_seq = packet->seq;
+  held_mask = reader_mask;
+
   if (extra) {
     *extra = packet->extra;
   }
@@ -130,12 +182,24 @@ std::set<VisionStreamType> VisionIpcClient::getAvailableStreams(const std::strin
   return std::set<VisionStreamType>(available_streams, available_streams + r / sizeof(VisionStreamType));
 }
 
+void VisionIpcClient::release() {
+  if (held == nullptr) return;
+
+  if (!held_valid()) {
+    overwritten_while_held++;
+  }
+  held->state->readers &= ~held_mask;
+  held = nullptr;
+}
+
 VisionIpcClient::~VisionIpcClient(){
+  release();
   for (size_t i = 0; i < num_buffers; i++){
     if (buffers[i].free() != 0) {
       LOGE("Failed to free buffer %zu", i);
     }
   }
+  if (reader_fd >= 0) close(reader_fd);
 
   delete sock;
   delete poller;
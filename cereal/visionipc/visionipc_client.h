@@ -16,15 +16,32 @@ private:
   cl_device_id device_id = nullptr;
   cl_context ctx = nullptr;
 
+  // Connection to the server holding the reader slot of reader_mask
+  int reader_fd = -1;
+  uint64_t reader_mask = 0;
+  VisionBuf * held = nullptr;
+  uint64_t held_seq = 0;
+  uint64_t held_mask = 0;
+
+  bool fetch_buffers(bool blocking);
+
 public:
   bool connected = false;
   VisionStreamType type;
   int num_buffers = 0;
   VisionBuf buffers[VISIONIPC_MAX_FDS];
+  // Frames dropped because the server was already rewriting them when they were received
+  uint64_t dropped_stale = 0;
+  // Frames the server overwrote while this client was holding them
+  uint64_t overwritten_while_held = 0;
   VisionIpcClient(std::string name, VisionStreamType type, bool conflate, cl_device_id device_id=nullptr, cl_context ctx=nullptr);
   ~VisionIpcClient();
   VisionBuf * recv(VisionIpcBufExtra * extra=nullptr, const int timeout_ms=100);
   bool connect(bool blocking=true);
+  // The buffer returned by recv is held until the next recv, release or connect.
+  // The server avoids writing into held buffers, held_valid tells if it had to anyway
+  void release();
+  bool held_valid() { return held && held->state->seq == held_seq; }
   bool is_connected() { return connected; }
   static std::set<VisionStreamType> getAvailableStreams(const std::string &name, bool blocking = true);
 };
@@ -66,11 +66,11 @@ cdef class VisionIpcServer:
   def __init__(self, string name):
     self.server = new cppVisionIpcServer(name, NULL, NULL)
 
-  def create_buffers(self, VisionStreamType tp, size_t num_buffers, bool rgb, size_t width, size_t height):
-    self.server.create_buffers(tp, num_buffers, rgb, width, height)
+  def create_buffers(self, VisionStreamType tp, size_t num_buffers, bool rgb, size_t width, size_t height, size_t max_buffers=0):
+    self.server.create_buffers(tp, num_buffers, rgb, width, height, max_buffers)
 
-  def create_buffers_with_sizes(self, VisionStreamType tp, size_t num_buffers, bool rgb, size_t width, size_t height, size_t size, size_t stride, size_t uv_offset):
-    self.server.create_buffers_with_sizes(tp, num_buffers, rgb, width, height, size, stride, uv_offset)
+  def create_buffers_with_sizes(self, VisionStreamType tp, size_t num_buffers, bool rgb, size_t width, size_t height, size_t size, size_t stride, size_t uv_offset, size_t max_buffers=0):
+    self.server.create_buffers_with_sizes(tp, num_buffers, rgb, width, height, size, stride, uv_offset, max_buffers)
 
   def send(self, VisionStreamType tp, const unsigned char[:] data, uint32_t frame_id=0, uint64_t timestamp_sof=0, uint64_t timestamp_eof=0):
     cdef cppVisionBuf * buf = self.server.get_buffer(tp)
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <chrono>
 #include <cassert>
@@ -38,7 +39,7 @@ VisionIpcServer::VisionIpcServer(std::string name, cl_device_id device_id, cl_co
   server_id = distribution(rd);
 }
 
-void VisionIpcServer::create_buffers(VisionStreamType type, size_t num_buffers, bool rgb, size_t width, size_t height){
+void VisionIpcServer::create_buffers(VisionStreamType type, size_t num_buffers, bool rgb, size_t width, size_t height, size_t max_buffers){
   // TODO: assert that this type is not created yet
   assert(num_buffers < VISIONIPC_MAX_FDS);
   int aligned_w = 0, aligned_h = 0;
@@ -57,22 +58,20 @@ void VisionIpcServer::create_buffers(VisionStreamType type, size_t num_buffers,
     uv_offset = width * height;
   }
 
-  create_buffers_with_sizes(type, num_buffers, rgb, width, height, size, stride, uv_offset);
+  create_buffers_with_sizes(type, num_buffers, rgb, width, height, size, stride, uv_offset, max_buffers);
 }
 
-void VisionIpcServer::create_buffers_with_sizes(VisionStreamType type, size_t num_buffers, bool rgb, size_t width, size_t height, size_t size, size_t stride, size_t uv_offset) {
-  // Create map + alloc requested buffers
-  for (size_t i = 0; i < num_buffers; i++){
-    VisionBuf* buf = new VisionBuf();
-    buf->allocate(size);
-    buf->idx = i;
-    buf->type = type;
+void VisionIpcServer::create_buffers_with_sizes(VisionStreamType type, size_t num_buffers, bool rgb, size_t width, size_t height, size_t size, size_t stride, size_t uv_offset, size_t max_buffers) {
+  max_buffers = std::max(max_buffers, num_buffers);
+  assert(max_buffers < VISIONIPC_MAX_FDS);
 
-    if (device_id) buf->init_cl(device_id, ctx);
+  buffer_params[type] = {rgb, width, height, size, stride, uv_offset};
+  pool_state[type] = {num_buffers, 0};
+  used_reader_slots[type] = 0;
 
-    rgb ? buf->init_rgb(width, height, stride) : buf->init_yuv(width, height, stride, uv_offset);
-
-    buffers[type].push_back(buf);
+  // Create map + alloc all buffers, allocating a spare later would stall the thread sending frames
+  for (size_t i = 0; i < max_buffers; i++){
+    add_buffer(type);
   }
 
   cur_idx[type] = 0;
@@ -82,6 +81,21 @@ void VisionIpcServer::create_buffers_with_sizes(VisionStreamType type, size_t nu
   sockets[type] = PubSocket::create(msg_ctx, get_endpoint_name(name, type), false);
 }
 
+VisionBuf * VisionIpcServer::add_buffer(VisionStreamType type) {
+  const BufferParams &p = buffer_params[type];
+
+  VisionBuf* buf = new VisionBuf();
+  buf->allocate(p.size);
+  buf->type = type;
+
+  if (device_id) buf->init_cl(device_id, ctx);
+
+  p.rgb ? buf->init_rgb(p.width, p.height, p.stride) : buf->init_yuv(p.width, p.height, p.stride, p.uv_offset);
+
+  buf->idx = buffers[type].size();
+  buffers[type].push_back(buf);
+  return buf;
+}
 
 void VisionIpcServer::start_listener(){
   listener_thread = std::thread(&VisionIpcServer::listener, this);
@@ -96,12 +110,13 @@ void VisionIpcServer::listener(){
   assert(sock >= 0);
 
   while (!should_exit){
-    // Wait for incoming connection
-    struct pollfd polls[1] = {{0}};
-    polls[0].fd = sock;
-    polls[0].events = POLLIN;
+    // Wait for incoming connection, or for a client to go away
+    std::vector<struct pollfd> polls = {{.fd = sock, .events = POLLIN}};
+    for (auto &[client_fd, _] : reader_clients) {
+      polls.push_back({.fd = client_fd, .events = POLLIN});
+    }
 
-    int ret = poll(polls, 1, 100);
+    int ret = poll(polls.data(), polls.size(), 100);
     if (ret < 0) {
       if (errno == EINTR || errno == EAGAIN) continue;
       std::cout << "poll failed, stopping listener" << std::endl;
@@ -109,6 +124,12 @@ void VisionIpcServer::listener(){
     }
 
     if (should_exit) break;
+
+    // Clients keep their connection open and never send anything else, so any event is a disconnect
+    for (size_t i = 1; i < polls.size(); i++) {
+      if (polls[i].revents) remove_reader(polls[i].fd);
+    }
+
     if (!polls[0].revents) {
       continue;
     }
@@ -139,39 +160,104 @@ void VisionIpcServer::listener(){
       continue;
     }
 
-    int fds[VISIONIPC_MAX_FDS];
-    int num_fds = buffers[type].size();
-    VisionBuf bufs[VISIONIPC_MAX_FDS];
+    add_reader(fd, type);
+  }
+
+  while (!reader_clients.empty()) {
+    remove_reader(reader_clients.begin()->first);
+  }
 
-    for (int i = 0; i < num_fds; i++){
-      fds[i] = buffers[type][i]->fd;
-      bufs[i] = *buffers[type][i];
+  std::cout << "Stopping listener for: " << name << std::endl;
+  close(sock);
+  unlink(ipc_path.c_str());
+}
 
-      // Remove some private openCL/ion metadata
-      bufs[i].buf_cl = 0;
-      bufs[i].copy_q = 0;
-      bufs[i].handle = 0;
+void VisionIpcServer::add_reader(int fd, VisionStreamType type) {
+  // Every connected client gets its own slot in the readers mask, there is no slot left when all are taken
+  uint64_t &used = used_reader_slots[type];
+  if (used == ~0ULL) {
+    LOGE("visionipc %s stream %d: all %d reader slots in use, rejecting client", name.c_str(), type, VISIONIPC_MAX_READERS);
+    close(fd);
+    return;
+  }
+  uint32_t reader_slot = __builtin_ctzll(~used);
 
-      bufs[i].server_id = server_id;
-    }
+  int fds[VISIONIPC_MAX_FDS];
+  int num_fds = buffers[type].size();
+  VisionBuf bufs[VISIONIPC_MAX_FDS];
 
-    r = ipc_sendrecv_with_fds(true, fd, &bufs, sizeof(VisionBuf) * num_fds, fds, num_fds, nullptr);
+  for (int i = 0; i < num_fds; i++){
+    fds[i] = buffers[type][i]->fd;
+    bufs[i] = *buffers[type][i];
 
+    // Remove some private openCL/ion metadata
+    bufs[i].buf_cl = 0;
+    bufs[i].copy_q = 0;
+    bufs[i].handle = 0;
+
+    bufs[i].server_id = server_id;
+    bufs[i].reader_slot = reader_slot;
+  }
+
+  int r = ipc_sendrecv_with_fds(true, fd, &bufs, sizeof(VisionBuf) * num_fds, fds, num_fds, nullptr);
+  if (r != (int)(sizeof(VisionBuf) * num_fds)) {
     close(fd);
+    return;
   }
 
-  std::cout << "Stopping listener for: " << name << std::endl;
-  close(sock);
-  unlink(ipc_path.c_str());
+  used |= 1ULL << reader_slot;
+  reader_clients[fd] = {type, reader_slot};
 }
 
+void VisionIpcServer::remove_reader(int fd) {
+  auto it = reader_clients.find(fd);
+  assert(it != reader_clients.end());
+  auto [type, reader_slot] = it->second;
 
+  // The client may have died holding a buffer
+  for (VisionBuf *buf : buffers[type]) {
+    buf->state->readers &= ~(1ULL << reader_slot);
+  }
+  used_reader_slots[type] &= ~(1ULL << reader_slot);
+
+  reader_clients.erase(it);
+  close(fd);
+}
 
 VisionBuf * VisionIpcServer::get_buffer(VisionStreamType type){
-  // Do we want to keep track if the buffer has been sent out yet and warn user?
   assert(buffers.count(type));
-  auto b = buffers[type];
-  return b[cur_idx[type]++ % b.size()];
+  auto &b = buffers[type];
+  // Only this thread changes the number of buffers in use
+  const size_t num_buffers = pool_state[type].num_buffers;
+
+  // Skip buffers clients are still holding
+  for (size_t i = 0; i < num_buffers; i++) {
+    VisionBuf *buf = b[cur_idx[type]++ % num_buffers];
+    if (buf->state->readers != 0) continue;
+
+    buf->state->seq |= 1;  // odd, clients can't take the old frame anymore
+    if (buf->state->readers == 0) return buf;
+
+    // A client took the old frame right before the bump, give it back unchanged
+    buf->state->seq &= ~1ULL;
+  }
+
+  if (num_buffers < b.size()) {
+    // Clients never got a frame from a spare, nobody can be holding it
+    VisionBuf *buf = b[num_buffers];
+    pool_state[type].num_buffers++;
+    LOGW("visionipc %s stream %d: all buffers held, grown to %zu", name.c_str(), type, num_buffers + 1);
+    buf->state->seq |= 1;
+    return buf;
+  }
+
+  // Pool is at its cap, overwrite the next buffer anyway
+  VisionBuf *buf = b[cur_idx[type]++ % num_buffers];
+  buf->state->seq |= 1;
+  if (pool_state[type].overwritten_while_held++ % 100 == 0) {
+    LOGW("visionipc %s stream %d: overwriting held buffer (%lu times)", name.c_str(), type, (unsigned long)pool_state[type].overwritten_while_held);
+  }
+  return buf;
 }
 
 void VisionIpcServer::send(VisionBuf * buf, VisionIpcBufExtra * extra, bool sync){
@@ -183,10 +269,17 @@ void VisionIpcServer::send(VisionBuf * buf, VisionIpcBufExtra * extra, bool sync
   assert(buffers.count(buf->type));
   assert(buf->idx < buffers[buf->type].size());
 
+  // Done writing, the same frame can be sent more than once
+  uint64_t seq = buf->state->seq;
+  if (seq & 1) {
+    seq = ++buf->state->seq;
+  }
+
   // Send over correct msgq socket
   VisionIpcPacket packet = {0};
   packet.server_id = server_id;
   packet.idx = buf->idx;
+  packet.seq = seq;
   packet.extra = *extra;
 
   sockets[buf->type]->send((char*)&packet, sizeof(packet));
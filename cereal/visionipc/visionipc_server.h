@@ -21,13 +21,39 @@ class VisionIpcServer {
   std::string name;
   std::thread listener_thread;
 
+  struct BufferParams {
+    bool rgb;
+    size_t width, height, size, stride, uv_offset;
+  };
+
+  // Only used by the thread calling get_buffer
+  struct PoolState {
+    // Buffers in use, the rest of the buffers allocated are spares
+    size_t num_buffers;
+    // Frames written into a buffer a client was still holding
+    uint64_t overwritten_while_held;
+  };
+
   std::map<VisionStreamType, std::atomic<size_t> > cur_idx;
   std::map<VisionStreamType, std::vector<VisionBuf*> > buffers;
+  std::map<VisionStreamType, BufferParams> buffer_params;
+  std::map<VisionStreamType, PoolState> pool_state;
+
+  // Connected clients by socket, and the reader slots in use per stream. Only used by the listener thread
+  struct ReaderClient {
+    VisionStreamType type;
+    uint32_t reader_slot;
+  };
+  std::map<int, ReaderClient> reader_clients;
+  std::map<VisionStreamType, uint64_t> used_reader_slots;
 
   Context * msg_ctx;
   std::map<VisionStreamType, PubSocket*> sockets;
 
   void listener(void);
+  void add_reader(int fd, VisionStreamType type);
+  void remove_reader(int fd);
+  VisionBuf * add_buffer(VisionStreamType type);
 
  public:
   VisionIpcServer(std::string name, cl_device_id device_id=nullptr, cl_context ctx=nullptr);
@@ -35,8 +61,10 @@ class VisionIpcServer {
 
   VisionBuf * get_buffer(VisionStreamType type);
 
-  void create_buffers(VisionStreamType type, size_t num_buffers, bool rgb, size_t width, size_t height);
-  void create_buffers_with_sizes(VisionStreamType type, size_t num_buffers, bool rgb, size_t width, size_t height, size_t size, size_t stride, size_t uv_offset);
+  // max_buffers are allocated up front, the spares are only used while clients hold all other buffers.
+  // By default there are no spares
+  void create_buffers(VisionStreamType type, size_t num_buffers, bool rgb, size_t width, size_t height, size_t max_buffers=0);
+  void create_buffers_with_sizes(VisionStreamType type, size_t num_buffers, bool rgb, size_t width, size_t height, size_t size, size_t stride, size_t uv_offset, size_t max_buffers=0);
   void send(VisionBuf * buf, VisionIpcBufExtra * extra, bool sync=true);
   void start_listener();
 };
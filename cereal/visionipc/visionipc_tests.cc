@@ -1,7 +1,12 @@
+#include <cstring>
 #include <thread>
 #include <chrono>
+#include <vector>
+
+#include <unistd.h>
 
 #include "catch2/catch.hpp"
+#include "cereal/visionipc/ipc.h"
 #include "cereal/visionipc/visionipc_server.h"
 #include "cereal/visionipc/visionipc_client.h"
 
@@ -146,3 +151,166 @@ TEST_CASE("Test conflate"){
   recv_buf = client.recv(&extra_recv);
   REQUIRE(recv_buf == nullptr);
 }
+
+TEST_CASE("Held buffers are not overwritten"){
+  VisionIpcServer server("camerad");
+  server.create_buffers(VISION_STREAM_ROAD, 1, false, 100, 100, 4);
+  server.start_listener();
+
+  VisionIpcClient client = VisionIpcClient("camerad", VISION_STREAM_ROAD, false);
+  REQUIRE(client.connect());
+  zmq_sleep();
+
+  VisionIpcBufExtra extra = {0};
+  VisionBuf * buf = server.get_buffer(VISION_STREAM_ROAD);
+  extra.frame_id = 1;
+  server.send(buf, &extra);
+
+  VisionBuf * recv_buf = client.recv(&extra);
+  REQUIRE(recv_buf != nullptr);
+  REQUIRE(client.held_valid());
+
+  // The only buffer is held, so a spare is taken into use
+  VisionBuf * next_buf = server.get_buffer(VISION_STREAM_ROAD);
+  REQUIRE(next_buf != buf);
+  REQUIRE(next_buf->idx == 1);
+  REQUIRE(client.held_valid());
+
+  extra.frame_id = 2;
+  server.send(next_buf, &extra);
+
+  recv_buf = client.recv(&extra);
+  REQUIRE(recv_buf != nullptr);
+  REQUIRE(extra.frame_id == 2);
+  // Spares are handed to clients when they connect
+  REQUIRE(client.num_buffers == 4);
+  REQUIRE(client.overwritten_while_held == 0);
+}
+
+TEST_CASE("Overwritten while held is reported"){
+  VisionIpcServer server("camerad");
+  server.create_buffers(VISION_STREAM_ROAD, 1, false, 100, 100);
+  server.start_listener();
+
+  VisionIpcClient client = VisionIpcClient("camerad", VISION_STREAM_ROAD, false);
+  REQUIRE(client.connect());
+  zmq_sleep();
+
+  VisionIpcBufExtra extra = {0};
+  server.send(server.get_buffer(VISION_STREAM_ROAD), &extra);
+  REQUIRE(client.recv(&extra) != nullptr);
+
+  // The pool can't grow, the held buffer is reused
+  server.get_buffer(VISION_STREAM_ROAD);
+  REQUIRE(!client.held_valid());
+
+  client.release();
+  REQUIRE(client.overwritten_while_held == 1);
+}
+
+TEST_CASE("No torn frames with a slow client"){
+  const int num_frames = 100;
+  VisionIpcServer server("camerad");
+  server.create_buffers(VISION_STREAM_ROAD, 2, false, 100, 100, 8);
+  server.start_listener();
+
+  VisionIpcClient client = VisionIpcClient("camerad", VISION_STREAM_ROAD, false);
+  REQUIRE(client.connect());
+  zmq_sleep();
+
+  int received = 0, torn = 0;
+  std::thread reader([&]() {
+    VisionIpcBufExtra extra = {0};
+    auto start = std::chrono::steady_clock::now();
+    while (extra.frame_id < num_frames - 1 && std::chrono::steady_clock::now() - start < std::chrono::seconds(5)) {
+      VisionBuf *buf = client.recv(&extra, 100);
+      if (buf == nullptr) continue;
+
+      // Slow consumer, the server sends several frames while this one is held
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      uint8_t *data = (uint8_t *)buf->addr;
+      bool intact = buf->get_frame_id() == extra.frame_id && client.held_valid();
+      for (size_t i = 0; i < buf->len; i++) {
+        intact = intact && data[i] == (uint8_t)extra.frame_id;
+      }
+      received++;
+      torn += !intact;
+    }
+  });
+
+  for (int i = 0; i < num_frames; i++) {
+    VisionBuf *buf = server.get_buffer(VISION_STREAM_ROAD);
+    memset(buf->addr, i, buf->len);
+    buf->set_frame_id(i);
+
+    VisionIpcBufExtra extra = {0};
+    extra.frame_id = i;
+    server.send(buf, &extra);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  reader.join();
+
+  REQUIRE(received > 0);
+  REQUIRE(torn == 0);
+  REQUIRE(client.overwritten_while_held == 0);
+}
+
+// Takes a reader slot like a client, without mapping the buffers
+static int connect_reader(VisionStreamType type, uint32_t *reader_slot){
+  int fd = ipc_connect(get_ipc_path("camerad").c_str());
+  for (int i = 0; i < 20 && fd < 0; i++){
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    fd = ipc_connect(get_ipc_path("camerad").c_str());
+  }
+  REQUIRE(fd >= 0);
+  REQUIRE(ipc_sendrecv_with_fds(true, fd, &type, sizeof(type), nullptr, 0, nullptr) == sizeof(type));
+
+  static VisionBuf bufs[VISIONIPC_MAX_FDS];
+  int fds[VISIONIPC_MAX_FDS];
+  int num_fds = 0;
+  ipc_sendrecv_with_fds(false, fd, &bufs, sizeof(bufs), fds, VISIONIPC_MAX_FDS, &num_fds);
+  for (int i = 0; i < num_fds; i++) close(fds[i]);
+  if (num_fds == 0){
+    close(fd);
+    return -1;
+  }
+  *reader_slot = bufs[0].reader_slot;
+  return fd;
+}
+
+TEST_CASE("Reader slots are freed when clients disconnect"){
+  VisionIpcServer server("camerad");
+  server.create_buffers(VISION_STREAM_ROAD, 1, false, 100, 100);
+  server.start_listener();
+
+  std::vector<int> reader_fds;
+  uint64_t slots = 0;
+  uint32_t slot = 0;
+  for (int i = 0; i < VISIONIPC_MAX_READERS; i++){
+    int fd = connect_reader(VISION_STREAM_ROAD, &slot);
+    REQUIRE(fd >= 0);
+    REQUIRE(!(slots & (1ULL << slot)));
+    slots |= 1ULL << slot;
+    reader_fds.push_back(fd);
+  }
+
+  // All slots are taken, no client may share one
+  VisionIpcClient client = VisionIpcClient("camerad", VISION_STREAM_ROAD, false);
+  REQUIRE(!client.connect(false));
+
+  // A client that dies while holding a buffer frees its slot and the buffer
+  VisionBuf *buf = server.get_buffer(VISION_STREAM_ROAD);
+  buf->state->readers |= 1ULL << slot;
+  close(reader_fds.back());
+  reader_fds.pop_back();
+
+  bool connected = false;
+  for (int i = 0; i < 20 && !connected; i++){
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    connected = client.connect(false);
+  }
+  REQUIRE(connected);
+  REQUIRE(buf->state->readers == 0);
+
+  for (int fd : reader_fds) close(fd);
+}
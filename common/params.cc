@@ -5,9 +5,14 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <cerrno>
+#include <climits>
 #include <csignal>
+#include <cstdint>
 #include <unordered_map>
 
+#include "common/params_cache.h"
 #include "common/queue.h"
 #include "common/swaglog.h"
 #include "common/util.h"
@@ -87,392 +92,44 @@ private:
   int fd_ = -1;
 };
 
-std::unordered_map<std::string, uint32_t> keys = {
-    {"AccessToken", CLEAR_ON_MANAGER_START | DONT_LOG},
-    {"ApiCache_Device", PERSISTENT},
-    {"ApiCache_NavDestinations", PERSISTENT},
-    {"AssistNowToken", PERSISTENT},
-    {"AthenadPid", PERSISTENT},
-    {"AthenadUploadQueue", PERSISTENT},
-    {"AthenadRecentlyViewedRoutes", PERSISTENT},
-    {"BootCount", PERSISTENT},
-    {"CalibrationParams", PERSISTENT},
-    {"CameraDebugExpGain", CLEAR_ON_MANAGER_START},
-    {"CameraDebugExpTime", CLEAR_ON_MANAGER_START},
-    {"CarBatteryCapacity", PERSISTENT},
-    {"CarParams", CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION},
-    {"CarParamsCache", CLEAR_ON_MANAGER_START},
-    {"CarParamsPersistent", PERSISTENT},
-    {"CarParamsPrevRoute", PERSISTENT},
-    {"CarVin", CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION},
-    {"CompletedTrainingVersion", PERSISTENT},
-    {"ControlsReady", CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION},
-    {"CurrentBootlog", PERSISTENT},
-    {"CurrentRoute", CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION},
-    {"DisableLogging", CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION},
-    {"DisablePowerDown", PERSISTENT},
-    {"DisableUpdates", PERSISTENT},
-    {"DisengageOnAccelerator", PERSISTENT | FROGPILOT_STORAGE},
-    {"DmModelInitialized", CLEAR_ON_ONROAD_TRANSITION},
-    {"DongleId", PERSISTENT},
-    {"DoReboot", CLEAR_ON_MANAGER_START},
-    {"DoShutdown", CLEAR_ON_MANAGER_START},
-    {"DoUninstall", CLEAR_ON_MANAGER_START},
-    {"ExperimentalLongitudinalEnabled", PERSISTENT | DEVELOPMENT_ONLY | FROGPILOT_STORAGE},
-    {"ExperimentalMode", PERSISTENT | FROGPILOT_STORAGE},
-    {"ExperimentalModeConfirmed", PERSISTENT},
-    {"FirmwareQueryDone", CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION},
-    {"ForcePowerDown", PERSISTENT},
-    {"GitBranch", PERSISTENT},
-    {"GitCommit", PERSISTENT},
-    {"GitCommitDate", PERSISTENT},
-    {"GitDiff", PERSISTENT},
-    {"GithubSshKeys", PERSISTENT},
-    {"GithubUsername", PERSISTENT},
-    {"GitRemote", PERSISTENT},
-    {"GsmApn", PERSISTENT},
-    {"GsmMetered", PERSISTENT | FROGPILOT_STORAGE},
-    {"GsmRoaming", PERSISTENT | FROGPILOT_STORAGE},
-    {"HardwareSerial", PERSISTENT},
-    {"HasAcceptedTerms", PERSISTENT},
-    {"IMEI", PERSISTENT},
-    {"InstallDate", PERSISTENT},
-    {"IsDriverViewEnabled", CLEAR_ON_MANAGER_START},
-    {"IsEngaged", PERSISTENT},
-    {"IsLdwEnabled", PERSISTENT | FROGPILOT_STORAGE},
-    {"IsMetric", PERSISTENT | FROGPILOT_STORAGE},
-    {"IsOffroad", CLEAR_ON_MANAGER_START},
-    {"IsOnroad", PERSISTENT},
-    {"IsRhdDetected", PERSISTENT},
-    {"IsReleaseBranch", CLEAR_ON_MANAGER_START},
-    {"IsTakingSnapshot", CLEAR_ON_MANAGER_START},
-    {"IsTestedBranch", CLEAR_ON_MANAGER_START},
-    {"JoystickDebugMode", CLEAR_ON_MANAGER_START | CLEAR_ON_OFFROAD_TRANSITION},
-    {"LanguageSetting", PERSISTENT},
-    {"LastAthenaPingTime", CLEAR_ON_MANAGER_START},
-    {"LastGPSPosition", PERSISTENT},
-    {"LastManagerExitReason", CLEAR_ON_MANAGER_START},
-    {"LastOffroadStatusPacket", CLEAR_ON_MANAGER_START | CLEAR_ON_OFFROAD_TRANSITION},
-    {"LastPowerDropDetected", CLEAR_ON_MANAGER_START},
-    {"LastUpdateException", CLEAR_ON_MANAGER_START},
-    {"LastUpdateTime", PERSISTENT},
-    {"LiveParameters", PERSISTENT},
-    {"LiveTorqueParameters", PERSISTENT | DONT_LOG},
-    {"LongitudinalPersonality", PERSISTENT},
-    {"NavDestination", CLEAR_ON_MANAGER_START | CLEAR_ON_OFFROAD_TRANSITION},
-    {"NavDestinationWaypoints", CLEAR_ON_MANAGER_START | CLEAR_ON_OFFROAD_TRANSITION},
-    {"NavPastDestinations", PERSISTENT},
-    {"NavSettingLeftSide", PERSISTENT | FROGPILOT_STORAGE},
-    {"NavSettingTime24h", PERSISTENT | FROGPILOT_STORAGE},
-    {"NetworkMetered", PERSISTENT},
-    {"ObdMultiplexingChanged", CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION},
-    {"ObdMultiplexingEnabled", CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION},
-    {"Offroad_BadNvme", CLEAR_ON_MANAGER_START},
-    {"Offroad_CarUnrecognized", CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION},
-    {"Offroad_ConnectivityNeeded", CLEAR_ON_MANAGER_START},
-    {"Offroad_ConnectivityNeededPrompt", CLEAR_ON_MANAGER_START},
-    {"Offroad_InvalidTime", CLEAR_ON_MANAGER_START},
-    {"Offroad_IsTakingSnapshot", CLEAR_ON_MANAGER_START},
-    {"Offroad_NeosUpdate", CLEAR_ON_MANAGER_START},
-    {"Offroad_NoFirmware", CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION},
-    {"Offroad_Recalibration", CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION},
-    {"Offroad_StorageMissing", CLEAR_ON_MANAGER_START},
-    {"Offroad_TemperatureTooHigh", CLEAR_ON_MANAGER_START},
-    {"Offroad_UnofficialHardware", CLEAR_ON_MANAGER_START},
-    {"Offroad_UpdateFailed", CLEAR_ON_MANAGER_START},
-    {"OpenpilotEnabledToggle", PERSISTENT | FROGPILOT_STORAGE},
-    {"PandaHeartbeatLost", CLEAR_ON_MANAGER_START | CLEAR_ON_OFFROAD_TRANSITION},
-    {"PandaSomResetTriggered", CLEAR_ON_MANAGER_START | CLEAR_ON_OFFROAD_TRANSITION},
-    {"PandaSignatures", CLEAR_ON_MANAGER_START},
-    {"PrimeType", PERSISTENT},
-    {"RecordFront", PERSISTENT | FROGPILOT_STORAGE},
-    {"RecordFrontLock", PERSISTENT},  // for the internal fleet
-    {"ReplayControlsState", CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION},
-    {"RouteCount", PERSISTENT},
-    {"SnoozeUpdate", CLEAR_ON_MANAGER_START | CLEAR_ON_OFFROAD_TRANSITION},
-    {"SshEnabled", PERSISTENT | FROGPILOT_STORAGE},
-    {"TermsVersion", PERSISTENT},
-    {"Timezone", PERSISTENT},
-    {"TrainingVersion", PERSISTENT},
-    {"UbloxAvailable", PERSISTENT},
-    {"UpdateAvailable", CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION},
-    {"UpdateFailedCount", CLEAR_ON_MANAGER_START},
-    {"UpdaterAvailableBranches", PERSISTENT},
-    {"UpdaterCurrentDescription", CLEAR_ON_MANAGER_START},
-    {"UpdaterCurrentReleaseNotes", CLEAR_ON_MANAGER_START},
-    {"UpdaterFetchAvailable", CLEAR_ON_MANAGER_START},
-    {"UpdaterNewDescription", CLEAR_ON_MANAGER_START},
-    {"UpdaterNewReleaseNotes", CLEAR_ON_MANAGER_START},
-    {"UpdaterState", CLEAR_ON_MANAGER_START},
-    {"UpdaterTargetBranch", CLEAR_ON_MANAGER_START},
-    {"UpdaterLastFetchTime", PERSISTENT},
-    {"Version", PERSISTENT},
-
-    {"AutoNaviSpeedCtrlStart", PERSISTENT},
-    {"AutoNaviSpeedCtrlEnd", PERSISTENT},
-
-    // FrogPilot parameters
-    {"AccelerationPath", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"AccelerationProfile", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"AdjacentPath", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"AdjacentPathMetrics", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"AggressiveAcceleration", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"AggressiveAccelerationExperimental", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"AggressiveFollow", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"AggressiveJerkAcceleration", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"AggressiveJerkSpeed", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"AggressivePersonalityProfile", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"AlertVolumeControl", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"AlwaysOnLateral", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"AlwaysOnLateralMain", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"AMapKey1", PERSISTENT},
-    {"AMapKey2", PERSISTENT},
-    {"ApiCache_DriveStats", PERSISTENT},
-    {"AutomaticUpdates", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_OTHER},
-    {"AvailableModels", PERSISTENT},
-    {"AvailableModelsNames", PERSISTENT},
-    {"BorderMetrics", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"BigMap", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"BlindSpotMetrics", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"BlindSpotPath", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"CameraFPS", PERSISTENT},
-    {"CameraView", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"CarMake", PERSISTENT},
-    {"CarModel", PERSISTENT},
-    {"CECurves", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"CECurvesLead", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"CENavigation", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"CENavigationIntersections", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"CENavigationLead", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"CENavigationTurns", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"CESignal", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"CESlowerLead", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"CESpeed", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"CESpeedLead", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"CEStatus", PERSISTENT},
-    {"CEStopLights", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"CEStopLightsLead", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"ClusterOffset", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES},
-    {"Compass", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"ConditionalExperimental", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"CrosstrekTorque", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES},
-    {"CurrentHolidayTheme", PERSISTENT},
-    {"CurrentRandomEvent", PERSISTENT},
-    {"CurveSensitivity", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"CustomAlerts", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"CustomColors", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"CustomCruise", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"CustomCruiseLong", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"CustomIcons", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"CustomPaths", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"CustomPersonalities", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"CustomUI", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"CustomSignals", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"CustomSounds", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"CustomTheme", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"CydiaTune", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES},
-    {"DecelerationProfile", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"DeveloperUI", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"DeviceManagement", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"DeviceShutdown", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"DisableMTSCSmoothing", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"DisableOnroadUploads", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"DisableOpenpilotLongitudinal", PERSISTENT | FROGPILOT_STORAGE},
-    {"DisableVTSCSmoothing", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"DisengageVolume", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"DoToggleReset", PERSISTENT},
-    {"DragonPilotTune", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES},
-    {"DriverCamera", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"DrivingPersonalities", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"DynamicPathWidth", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"DynamicPedalsOnUI", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"EngageVolume", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"ExperimentalModeActivation", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"ExperimentalModeViaDistance", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"ExperimentalModeViaLKAS", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"ExperimentalModeViaTap", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"Fahrenheit", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"FingerprintLogged", PERSISTENT},
-    {"ForceAutoTune", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"ForceFingerprint", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES},
-    {"ForceMPHDashboard", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"FPSCounter", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"FrogPilotDrives", PERSISTENT | FROGPILOT_TRACKING},
-    {"FrogPilotKilometers", PERSISTENT | FROGPILOT_TRACKING},
-    {"FrogPilotMinutes", PERSISTENT | FROGPILOT_TRACKING},
-    {"FrogPilotTogglesUpdated", PERSISTENT},
-    {"FrogsGoMoo", PERSISTENT},
-    {"FrogsGoMooTune", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES},
-    {"FullMap", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"GasRegenCmd", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES},
-    {"GMapKey", PERSISTENT},
-    {"GoatScream", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"GreenLightAlert", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"HideAlerts", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"HideAOLStatusBar", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"HideCEMStatusBar", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"HideDisableOpenpilotLongitudinal", PERSISTENT},
-    {"HideLeadMarker", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"HideMapIcon", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"HideMaxSpeed", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"HideSpeed", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"HideSpeedUI", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"HideUIElements", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"HolidayThemes", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"IncreaseThermalLimits", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"KaofuiIcons", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"LaneChangeCustomizations", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"LaneChangeTime", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"LaneDetectionWidth", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"LaneLinesWidth", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"LastMapsUpdate", PERSISTENT | FROGPILOT_OTHER},
-    {"LateralMetrics", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"LateralTune", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"LeadDepartingAlert", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"LeadDetectionThreshold", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"LockDoors", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES},
-    {"LongitudinalMetrics", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"LongitudinalTune", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"LongPitch", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES},
-    {"LoudBlindspotAlert", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"LowVoltageShutdown", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"ManualUpdateInitiated", PERSISTENT},
-    {"MapboxPublicKey", PERSISTENT},
-    {"MapboxSecretKey", PERSISTENT},
-    {"MapAcceleration", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"MapDeceleration", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"MapGears", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"MapsSelected", PERSISTENT | FROGPILOT_OTHER},
-    {"MapSpeedLimit", PERSISTENT},
-    {"MapStyle", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"MapTargetLatA", PERSISTENT},
-    {"MapTargetVelocities", PERSISTENT},
-    {"MinimumLaneChangeSpeed", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"Model", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"ModelDownloadProgress", PERSISTENT},
-    {"ModelName", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"ModelSelector", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"ModelToDownload", PERSISTENT},
-    {"ModelUI", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"MTSCAggressiveness", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"MTSCCurvatureCheck", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"MTSCEnabled", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"NNFF", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"NNFFLite", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"NNFFModelName", PERSISTENT},
-    {"NoLogging", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"NoUploads", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"NudgelessLaneChange", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"NumericalTemp", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"OfflineMode", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"Offset1", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"Offset2", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"Offset3", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"Offset4", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"OneLaneChange", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"OnroadDistanceButton", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"OnroadDistanceButtonPressed", PERSISTENT},
-    {"OSMDownloadBounds", PERSISTENT},
-    {"OSMDownloadLocations", PERSISTENT},
-    {"OSMDownloadProgress", CLEAR_ON_MANAGER_START},
-    {"ParamConversionVersion", PERSISTENT},
-    {"PathEdgeWidth", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"PathWidth", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"PauseAOLOnBrake", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"PauseLateralOnSignal", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"PauseLateralSpeed", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"PedalsOnUI", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"PreferredSchedule", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_OTHER},
-    {"PreviousSpeedLimit", PERSISTENT},
-    {"PromptDistractedVolume", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"PromptVolume", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"QOLControls", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"QOLVisuals", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"RandomEvents", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"RefuseVolume", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"RelaxedFollow", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"RelaxedJerkAcceleration", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"RelaxedJerkSpeed", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"RelaxedPersonalityProfile", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"ResetSteerRatio", PERSISTENT},
-    {"ReverseCruise", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"ReverseCruiseUI", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"RoadEdgesWidth", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"RoadName", PERSISTENT},
-    {"RoadNameUI", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"RotatingWheel", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"ScreenBrightness", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"ScreenBrightnessOnroad", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"ScreenManagement", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"ScreenRecorder", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"ScreenTimeout", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"ScreenTimeoutOnroad", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"SearchInput", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_OTHER},
-    {"SetSpeedLimit", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"SetSpeedOffset", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"ShowCPU", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"ShowGPU", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"ShowIP", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"ShowMemoryUsage", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"ShowSLCOffset", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"ShowSLCOffsetUI", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"ShowSteering", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"ShowStorageLeft", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"ShowStorageUsed", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"Sidebar", PERSISTENT | FROGPILOT_OTHER},
-    {"SidebarMetrics", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"SignalMetrics", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"SLCConfirmation", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"SLCConfirmationLower", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"SLCConfirmationHigher", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"SLCConfirmed", PERSISTENT},
-    {"SLCConfirmedPressed", PERSISTENT},
-    {"SLCLookaheadHigher", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"SLCLookaheadLower", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"SLCFallback", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"SLCOverride", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"SLCPriority", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"SLCPriority1", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"SLCPriority2", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"SLCPriority3", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"SmoothBraking", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"SmoothBrakingFarLead", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"SmoothBrakingJerk", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"SNGHack", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES},
-    {"SpeedLimitController", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"SpeedLimitChangedAlert", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"StandardFollow", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"StandardJerkAcceleration", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"StandardJerkSpeed", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"StandardPersonalityProfile", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"StandbyMode", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"StaticPedalsOnUI", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"SteerRatio", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"SteerRatioStock", PERSISTENT},
-    {"StockTune", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES},
-    {"StoppingDistance", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"TacoTune", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"TetheringEnabled", PERSISTENT | FROGPILOT_OTHER},
-    {"ToyotaDoors", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES},
-    {"TrafficFollow", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"TrafficJerkAcceleration", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"TrafficJerkSpeed", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"TrafficMode", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"TrafficModeActive", CLEAR_ON_OFFROAD_TRANSITION},
-    {"TrafficPersonalityProfile", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"TurnAggressiveness", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"TurnDesires", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"UnlimitedLength", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"UnlockDoors", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES},
-    {"Updated", PERSISTENT},
-    {"UseSI", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"UseVienna", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"VisionTurnControl", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS},
-    {"WarningImmediateVolume", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"WarningSoftVolume", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"WheelIcon", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-    {"WheelSpeed", PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS},
-};
+std::unordered_map<std::string, uint32_t> keys = [] {
+  std::unordered_map<std::string, uint32_t> ret;
+  for (auto &k : PARAM_KEYS) {
+    ret[k.name] = k.flags;
+  }
+  return ret;
+}();
+
+// index of each ParamKey in the shared memory cache
+std::vector<int> cache_index;
+
+// true if the number ends the value, trailing whitespace such as a newline is allowed
+bool parsed_all(const char *begin, const char *end) {
+  while (isspace((unsigned char)*end)) end++;
+  return end != begin && *end == '\0';
+}
+
+// A value that isn't a number decodes as the default, 0, the same as a missing one
+uint32_t decode_value(ParamValueType type, const std::string &value) {
+  union { bool b; int32_t i; float f; uint32_t bits; } v = {};
+  const char *begin = value.c_str();
+  char *end = nullptr;
+  if (type == ParamValueType::BOOL) {
+    v.b = value == "1";
+  } else if (type == ParamValueType::INT) {
+    errno = 0;
+    long i = strtol(begin, &end, 10);
+    if (parsed_all(begin, end) && errno == 0 && i >= INT32_MIN && i <= INT32_MAX) {
+      v.i = i;
+    }
+  } else if (type == ParamValueType::FLOAT) {
+    float f = strtof(begin, &end);
+    if (parsed_all(begin, end)) {
+      v.f = f;
+    }
+  }
+  return v.bits;
+}
 
 } // namespace
 
@@ -480,12 +137,21 @@ std::unordered_map<std::string, uint32_t> keys = {
 Params::Params(const std::string &path) {
   params_prefix = "/" + util::getenv("OPENPILOT_PREFIX", "d");
   params_path = ensure_params_path(params_prefix, path);
+
+  static const std::vector<std::string> all_keys = allKeys();
+  cache = ParamsCache::get(getParamPath(), params_path + "/.lock", all_keys);
+  if (cache) {
+    static std::once_flag index_once;
+    std::call_once(index_once, [this]() {
+      for (auto &k : PARAM_KEYS) {
+        cache_index.push_back(cache->index(k.name));
+      }
+    });
+  }
 }
 
 Params::~Params() {
-  if (future.valid()) {
-    future.wait();
-  }
+  flush();
   assert(queue.empty());
 }
 
@@ -506,12 +172,22 @@ ParamKeyType Params::getKeyType(const std::string &key) {
 }
 
 int Params::put(const char* key, const char* value, size_t value_size) {
+  int result = writeValue(key, value, value_size);
+  if (result == 0) {
+    // fsync parent directory
+    FileLock file_lock(params_path + "/.lock");
+    result = fsync_dir(getParamPath());
+  }
+  return result;
+}
+
+int Params::writeValue(const char* key, const char* value, size_t value_size) {
   // Information about safely and atomically writing a file: https://lwn.net/Articles/457667/
   // 1) Create temp file
   // 2) Write data to temp file
   // 3) fsync() the temp file
   // 4) rename the temp file to the real name
-  // 5) fsync() the containing directory
+  // 5) fsync() the containing directory, done by the caller so a batch only needs one
   std::string tmp_path = params_path + "/.tmp_value_XXXXXX";
   int tmp_fd = mkstemp((char*)tmp_path.c_str());
   if (tmp_fd < 0) return -1;
@@ -531,10 +207,9 @@ int Params::put(const char* key, const char* value, size_t value_size) {
     FileLock file_lock(params_path + "/.lock");
 
     // Move temp into place.
-    if ((result = rename(tmp_path.c_str(), getParamPath(key).c_str())) < 0) break;
-
-    // fsync parent directory
-    result = fsync_dir(getParamPath());
+    if (cache) cache->beginWrite(key);
+    result = rename(tmp_path.c_str(), getParamPath(key).c_str());
+    if (cache) cache->endWrite(key, value, value_size, result == 0);
   } while (false);
 
   close(tmp_fd);
@@ -544,7 +219,9 @@ int Params::put(const char* key, const char* value, size_t value_size) {
 
 int Params::remove(const std::string &key) {
   FileLock file_lock(params_path + "/.lock");
+  if (cache) cache->beginWrite(key);
   int result = unlink(getParamPath(key).c_str());
+  if (cache) cache->endWrite(key, "", 0, result == 0 || errno == ENOENT);
   if (result != 0) {
     return result;
   }
@@ -553,6 +230,10 @@ int Params::remove(const std::string &key) {
 
 std::string Params::get(const std::string &key, bool block) {
   if (!block) {
+    std::string value;
+    if (cache && cache->read(key, value)) {
+      return value;
+    }
     return util::read_file(getParamPath(key));
   } else {
     // blocking read until successful
@@ -562,10 +243,11 @@ std::string Params::get(const std::string &key, bool block) {
 
     std::string value;
     while (!params_do_exit) {
-      if (value = util::read_file(getParamPath(key)); !value.empty()) {
+      uint32_t gen = generation();
+      if (value = get(key); !value.empty()) {
         break;
       }
-      util::sleep_for(100);  // 0.1 s
+      waitForChange(gen, 100);  // 0.1 s
     }
 
     std::signal(SIGINT, prev_handler_sigint);
@@ -574,6 +256,43 @@ std::string Params::get(const std::string &key, bool block) {
   }
 }
 
+std::string Params::get(ParamKey key) {
+  std::string value;
+  if (cache && cache->read(cache_index[(size_t)key], value)) {
+    return value;
+  }
+  return util::read_file(getParamPath(paramKeyInfo(key).name));
+}
+
+Params::DecodedValue Params::getDecoded(ParamKey key) {
+  DecodedValue ret;
+  const ParamValueType type = paramKeyInfo(key).type;
+  if (!cache) {
+    ret.bits = decode_value(type, get(key));
+    return ret;
+  }
+
+  std::call_once(decoded_once, [this]() { decoded.reset(new std::atomic<uint64_t>[(size_t)ParamKey::COUNT]()); });
+
+  // the version is taken before reading, so a value is never kept under a newer version than its own
+  const int idx = cache_index[(size_t)key];
+  const uint64_t version = cache->keyVersion(idx);
+  const uint64_t entry = decoded[(size_t)key].load(std::memory_order_relaxed);
+  if (entry != 0 && (entry >> 32) == version) {
+    ret.bits = (uint32_t)entry;
+    return ret;
+  }
+
+  std::string value;
+  if (cache->read(idx, value)) {
+    ret.bits = decode_value(type, value);
+    decoded[(size_t)key].store(version << 32 | ret.bits, std::memory_order_relaxed);
+  } else {
+    ret.bits = decode_value(type, util::read_file(getParamPath(paramKeyInfo(key).name)));
+  }
+  return ret;
+}
+
 std::map<std::string, std::string> Params::readAll() {
   FileLock file_lock(params_path + "/.lock");
   return util::read_files_in_dir(getParamPath());
@@ -590,7 +309,9 @@ void Params::clearAll(ParamKeyType key_type) {
       if (de->d_type != DT_DIR) {
         auto it = keys.find(de->d_name);
         if (it == keys.end() || (it->second & key_type)) {
-          unlink(getParamPath(de->d_name).c_str());
+          if (cache) cache->beginWrite(de->d_name);
+          int result = unlink(getParamPath(de->d_name).c_str());
+          if (cache) cache->endWrite(de->d_name, "", 0, result == 0);
         }
       }
     }
@@ -608,11 +329,62 @@ void Params::putNonBlocking(const std::string &key, const std::string &val) {
   }
 }
 
+void Params::flush() {
+  while (future.valid()) {
+    future.wait();
+    if (queue.empty()) break;
+    // a put raced with the writer thread exiting
+    future = std::async(std::launch::async, &Params::asyncWriteThread, this);
+  }
+}
+
 void Params::asyncWriteThread() {
-  // TODO: write the latest one if a key has multiple values in the queue.
+  // Group commit: only the latest value of each key in the queue is written,
+  // and the whole batch shares one directory fsync
+  std::map<std::string, std::string> batch;
   std::pair<std::string, std::string> p;
   while (queue.try_pop(p, 0)) {
-    // Params::put is Thread-Safe
-    put(p.first, p.second);
+    batch[p.first] = std::move(p.second);
+    while (queue.try_pop(p, 0)) {
+      batch[p.first] = std::move(p.second);
+    }
+
+    bool written = false;
+    for (auto &[key, value] : batch) {
+      // Params::writeValue is Thread-Safe
+      if (writeValue(key.c_str(), value.data(), value.size()) == 0) {
+        written = true;
+      } else {
+        LOGE("failed to write param %s", key.c_str());
+      }
+    }
+    if (written) {
+      FileLock file_lock(params_path + "/.lock");
+      fsync_dir(getParamPath());
+    }
+    batch.clear();
+  }
+}
+
+uint32_t Params::generation() {
+  return cache ? cache->generation() : 0;
+}
+
+bool Params::waitForChange(uint32_t generation, int timeout_ms) {
+  if (!cache) {
+    util::sleep_for(timeout_ms);
+    return true;
+  }
+  return cache->waitForChange(generation, timeout_ms);
+}
+
+uint32_t Params::keyVersion(const std::string &key) {
+  return cache ? cache->keyVersion(key) : 0;
+}
+
+void Params::reloadCache() {
+  if (cache) {
+    FileLock file_lock(params_path + "/.lock");
+    cache->reload();
   }
 }
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <atomic>
 #include <future>
+#include <iterator>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -9,6 +13,8 @@
 
 #include "common/queue.h"
 
+class ParamsCache;
+
 enum ParamKeyType {
   PERSISTENT = 0x02,
   CLEAR_ON_MANAGER_START = 0x04,
@@ -25,6 +31,43 @@ enum ParamKeyType {
   ALL = 0xFFFFFFFF
 };
 
+enum class ParamValueType : uint8_t {
+  BOOL,
+  INT,
+  FLOAT,
+  STRING,
+  BLOB,
+};
+
+// Integer ids of the keys, so a misspelled key fails to compile
+enum class ParamKey : uint16_t {
+#define PARAM(name, flags, type) name,
+#include "common/params_keys.h"
+#undef PARAM
+  COUNT
+};
+
+struct ParamKeyInfo {
+  const char *name;
+  uint32_t flags;
+  ParamValueType type;
+};
+
+inline constexpr ParamKeyInfo PARAM_KEYS[] = {
+#define PARAM(name, flags, type) {#name, flags, ParamValueType::type},
+#include "common/params_keys.h"
+#undef PARAM
+};
+static_assert(std::size(PARAM_KEYS) == (size_t)ParamKey::COUNT);
+
+constexpr const ParamKeyInfo &paramKeyInfo(ParamKey key) { return PARAM_KEYS[(size_t)key]; }
+
+template <ParamValueType T> struct ParamValue { using type = std::string; };
+template <> struct ParamValue<ParamValueType::BOOL> { using type = bool; };
+template <> struct ParamValue<ParamValueType::INT> { using type = int; };
+template <> struct ParamValue<ParamValueType::FLOAT> { using type = float; };
+template <ParamKey K> using param_value_t = typename ParamValue<paramKeyInfo(K).type>::type;
+
 class Params {
 public:
   explicit Params(const std::string &path = {});
@@ -59,6 +102,24 @@ public:
   }
   std::map<std::string, std::string> readAll();
 
+  // typed accessors, e.g. params.get<ParamKey::IsMetric>() returns a bool.
+  // The decoded value is kept until the key is written again, so repeated reads
+  // don't parse anything. Without the shared memory cache every read decodes.
+  std::string get(ParamKey key);
+  template <ParamKey K>
+  inline param_value_t<K> get() {
+    constexpr ParamValueType type = paramKeyInfo(K).type;
+    if constexpr (type == ParamValueType::BOOL) {
+      return getDecoded(K).b;
+    } else if constexpr (type == ParamValueType::INT) {
+      return getDecoded(K).i;
+    } else if constexpr (type == ParamValueType::FLOAT) {
+      return getDecoded(K).f;
+    } else {
+      return get(K);
+    }
+  }
+
   // helpers for writing values
   int put(const char *key, const char *val, size_t value_size);
   inline int put(const std::string &key, const std::string &val) {
@@ -85,12 +146,41 @@ public:
   inline void putFloatNonBlocking(const std::string &key, float val) {
     putNonBlocking(key, std::to_string(val));
   }
+  // Waits until every nonblocking put queued so far is on disk
+  void flush();
+
+  // change notifications, from the shared memory cache
+  // Bumped by every put/remove through Params in any process
+  uint32_t generation();
+  // Waits until generation() is different, returns false on timeout.
+  // Without the cache it sleeps and returns true, the caller has to check itself.
+  bool waitForChange(uint32_t generation, int timeout_ms);
+  // Changes every time the key is written
+  uint32_t keyVersion(const std::string &key);
+  // The shared memory cache only sees writes made through Params. A value written to its file any
+  // other way, e.g. by a shell script or a restored backup, isn't noticed: every process keeps reading
+  // the old value, and generation/keyVersion don't change, until reloadCache() is called.
+  // Values too large for a cache slot are always read from their file.
+  void reloadCache();
 
 private:
+  union DecodedValue {
+    bool b;
+    int32_t i;
+    float f;
+    uint32_t bits;
+  };
+  DecodedValue getDecoded(ParamKey key);
+  int writeValue(const char *key, const char *value, size_t value_size);
   void asyncWriteThread();
 
   std::string params_path;
   std::string params_prefix;
+  ParamsCache *cache = nullptr;
+  // per key: the version of the key in the cache << 32 | the decoded value, 0 if not decoded yet.
+  // Allocated on the first typed read.
+  std::unique_ptr<std::atomic<uint64_t>[]> decoded;
+  std::once_flag decoded_once;
 
   // for nonblocking write
   std::future<void> future;
@@ -0,0 +1,265 @@
+#include "common/params_cache.h"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "common/swaglog.h"
+#include "common/util.h"
+
+namespace {
+
+enum SlotFlags : uint32_t {
+  SLOT_UNCACHED = 0x1,  // read the file
+};
+
+uint64_t fnv1a(const void *data, size_t size, uint64_t hash = 0xcbf29ce484222325ULL) {
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ ((const uint8_t *)data)[i]) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+class FdLock {
+public:
+  FdLock(int fd) : fd_(fd) { HANDLE_EINTR(flock(fd_, LOCK_EX)); }
+  ~FdLock() { flock(fd_, LOCK_UN); }
+
+private:
+  int fd_;
+};
+
+}  // namespace
+
+ParamsCache *ParamsCache::get(const std::string &key_path, const std::string &lock_path, const std::vector<std::string> &keys) {
+  static std::mutex lock;
+  static std::map<std::string, std::unique_ptr<ParamsCache>> caches;
+
+  if (getenv("PARAMS_NO_CACHE")) return nullptr;
+
+  std::lock_guard lk(lock);
+  auto &cache = caches[key_path];
+  if (!cache) {
+    cache.reset(new ParamsCache(key_path, lock_path, keys));
+  }
+  // (re)opened every time, the params directory might have been deleted and created again.
+  // Never freed, Params created earlier may still be using it.
+  cache->dir_valid = cache->open();
+  return cache->dir_valid ? cache.get() : nullptr;
+}
+
+ParamsCache::ParamsCache(const std::string &key_path, const std::string &lock_path, const std::vector<std::string> &keys)
+    : key_path(key_path), lock_path(lock_path), keys(keys) {
+  std::sort(this->keys.begin(), this->keys.end());
+  const uint32_t slot_size = sizeof(ParamsCacheSlot);
+  layout = fnv1a(&slot_size, sizeof(slot_size));
+  for (int i = 0; i < this->keys.size(); ++i) {
+    key_index[this->keys[i]] = i;
+    layout = fnv1a(this->keys[i].c_str(), this->keys[i].size() + 1, layout);
+  }
+}
+
+std::string ParamsCache::shmPath() const {
+  return util::string_format("/dev/shm/.params_cache_%016llx", (unsigned long long)fnv1a(key_path.data(), key_path.size()));
+}
+
+bool ParamsCache::open() {
+  struct stat dir_st;
+  if (stat(key_path.c_str(), &dir_st) != 0) return false;
+  if (header != nullptr) {
+    if (header->disabled) return false;
+    if (header->dir_dev == dir_st.st_dev && header->dir_ino == dir_st.st_ino) return true;
+  }
+
+  // Nobody may change the cache who couldn't change the params themselves,
+  // it is never writable by more than the directory and never by others
+  const mode_t mode = dir_st.st_mode & 0644;
+  const std::string path = shmPath();
+  int fd = HANDLE_EINTR(::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | O_NOFOLLOW, mode));
+  if (fd < 0) return false;
+
+  bool ret = false;
+  do {
+    FdLock cache_lock(fd);
+    const size_t size = sizeof(ParamsCacheHeader) + keys.size() * sizeof(ParamsCacheSlot);
+    struct stat st;
+    if (fstat(fd, &st) != 0) break;
+    if (st.st_uid != geteuid() && st.st_uid != dir_st.st_uid) {
+      LOGW("params cache %s isn't owned by the params owner, not using it", path.c_str());
+      break;
+    }
+    // left world writable by an older version
+    if ((st.st_mode & ~mode & 0777) && fchmod(fd, mode) != 0) break;
+    if (st.st_size != 0 && st.st_size != size) {
+      LOGW("params cache %s has a different key table, disabling it", path.c_str());
+      if (st.st_size >= sizeof(ParamsCacheHeader)) {
+        void *p = mmap(NULL, sizeof(ParamsCacheHeader), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p != MAP_FAILED) {
+          ((ParamsCacheHeader *)p)->disabled = 1;
+          munmap(p, sizeof(ParamsCacheHeader));
+        }
+      }
+      break;
+    }
+    if (st.st_size == 0 && ftruncate(fd, size) != 0) break;
+
+    if (header == nullptr) {
+      void *p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if (p == MAP_FAILED) break;
+      header = (ParamsCacheHeader *)p;
+      slots = (ParamsCacheSlot *)((char *)p + sizeof(ParamsCacheHeader));
+    }
+
+    if (header->magic == PARAMS_CACHE_MAGIC && header->layout != layout) {
+      LOGW("params cache %s has a different key table, disabling it", path.c_str());
+      header->disabled = 1;
+    }
+    if (header->disabled) break;
+
+    if (header->magic != PARAMS_CACHE_MAGIC || header->dir_dev != dir_st.st_dev || header->dir_ino != dir_st.st_ino) {
+      // first user, or the params directory was replaced
+      int lock_fd = HANDLE_EINTR(::open(lock_path.c_str(), O_CREAT | O_CLOEXEC, 0775));
+      if (lock_fd < 0) break;
+      {
+        FdLock params_lock(lock_fd);
+        header->layout = layout;
+        header->dir_dev = dir_st.st_dev;
+        header->dir_ino = dir_st.st_ino;
+        reload();
+        header->magic = PARAMS_CACHE_MAGIC;
+      }
+      close(lock_fd);
+    }
+    ret = true;
+  } while (false);
+
+  close(fd);
+  return ret;
+}
+
+bool ParamsCache::dirValid() {
+  const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  int64_t next = next_dir_check.load(std::memory_order_relaxed);
+  // one thread checks, the others keep the last result
+  if (now < next || !next_dir_check.compare_exchange_strong(next, now + PARAMS_CACHE_DIR_CHECK_MS * 1000000LL, std::memory_order_relaxed)) {
+    return dir_valid.load(std::memory_order_relaxed);
+  }
+  // reloads the cache if the directory was replaced since
+  const bool valid = open();
+  dir_valid.store(valid, std::memory_order_relaxed);
+  return valid;
+}
+
+void ParamsCache::loadSlot(int idx) {
+  std::string value = util::read_file(key_path + "/" + keys[idx]);
+  beginWrite(keys[idx]);
+  setSlot(idx, value.data(), value.size(), true);
+}
+
+void ParamsCache::reload() {
+  for (int i = 0; i < keys.size(); ++i) {
+    loadSlot(i);
+  }
+  notify();
+}
+
+bool ParamsCache::read(int idx, std::string &value) {
+  if (idx < 0 || header->disabled || !dirValid()) return false;
+
+  ParamsCacheSlot &slot = slots[idx];
+  for (int tries = 0; tries < 3; ++tries) {
+    uint32_t seq = slot.seq.load(std::memory_order_acquire);
+    if (seq & 1) {
+      std::this_thread::yield();
+      continue;
+    }
+    uint32_t flags = slot.flags;
+    uint32_t size = std::min<uint32_t>(slot.size, PARAMS_CACHE_VALUE_SIZE);
+    value.assign(slot.value, size);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) == seq) {
+      return !(flags & SLOT_UNCACHED);
+    }
+  }
+  return false;
+}
+
+void ParamsCache::beginWrite(const std::string &key) {
+  int idx = index(key);
+  if (idx < 0) return;
+
+  ParamsCacheSlot &slot = slots[idx];
+  slot.seq.store(slot.seq.load(std::memory_order_relaxed) | 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+void ParamsCache::endWrite(const std::string &key, const char *value, size_t size, bool ok) {
+  int idx = index(key);
+  if (idx < 0) return;
+
+  setSlot(idx, value, size, ok);
+  notify();
+}
+
+void ParamsCache::setSlot(int idx, const char *value, size_t size, bool ok) {
+  ParamsCacheSlot &slot = slots[idx];
+  // a failed write leaves the file in an unknown state
+  if (ok && size <= PARAMS_CACHE_VALUE_SIZE) {
+    slot.flags = 0;
+    slot.size = size;
+    memcpy(slot.value, value, size);
+  } else {
+    slot.flags = SLOT_UNCACHED;
+    slot.size = 0;
+  }
+  slot.seq.store((slot.seq.load(std::memory_order_relaxed) | 1) + 1, std::memory_order_release);
+}
+
+uint32_t ParamsCache::keyVersion(int idx) {
+  return idx < 0 || !dirValid() ? 0 : slots[idx].seq.load(std::memory_order_acquire) >> 1;
+}
+
+void ParamsCache::notify() {
+  uint32_t gen = header->generation.load(std::memory_order_relaxed);
+  while (!header->generation.compare_exchange_weak(gen, (gen + 2) & ~1u, std::memory_order_acq_rel)) {}
+#ifdef __linux__
+  if (gen & 1) {
+    syscall(SYS_futex, &header->generation, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+  }
+#endif
+}
+
+bool ParamsCache::waitForChange(uint32_t generation, int timeout_ms) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  while (true) {
+    // Announce the wait before checking, any change after this point changes the futex word
+    uint32_t val = header->generation.fetch_or(1, std::memory_order_acq_rel) | 1;
+    if ((val >> 1) != generation) return true;
+
+    auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) return false;
+#ifdef __linux__
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now).count();
+    struct timespec ts = {.tv_sec = ns / 1000000000, .tv_nsec = ns % 1000000000};
+    syscall(SYS_futex, &header->generation, FUTEX_WAIT, val, &ts, NULL, 0);
+#else
+    util::sleep_for(std::min(10, timeout_ms));
+#endif
+  }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Shared memory snapshot of a params directory, so reads don't have to open/read/close a file.
+// One slot per known key, each a seqlock: readers never block, and fall back to the file when
+// a slot is being written, or was left half written by a writer that died. Params::put/remove
+// update the slot while holding the params lock, right after the file is moved into place.
+// Values that don't fit in a slot are always read from the file.
+#define PARAMS_CACHE_MAGIC 0x50434348u
+#define PARAMS_CACHE_VALUE_SIZE 244
+#define PARAMS_CACHE_DIR_CHECK_MS 100
+
+struct alignas(64) ParamsCacheHeader {
+  uint32_t magic;  // set once the slots are populated
+  uint32_t disabled;  // set by a process with a different key table, everyone reads files then
+  uint64_t layout;
+  dev_t dir_dev;
+  ino_t dir_ino;
+  // bumped by 2 on every change, the low bit is set while someone waits for a change
+  std::atomic<uint32_t> generation;
+};
+
+struct alignas(64) ParamsCacheSlot {
+  std::atomic<uint32_t> seq;  // odd while the slot is written
+  uint32_t flags;
+  uint32_t size;
+  char value[PARAMS_CACHE_VALUE_SIZE];
+};
+
+class ParamsCache {
+public:
+  // Returns the process wide cache of the params in key_path, nullptr if it's not available.
+  // lock_path is the params lock, held while the cache is populated.
+  static ParamsCache *get(const std::string &key_path, const std::string &lock_path, const std::vector<std::string> &keys);
+
+  // Index of the key's slot, -1 if the key is unknown. Lets hot paths skip the lookup.
+  int index(const std::string &key) const {
+    auto it = key_index.find(key);
+    return it == key_index.end() ? -1 : it->second;
+  }
+
+  // Returns false if the value has to be read from the file. Also false while the params directory
+  // is missing, and a replaced directory is loaded again, both noticed within PARAMS_CACHE_DIR_CHECK_MS.
+  bool read(const std::string &key, std::string &value) { return read(index(key), value); }
+  bool read(int idx, std::string &value);
+  // Writes are serialized by the params lock. The slot is marked as being written until
+  // endWrite, so a writer dying in between leaves it uncached instead of stale.
+  void beginWrite(const std::string &key);
+  void endWrite(const std::string &key, const char *value, size_t size, bool ok = true);
+  // Reloads all slots from the files, for when they were changed behind our back
+  void reload();
+
+  uint32_t generation() const { return header->generation.load(std::memory_order_acquire) >> 1; }
+  bool waitForChange(uint32_t generation, int timeout_ms);
+  // Changes every time the key is written
+  uint32_t keyVersion(const std::string &key) { return keyVersion(index(key)); }
+  uint32_t keyVersion(int idx);
+
+private:
+  ParamsCache(const std::string &key_path, const std::string &lock_path, const std::vector<std::string> &keys);
+  std::string shmPath() const;
+  bool open();
+  bool dirValid();
+  void loadSlot(int idx);
+  void setSlot(int idx, const char *value, size_t size, bool ok);
+  void notify();
+
+  std::string key_path, lock_path;
+  std::vector<std::string> keys;
+  std::unordered_map<std::string, int> key_index;
+  uint64_t layout;
+  ParamsCacheHeader *header = nullptr;
+  ParamsCacheSlot *slots = nullptr;
+  // long lived Params keep using the cache, the directory is checked again every now and then
+  std::atomic<int64_t> next_dir_check = 0;
+  std::atomic<bool> dir_valid = true;
+};
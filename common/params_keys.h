@@ -0,0 +1,389 @@
+// Key table of Params, expanded into the ParamKey enum and the PARAM_KEYS table in params.h.
+// PARAM(name, flags, type): flags is a combination of ParamKeyType, type the ParamValueType
+// the typed accessors decode the value as.
+// No include guard, this file is meant to be included multiple times.
+
+PARAM(AccessToken, CLEAR_ON_MANAGER_START | DONT_LOG, STRING)
+PARAM(ApiCache_Device, PERSISTENT, STRING)
+PARAM(ApiCache_NavDestinations, PERSISTENT, STRING)
+PARAM(AssistNowToken, PERSISTENT, STRING)
+PARAM(AthenadPid, PERSISTENT, INT)
+PARAM(AthenadUploadQueue, PERSISTENT, STRING)
+PARAM(AthenadRecentlyViewedRoutes, PERSISTENT, STRING)
+PARAM(BootCount, PERSISTENT, INT)
+PARAM(CalibrationParams, PERSISTENT, BLOB)
+PARAM(CameraDebugExpGain, CLEAR_ON_MANAGER_START, STRING)
+PARAM(CameraDebugExpTime, CLEAR_ON_MANAGER_START, STRING)
+PARAM(CarBatteryCapacity, PERSISTENT, INT)
+PARAM(CarParams, CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION, BLOB)
+PARAM(CarParamsCache, CLEAR_ON_MANAGER_START, BLOB)
+PARAM(CarParamsPersistent, PERSISTENT, BLOB)
+PARAM(CarParamsPrevRoute, PERSISTENT, BLOB)
+PARAM(CarVin, CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION, STRING)
+PARAM(CompletedTrainingVersion, PERSISTENT, STRING)
+PARAM(ControlsReady, CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION, BOOL)
+PARAM(CurrentBootlog, PERSISTENT, STRING)
+PARAM(CurrentRoute, CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION, STRING)
+PARAM(DisableLogging, CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION, BOOL)
+PARAM(DisablePowerDown, PERSISTENT, BOOL)
+PARAM(DisableUpdates, PERSISTENT, BOOL)
+PARAM(DisengageOnAccelerator, PERSISTENT | FROGPILOT_STORAGE, BOOL)
+PARAM(DmModelInitialized, CLEAR_ON_ONROAD_TRANSITION, BOOL)
+PARAM(DongleId, PERSISTENT, STRING)
+PARAM(DoReboot, CLEAR_ON_MANAGER_START, BOOL)
+PARAM(DoShutdown, CLEAR_ON_MANAGER_START, BOOL)
+PARAM(DoUninstall, CLEAR_ON_MANAGER_START, BOOL)
+PARAM(ExperimentalLongitudinalEnabled, PERSISTENT | DEVELOPMENT_ONLY | FROGPILOT_STORAGE, BOOL)
+PARAM(ExperimentalMode, PERSISTENT | FROGPILOT_STORAGE, BOOL)
+PARAM(ExperimentalModeConfirmed, PERSISTENT, BOOL)
+PARAM(FirmwareQueryDone, CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION, BOOL)
+PARAM(ForcePowerDown, PERSISTENT, BOOL)
+PARAM(GitBranch, PERSISTENT, STRING)
+PARAM(GitCommit, PERSISTENT, STRING)
+PARAM(GitCommitDate, PERSISTENT, STRING)
+PARAM(GitDiff, PERSISTENT, STRING)
+PARAM(GithubSshKeys, PERSISTENT, STRING)
+PARAM(GithubUsername, PERSISTENT, STRING)
+PARAM(GitRemote, PERSISTENT, STRING)
+PARAM(GsmApn, PERSISTENT, STRING)
+PARAM(GsmMetered, PERSISTENT | FROGPILOT_STORAGE, BOOL)
+PARAM(GsmRoaming, PERSISTENT | FROGPILOT_STORAGE, BOOL)
+PARAM(HardwareSerial, PERSISTENT, STRING)
+PARAM(HasAcceptedTerms, PERSISTENT, BOOL)
+PARAM(IMEI, PERSISTENT, STRING)
+PARAM(InstallDate, PERSISTENT, STRING)
+PARAM(IsDriverViewEnabled, CLEAR_ON_MANAGER_START, BOOL)
+PARAM(IsEngaged, PERSISTENT, BOOL)
+PARAM(IsLdwEnabled, PERSISTENT | FROGPILOT_STORAGE, BOOL)
+PARAM(IsMetric, PERSISTENT | FROGPILOT_STORAGE, BOOL)
+PARAM(IsOffroad, CLEAR_ON_MANAGER_START, BOOL)
+PARAM(IsOnroad, PERSISTENT, BOOL)
+PARAM(IsRhdDetected, PERSISTENT, BOOL)
+PARAM(IsReleaseBranch, CLEAR_ON_MANAGER_START, BOOL)
+PARAM(IsTakingSnapshot, CLEAR_ON_MANAGER_START, BOOL)
+PARAM(IsTestedBranch, CLEAR_ON_MANAGER_START, BOOL)
+PARAM(JoystickDebugMode, CLEAR_ON_MANAGER_START | CLEAR_ON_OFFROAD_TRANSITION, BOOL)
+PARAM(LanguageSetting, PERSISTENT, STRING)
+PARAM(LastAthenaPingTime, CLEAR_ON_MANAGER_START, STRING)
+PARAM(LastGPSPosition, PERSISTENT, STRING)
+PARAM(LastManagerExitReason, CLEAR_ON_MANAGER_START, STRING)
+PARAM(LastOffroadStatusPacket, CLEAR_ON_MANAGER_START | CLEAR_ON_OFFROAD_TRANSITION, STRING)
+PARAM(LastPowerDropDetected, CLEAR_ON_MANAGER_START, STRING)
+PARAM(LastUpdateException, CLEAR_ON_MANAGER_START, STRING)
+PARAM(LastUpdateTime, PERSISTENT, STRING)
+PARAM(LiveParameters, PERSISTENT, STRING)
+PARAM(LiveTorqueParameters, PERSISTENT | DONT_LOG, BLOB)
+PARAM(LongitudinalPersonality, PERSISTENT, INT)
+PARAM(NavDestination, CLEAR_ON_MANAGER_START | CLEAR_ON_OFFROAD_TRANSITION, STRING)
+PARAM(NavDestinationWaypoints, CLEAR_ON_MANAGER_START | CLEAR_ON_OFFROAD_TRANSITION, STRING)
+PARAM(NavPastDestinations, PERSISTENT, STRING)
+PARAM(NavSettingLeftSide, PERSISTENT | FROGPILOT_STORAGE, BOOL)
+PARAM(NavSettingTime24h, PERSISTENT | FROGPILOT_STORAGE, BOOL)
+PARAM(NetworkMetered, PERSISTENT, BOOL)
+PARAM(ObdMultiplexingChanged, CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION, BOOL)
+PARAM(ObdMultiplexingEnabled, CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION, BOOL)
+PARAM(Offroad_BadNvme, CLEAR_ON_MANAGER_START, STRING)
+PARAM(Offroad_CarUnrecognized, CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION, STRING)
+PARAM(Offroad_ConnectivityNeeded, CLEAR_ON_MANAGER_START, STRING)
+PARAM(Offroad_ConnectivityNeededPrompt, CLEAR_ON_MANAGER_START, STRING)
+PARAM(Offroad_InvalidTime, CLEAR_ON_MANAGER_START, STRING)
+PARAM(Offroad_IsTakingSnapshot, CLEAR_ON_MANAGER_START, STRING)
+PARAM(Offroad_NeosUpdate, CLEAR_ON_MANAGER_START, STRING)
+PARAM(Offroad_NoFirmware, CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION, STRING)
+PARAM(Offroad_Recalibration, CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION, STRING)
+PARAM(Offroad_StorageMissing, CLEAR_ON_MANAGER_START, STRING)
+PARAM(Offroad_TemperatureTooHigh, CLEAR_ON_MANAGER_START, STRING)
+PARAM(Offroad_UnofficialHardware, CLEAR_ON_MANAGER_START, STRING)
+PARAM(Offroad_UpdateFailed, CLEAR_ON_MANAGER_START, STRING)
+PARAM(OpenpilotEnabledToggle, PERSISTENT | FROGPILOT_STORAGE, BOOL)
+PARAM(PandaHeartbeatLost, CLEAR_ON_MANAGER_START | CLEAR_ON_OFFROAD_TRANSITION, BOOL)
+PARAM(PandaSomResetTriggered, CLEAR_ON_MANAGER_START | CLEAR_ON_OFFROAD_TRANSITION, BOOL)
+PARAM(PandaSignatures, CLEAR_ON_MANAGER_START, BLOB)
+PARAM(PrimeType, PERSISTENT, INT)
+PARAM(RecordFront, PERSISTENT | FROGPILOT_STORAGE, BOOL)
+PARAM(RecordFrontLock, PERSISTENT, BOOL)  // for the internal fleet
+PARAM(ReplayControlsState, CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION, BLOB)
+PARAM(RouteCount, PERSISTENT, INT)
+PARAM(SnoozeUpdate, CLEAR_ON_MANAGER_START | CLEAR_ON_OFFROAD_TRANSITION, BOOL)
+PARAM(SshEnabled, PERSISTENT | FROGPILOT_STORAGE, BOOL)
+PARAM(TermsVersion, PERSISTENT, STRING)
+PARAM(Timezone, PERSISTENT, STRING)
+PARAM(TrainingVersion, PERSISTENT, STRING)
+PARAM(UbloxAvailable, PERSISTENT, BOOL)
+PARAM(UpdateAvailable, CLEAR_ON_MANAGER_START | CLEAR_ON_ONROAD_TRANSITION, BOOL)
+PARAM(UpdateFailedCount, CLEAR_ON_MANAGER_START, INT)
+PARAM(UpdaterAvailableBranches, PERSISTENT, STRING)
+PARAM(UpdaterCurrentDescription, CLEAR_ON_MANAGER_START, STRING)
+PARAM(UpdaterCurrentReleaseNotes, CLEAR_ON_MANAGER_START, STRING)
+PARAM(UpdaterFetchAvailable, CLEAR_ON_MANAGER_START, BOOL)
+PARAM(UpdaterNewDescription, CLEAR_ON_MANAGER_START, STRING)
+PARAM(UpdaterNewReleaseNotes, CLEAR_ON_MANAGER_START, STRING)
+PARAM(UpdaterState, CLEAR_ON_MANAGER_START, STRING)
+PARAM(UpdaterTargetBranch, CLEAR_ON_MANAGER_START, STRING)
+PARAM(UpdaterLastFetchTime, PERSISTENT, STRING)
+PARAM(Version, PERSISTENT, STRING)
+
+PARAM(AutoNaviSpeedCtrlStart, PERSISTENT, FLOAT)
+PARAM(AutoNaviSpeedCtrlEnd, PERSISTENT, FLOAT)
+
+// FrogPilot parameters
+PARAM(AccelerationPath, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(AccelerationProfile, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(AdjacentPath, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(AdjacentPathMetrics, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(AggressiveAcceleration, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(AggressiveAccelerationExperimental, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(AggressiveFollow, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, FLOAT)
+PARAM(AggressiveJerkAcceleration, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(AggressiveJerkSpeed, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(AggressivePersonalityProfile, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(AlertVolumeControl, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(AlwaysOnLateral, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(AlwaysOnLateralMain, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(AMapKey1, PERSISTENT, STRING)
+PARAM(AMapKey2, PERSISTENT, STRING)
+PARAM(ApiCache_DriveStats, PERSISTENT, STRING)
+PARAM(AutomaticUpdates, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_OTHER, BOOL)
+PARAM(AvailableModels, PERSISTENT, STRING)
+PARAM(AvailableModelsNames, PERSISTENT, STRING)
+PARAM(BorderMetrics, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(BigMap, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(BlindSpotMetrics, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(BlindSpotPath, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(CameraFPS, PERSISTENT, INT)
+PARAM(CameraView, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, INT)
+PARAM(CarMake, PERSISTENT, STRING)
+PARAM(CarModel, PERSISTENT, STRING)
+PARAM(CECurves, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(CECurvesLead, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(CENavigation, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(CENavigationIntersections, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(CENavigationLead, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(CENavigationTurns, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(CESignal, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(CESlowerLead, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(CESpeed, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(CESpeedLead, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(CEStatus, PERSISTENT, INT)
+PARAM(CEStopLights, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(CEStopLightsLead, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(ClusterOffset, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES, FLOAT)
+PARAM(Compass, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(ConditionalExperimental, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(CrosstrekTorque, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES, BOOL)
+PARAM(CurrentHolidayTheme, PERSISTENT, INT)
+PARAM(CurrentRandomEvent, PERSISTENT, INT)
+PARAM(CurveSensitivity, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(CustomAlerts, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(CustomColors, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, INT)
+PARAM(CustomCruise, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(CustomCruiseLong, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(CustomIcons, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, INT)
+PARAM(CustomPaths, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(CustomPersonalities, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(CustomUI, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(CustomSignals, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, INT)
+PARAM(CustomSounds, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, INT)
+PARAM(CustomTheme, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(CydiaTune, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES, BOOL)
+PARAM(DecelerationProfile, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(DeveloperUI, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(DeviceManagement, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(DeviceShutdown, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(DisableMTSCSmoothing, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(DisableOnroadUploads, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(DisableOpenpilotLongitudinal, PERSISTENT | FROGPILOT_STORAGE, BOOL)
+PARAM(DisableVTSCSmoothing, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(DisengageVolume, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, INT)
+PARAM(DoToggleReset, PERSISTENT, BOOL)
+PARAM(DragonPilotTune, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES, BOOL)
+PARAM(DriverCamera, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(DrivingPersonalities, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(DynamicPathWidth, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(DynamicPedalsOnUI, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(EngageVolume, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, INT)
+PARAM(ExperimentalModeActivation, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(ExperimentalModeViaDistance, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(ExperimentalModeViaLKAS, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(ExperimentalModeViaTap, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(Fahrenheit, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(FingerprintLogged, PERSISTENT, BOOL)
+PARAM(ForceAutoTune, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(ForceFingerprint, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES, BOOL)
+PARAM(ForceMPHDashboard, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(FPSCounter, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(FrogPilotDrives, PERSISTENT | FROGPILOT_TRACKING, INT)
+PARAM(FrogPilotKilometers, PERSISTENT | FROGPILOT_TRACKING, FLOAT)
+PARAM(FrogPilotMinutes, PERSISTENT | FROGPILOT_TRACKING, FLOAT)
+PARAM(FrogPilotTogglesUpdated, PERSISTENT, BOOL)
+PARAM(FrogsGoMoo, PERSISTENT, BOOL)
+PARAM(FrogsGoMooTune, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES, BOOL)
+PARAM(FullMap, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(GasRegenCmd, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES, BOOL)
+PARAM(GMapKey, PERSISTENT, STRING)
+PARAM(GoatScream, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(GreenLightAlert, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(HideAlerts, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(HideAOLStatusBar, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(HideCEMStatusBar, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(HideDisableOpenpilotLongitudinal, PERSISTENT, BOOL)
+PARAM(HideLeadMarker, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(HideMapIcon, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(HideMaxSpeed, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(HideSpeed, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(HideSpeedUI, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(HideUIElements, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(HolidayThemes, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(IncreaseThermalLimits, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(KaofuiIcons, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(LaneChangeCustomizations, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(LaneChangeTime, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(LaneDetectionWidth, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(LaneLinesWidth, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, INT)
+PARAM(LastMapsUpdate, PERSISTENT | FROGPILOT_OTHER, STRING)
+PARAM(LateralMetrics, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(LateralTune, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(LeadDepartingAlert, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(LeadDetectionThreshold, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(LockDoors, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES, BOOL)
+PARAM(LongitudinalMetrics, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(LongitudinalTune, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(LongPitch, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES, BOOL)
+PARAM(LoudBlindspotAlert, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(LowVoltageShutdown, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, FLOAT)
+PARAM(ManualUpdateInitiated, PERSISTENT, BOOL)
+PARAM(MapboxPublicKey, PERSISTENT, STRING)
+PARAM(MapboxSecretKey, PERSISTENT, STRING)
+PARAM(MapAcceleration, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(MapDeceleration, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(MapGears, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(MapsSelected, PERSISTENT | FROGPILOT_OTHER, STRING)
+PARAM(MapSpeedLimit, PERSISTENT, FLOAT)
+PARAM(MapStyle, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, INT)
+PARAM(MapTargetLatA, PERSISTENT, FLOAT)
+PARAM(MapTargetVelocities, PERSISTENT, STRING)
+PARAM(MinimumLaneChangeSpeed, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(Model, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, STRING)
+PARAM(ModelDownloadProgress, PERSISTENT, INT)
+PARAM(ModelName, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, STRING)
+PARAM(ModelSelector, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(ModelToDownload, PERSISTENT, STRING)
+PARAM(ModelUI, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(MTSCAggressiveness, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(MTSCCurvatureCheck, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(MTSCEnabled, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(NNFF, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(NNFFLite, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(NNFFModelName, PERSISTENT, STRING)
+PARAM(NoLogging, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(NoUploads, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(NudgelessLaneChange, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(NumericalTemp, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(OfflineMode, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(Offset1, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(Offset2, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(Offset3, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(Offset4, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(OneLaneChange, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(OnroadDistanceButton, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(OnroadDistanceButtonPressed, PERSISTENT, BOOL)
+PARAM(OSMDownloadBounds, PERSISTENT, STRING)
+PARAM(OSMDownloadLocations, PERSISTENT, STRING)
+PARAM(OSMDownloadProgress, CLEAR_ON_MANAGER_START, STRING)
+PARAM(ParamConversionVersion, PERSISTENT, INT)
+PARAM(PathEdgeWidth, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, INT)
+PARAM(PathWidth, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, INT)
+PARAM(PauseAOLOnBrake, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(PauseLateralOnSignal, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(PauseLateralSpeed, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(PedalsOnUI, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(PreferredSchedule, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_OTHER, INT)
+PARAM(PreviousSpeedLimit, PERSISTENT, FLOAT)
+PARAM(PromptDistractedVolume, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, INT)
+PARAM(PromptVolume, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, INT)
+PARAM(QOLControls, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(QOLVisuals, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(RandomEvents, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(RefuseVolume, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, INT)
+PARAM(RelaxedFollow, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, FLOAT)
+PARAM(RelaxedJerkAcceleration, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(RelaxedJerkSpeed, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(RelaxedPersonalityProfile, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(ResetSteerRatio, PERSISTENT, BOOL)
+PARAM(ReverseCruise, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(ReverseCruiseUI, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(RoadEdgesWidth, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, INT)
+PARAM(RoadName, PERSISTENT, STRING)
+PARAM(RoadNameUI, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(RotatingWheel, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(ScreenBrightness, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, INT)
+PARAM(ScreenBrightnessOnroad, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, INT)
+PARAM(ScreenManagement, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(ScreenRecorder, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(ScreenTimeout, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, INT)
+PARAM(ScreenTimeoutOnroad, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, INT)
+PARAM(SearchInput, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_OTHER, INT)
+PARAM(SetSpeedLimit, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(SetSpeedOffset, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(ShowCPU, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(ShowGPU, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(ShowIP, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(ShowMemoryUsage, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(ShowSLCOffset, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(ShowSLCOffsetUI, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(ShowSteering, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(ShowStorageLeft, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(ShowStorageUsed, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(Sidebar, PERSISTENT | FROGPILOT_OTHER, BOOL)
+PARAM(SidebarMetrics, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(SignalMetrics, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(SLCConfirmation, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(SLCConfirmationLower, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(SLCConfirmationHigher, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(SLCConfirmed, PERSISTENT, BOOL)
+PARAM(SLCConfirmedPressed, PERSISTENT, BOOL)
+PARAM(SLCLookaheadHigher, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(SLCLookaheadLower, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(SLCFallback, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(SLCOverride, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(SLCPriority, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, STRING)
+PARAM(SLCPriority1, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, STRING)
+PARAM(SLCPriority2, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, STRING)
+PARAM(SLCPriority3, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, STRING)
+PARAM(SmoothBraking, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(SmoothBrakingFarLead, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(SmoothBrakingJerk, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(SNGHack, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES, BOOL)
+PARAM(SpeedLimitController, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(SpeedLimitChangedAlert, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(StandardFollow, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, FLOAT)
+PARAM(StandardJerkAcceleration, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(StandardJerkSpeed, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(StandardPersonalityProfile, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(StandbyMode, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(StaticPedalsOnUI, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(SteerRatio, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, FLOAT)
+PARAM(SteerRatioStock, PERSISTENT, FLOAT)
+PARAM(StockTune, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES, BOOL)
+PARAM(StoppingDistance, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(TacoTune, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(TetheringEnabled, PERSISTENT | FROGPILOT_OTHER, BOOL)
+PARAM(ToyotaDoors, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES, BOOL)
+PARAM(TrafficFollow, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, FLOAT)
+PARAM(TrafficJerkAcceleration, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(TrafficJerkSpeed, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(TrafficMode, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(TrafficModeActive, CLEAR_ON_OFFROAD_TRANSITION, BOOL)
+PARAM(TrafficPersonalityProfile, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(TurnAggressiveness, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, INT)
+PARAM(TurnDesires, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(UnlimitedLength, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(UnlockDoors, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VEHICLES, BOOL)
+PARAM(Updated, PERSISTENT, STRING)
+PARAM(UseSI, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
+PARAM(UseVienna, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(VisionTurnControl, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_CONTROLS, BOOL)
+PARAM(WarningImmediateVolume, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, INT)
+PARAM(WarningSoftVolume, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, INT)
+PARAM(WheelIcon, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, INT)
+PARAM(WheelSpeed, PERSISTENT | FROGPILOT_STORAGE | FROGPILOT_VISUALS, BOOL)
@@ -31,6 +31,7 @@ cdef extern from "common/params.h":
     void putBoolNonBlocking(string, bool) nogil
     void putIntNonBlocking(string, int) nogil
     void putFloatNonBlocking(string, float) nogil
+    void flush() nogil
     int putBool(string, bool) nogil
     int putInt(string, int) nogil
     int putFloat(string, float) nogil
@@ -39,6 +40,8 @@ cdef extern from "common/params.h":
     void clearAll(ParamKeyType)
     vector[string] allKeys()
     ParamKeyType getKeyType(string) nogil
+    unsigned int generation() nogil
+    bool waitForChange(unsigned int, int) nogil
 
 
 def ensure_bytes(v):
@@ -152,6 +155,11 @@ cdef class Params:
     with nogil:
       self.p.putFloatNonBlocking(k, val)
 
+  def flush(self):
+    """Waits until every nonblocking put queued so far is on disk"""
+    with nogil:
+      self.p.flush()
+
   def remove(self, key):
     cdef string k = self.check_key(key)
     with nogil:
@@ -167,3 +175,12 @@ cdef class Params:
   def get_key_type(self, key):
     cdef string k = self.check_key(key)
     return self.p.getKeyType(k)
+
+  def generation(self):
+    return self.p.generation()
+
+  def wait_for_change(self, unsigned int generation, int timeout_ms):
+    cdef bool r
+    with nogil:
+      r = self.p.waitForChange(generation, timeout_ms)
+    return r
@@ -0,0 +1,57 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "common/params.h"
+#include "common/timing.h"
+#include "common/util.h"
+
+// Reads a UI sized set of toggles through the shared memory cache and through the files.
+// usage: params_bench [rounds]
+
+static double read_toggles(const std::string &path, const std::vector<std::string> &keys, int rounds) {
+  Params params(path);
+  int enabled = 0;
+  double start = millis_since_boot();
+  for (int i = 0; i < rounds; ++i) {
+    for (auto &key : keys) {
+      enabled += params.getBool(key);
+    }
+  }
+  double us = (millis_since_boot() - start) * 1000.0 / (rounds * keys.size());
+  if (enabled != rounds * ((keys.size() + 1) / 2)) {
+    printf("unexpected values read\n");
+    exit(1);
+  }
+  return us;
+}
+
+int main(int argc, char *argv[]) {
+  const int rounds = argc > 1 ? atoi(argv[1]) : 1000;
+
+  char tmp_path[] = "/tmp/params_bench_XXXXXX";
+  const std::string path = mkdtemp(tmp_path);
+
+  // about what the UI reads every time the FrogPilot toggles change
+  std::vector<std::string> keys;
+  {
+    Params params(path);
+    for (auto &key : params.allKeys()) {
+      if ((params.getKeyType(key) & FROGPILOT_VISUALS) && keys.size() < 100) {
+        keys.push_back(key);
+        params.putBool(key, keys.size() % 2);
+      }
+    }
+  }
+
+  double cache_us = read_toggles(path, keys, rounds);
+  setenv("PARAMS_NO_CACHE", "1", 1);
+  double file_us = read_toggles(path, keys, rounds);
+
+  printf("%zu keys x %d rounds\n", keys.size(), rounds);
+  printf("%-8s %10.2f us/get\n", "cache", cache_us);
+  printf("%-8s %10.2f us/get\n", "files", file_us);
+  printf("%.1fx faster\n", file_us / cache_us);
+  return 0;
+}
@@ -1,6 +1,12 @@
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include <type_traits>
+
 #include "catch2/catch.hpp"
 #define private public
 #include "common/params.h"
+#include "common/params_cache.h"
 #include "common/util.h"
 
 TEST_CASE("params_nonblocking_put") {
@@ -25,3 +31,165 @@ TEST_CASE("params_nonblocking_put") {
     REQUIRE(p.get(name) == "1");
   }
 }
+
+TEST_CASE("params_cache") {
+  char tmp_path[] = "/tmp/paramsCache_XXXXXX";
+  const std::string param_path = mkdtemp(tmp_path);
+  Params writer(param_path), reader(param_path);
+  REQUIRE(reader.cache != nullptr);
+
+  uint32_t gen = reader.generation();
+  uint32_t version = reader.keyVersion("IsMetric");
+  writer.putBool("IsMetric", true);
+  REQUIRE(reader.generation() != gen);
+  REQUIRE(reader.keyVersion("IsMetric") != version);
+  REQUIRE(reader.getBool("IsMetric"));
+
+  // served from the cache
+  std::string value;
+  REQUIRE(reader.cache->read("IsMetric", value));
+  REQUIRE(value == "1");
+
+  // too large for a slot, read from the file
+  const std::string large(PARAMS_CACHE_VALUE_SIZE + 1, 'x');
+  writer.put("CarParams", large);
+  REQUIRE(!reader.cache->read("CarParams", value));
+  REQUIRE(reader.get("CarParams") == large);
+
+  writer.remove("IsMetric");
+  REQUIRE(reader.get("IsMetric").empty());
+
+  writer.putBool("IsMetric", true);
+  writer.clearAll(ALL);
+  REQUIRE(reader.get("IsMetric").empty());
+
+  // written behind the cache's back
+  util::write_file(reader.getParamPath("IsMetric").c_str(), "1", 1, O_WRONLY | O_CREAT | O_TRUNC);
+  REQUIRE(reader.get("IsMetric").empty());
+  reader.reloadCache();
+  REQUIRE(reader.getBool("IsMetric"));
+
+  // a writer that died while writing the slot leaves it uncached
+  reader.cache->beginWrite("IsMetric");
+  REQUIRE(!reader.cache->read("IsMetric", value));
+  REQUIRE(reader.getBool("IsMetric"));
+  writer.putBool("IsMetric", false);
+  REQUIRE(!reader.getBool("IsMetric"));
+}
+
+TEST_CASE("params_cache_directory_replaced") {
+  char tmp_path[] = "/tmp/paramsCacheReplaced_XXXXXX";
+  const std::string param_path = mkdtemp(tmp_path);
+  Params params(param_path);
+  params.putBool("IsMetric", false);
+  REQUIRE(!params.getBool("IsMetric"));
+
+  // the cache is never writable by others
+  struct stat st;
+  REQUIRE(stat(params.cache->shmPath().c_str(), &st) == 0);
+  REQUIRE((st.st_mode & 0022) == 0);
+
+  // the directory is replaced behind the cache's back, e.g. restored from a backup
+  const std::string new_dir = param_path + "/.restored";
+  REQUIRE(util::create_directories(new_dir, 0775));
+  util::write_file((new_dir + "/IsMetric").c_str(), "1", 1, O_WRONLY | O_CREAT | O_TRUNC);
+  REQUIRE(symlink(new_dir.c_str(), (param_path + "/.restored.link").c_str()) == 0);
+  REQUIRE(rename((param_path + "/.restored.link").c_str(), params.getParamPath().c_str()) == 0);
+  util::sleep_for(PARAMS_CACHE_DIR_CHECK_MS * 2);
+  REQUIRE(params.getBool("IsMetric"));
+
+  // a long lived Params notices the directory was deleted
+  REQUIRE(system(("rm -rf " + param_path).c_str()) == 0);
+  util::sleep_for(PARAMS_CACHE_DIR_CHECK_MS * 2);
+  REQUIRE(!params.getBool("IsMetric"));
+  REQUIRE(params.get("IsMetric").empty());
+}
+
+TEST_CASE("params_cache_wait_for_change") {
+  char tmp_path[] = "/tmp/paramsCacheWait_XXXXXX";
+  const std::string param_path = mkdtemp(tmp_path);
+  Params params(param_path);
+
+  uint32_t gen = params.generation();
+  REQUIRE(!params.waitForChange(gen, 10));
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    util::sleep_for(100);
+    Params(param_path).put("DongleId", "cb38263377b873ee");
+    _exit(0);
+  }
+  REQUIRE(params.waitForChange(gen, 5000));
+  REQUIRE(params.get("DongleId") == "cb38263377b873ee");
+  waitpid(pid, nullptr, 0);
+}
+
+TEST_CASE("params_nonblocking_group_commit") {
+  char tmp_path[] = "/tmp/asyncWriterBatch_XXXXXX";
+  const std::string param_path = mkdtemp(tmp_path);
+  Params params(param_path);
+
+  // only the last value of each key is written
+  for (int i = 0; i < 100; ++i) {
+    params.putIntNonBlocking("BootCount", i);
+    params.putBoolNonBlocking("IsMetric", i % 2);
+  }
+  params.flush();
+  REQUIRE(params.queue.empty());
+  REQUIRE(params.getInt("BootCount") == 99);
+  REQUIRE(params.getBool("IsMetric"));
+  REQUIRE(util::read_file(params.getParamPath("BootCount")) == "99");
+
+  // flush is a barrier for puts queued right after the writer thread finished
+  params.putNonBlocking("DongleId", "a");
+  params.flush();
+  params.putNonBlocking("DongleId", "b");
+  params.flush();
+  REQUIRE(params.get("DongleId") == "b");
+}
+
+TEST_CASE("params_typed_get") {
+  char tmp_path[] = "/tmp/paramsTyped_XXXXXX";
+  const std::string param_path = mkdtemp(tmp_path);
+  Params params(param_path);
+
+  static_assert(std::is_same_v<decltype(params.get<ParamKey::IsMetric>()), bool>);
+  static_assert(std::is_same_v<decltype(params.get<ParamKey::CESpeed>()), int>);
+  static_assert(std::is_same_v<decltype(params.get<ParamKey::SteerRatio>()), float>);
+  static_assert(std::is_same_v<decltype(params.get<ParamKey::DongleId>()), std::string>);
+  REQUIRE(std::string(paramKeyInfo(ParamKey::IsMetric).name) == "IsMetric");
+  REQUIRE(params.getKeyType("AccessToken") == (CLEAR_ON_MANAGER_START | DONT_LOG));
+
+  // unset values decode like the string accessors
+  REQUIRE(!params.get<ParamKey::IsMetric>());
+  REQUIRE(params.get<ParamKey::CESpeed>() == 0);
+  REQUIRE(params.get<ParamKey::SteerRatio>() == 0.0f);
+
+  params.putBool("IsMetric", true);
+  params.putInt("CESpeed", 42);
+  params.putFloat("SteerRatio", 15.5);
+  params.put("DongleId", "cb38263377b873ee");
+  REQUIRE(params.get<ParamKey::IsMetric>());
+  REQUIRE(params.get<ParamKey::CESpeed>() == 42);
+  REQUIRE(params.get<ParamKey::SteerRatio>() == 15.5f);
+  REQUIRE(params.get<ParamKey::DongleId>() == "cb38263377b873ee");
+
+  // the decoded value is dropped once the key is written by someone else
+  REQUIRE(params.get<ParamKey::CESpeed>() == 42);
+  Params(param_path).putInt("CESpeed", 43);
+  REQUIRE(params.get<ParamKey::CESpeed>() == 43);
+  Params(param_path).remove("IsMetric");
+  REQUIRE(!params.get<ParamKey::IsMetric>());
+
+  // malformed numbers decode as the default, trailing whitespace is fine
+  params.put("CESpeed", "12abc");
+  REQUIRE(params.get<ParamKey::CESpeed>() == 0);
+  params.put("CESpeed", "99999999999");
+  REQUIRE(params.get<ParamKey::CESpeed>() == 0);
+  params.put("CESpeed", "12\n");
+  REQUIRE(params.get<ParamKey::CESpeed>() == 12);
+  params.put("SteerRatio", "15.5x");
+  REQUIRE(params.get<ParamKey::SteerRatio>() == 0.0f);
+  params.put("SteerRatio", " ");
+  REQUIRE(params.get<ParamKey::SteerRatio>() == 0.0f);
+}
@@ -25,15 +25,20 @@
 
 void init_crc_lookup_tables();
 
+// On-disk cache of parsed DBCs, keyed by a hash of the DBC file and its checksum settings
+uint64_t dbc_cache_key(const std::string &dbc_name, const std::string &content, const ChecksumState *checksum);
+DBC *dbc_cache_load(const std::string &dbc_name, uint64_t key, const ChecksumState *checksum);
+void dbc_cache_store(const std::string &dbc_name, uint64_t key, const DBC &dbc);
+
 // Car specific functions
-unsigned int honda_checksum(uint32_t address, const Signal &sig, const std::vector<uint8_t> &d);
-unsigned int toyota_checksum(uint32_t address, const Signal &sig, const std::vector<uint8_t> &d);
-unsigned int subaru_checksum(uint32_t address, const Signal &sig, const std::vector<uint8_t> &d);
-unsigned int chrysler_checksum(uint32_t address, const Signal &sig, const std::vector<uint8_t> &d);
-unsigned int volkswagen_mqb_checksum(uint32_t address, const Signal &sig, const std::vector<uint8_t> &d);
-unsigned int xor_checksum(uint32_t address, const Signal &sig, const std::vector<uint8_t> &d);
-unsigned int hkg_can_fd_checksum(uint32_t address, const Signal &sig, const std::vector<uint8_t> &d);
-unsigned int pedal_checksum(uint32_t address, const Signal &sig, const std::vector<uint8_t> &d);
+unsigned int honda_checksum(uint32_t address, const Signal &sig, const uint8_t *d, size_t size);
+unsigned int toyota_checksum(uint32_t address, const Signal &sig, const uint8_t *d, size_t size);
+unsigned int subaru_checksum(uint32_t address, const Signal &sig, const uint8_t *d, size_t size);
+unsigned int chrysler_checksum(uint32_t address, const Signal &sig, const uint8_t *d, size_t size);
+unsigned int volkswagen_mqb_checksum(uint32_t address, const Signal &sig, const uint8_t *d, size_t size);
+unsigned int xor_checksum(uint32_t address, const Signal &sig, const uint8_t *d, size_t size);
+unsigned int hkg_can_fd_checksum(uint32_t address, const Signal &sig, const uint8_t *d, size_t size);
+unsigned int pedal_checksum(uint32_t address, const Signal &sig, const uint8_t *d, size_t size);
 
 class MessageState {
 public:
@@ -43,6 +48,7 @@ public:
 
   std::vector<Signal> parse_sigs;
   std::vector<double> vals;
+  std::vector<double> tmp_vals;  // scratch for parse, same size as vals
   std::vector<std::vector<double>> all_vals;
 
   uint64_t last_seen_nanos;
@@ -54,11 +60,15 @@ public:
   bool ignore_checksum = false;
   bool ignore_counter = false;
 
-  bool parse(uint64_t nanos, const std::vector<uint8_t> &dat);
+  bool parse(uint64_t nanos, const uint8_t *dat, size_t dat_size);
   bool update_counter_generic(int64_t v, int cnt_size);
 };
 
+class CANParserGroup;
+
 class CANParser {
+  friend class CANParserGroup;
+
 private:
   const int bus;
   kj::Array<capnp::word> aligned_buf;
@@ -88,15 +98,67 @@ public:
   void query_latest(std::vector<SignalValue> &vals, uint64_t last_ts = 0);
 };
 
+// Parsers of different buses (pt, cam, radar, ...) of one car. Every can message is walked once,
+// and frames are dispatched to the parsers by bus and address through flat tables.
+class CANParserGroup {
+public:
+  CANParserGroup(const std::vector<CANParser *> &parsers);
+  #ifndef DYNAMIC_CAPNP
+  // out[i] gets the latest values of parsers[i], as CANParser::update_strings
+  void update_strings(const std::vector<std::string> &data, std::vector<std::vector<SignalValue>> &out, bool sendcan);
+  #endif
+
+private:
+  struct Target {
+    MessageState *state;
+    int next;  // next target with the same bus and address, -1 if none
+  };
+  struct Bus {
+    std::vector<int> parsers;
+    std::vector<int> std_ids;  // first target of each 11-bit address, -1 if none
+    std::unordered_map<uint32_t, int> ext_ids;
+  };
+
+  std::vector<CANParser *> parsers;
+  std::vector<Target> targets;
+  std::vector<Bus> buses;
+  int bus_index[256];  // src -> index in buses, -1 if no parser listens to it
+  std::vector<bool> bus_empty;
+  kj::Array<capnp::word> aligned_buf;
+};
+
 class CANPacker {
+public:
+  // A message with its signals resolved once, the counter state lives here too
+  struct MessageLayout {
+    uint32_t address;
+    unsigned int size;
+    std::vector<Signal> sigs;
+    std::unordered_map<std::string, int> sig_index;
+    int counter_sig = -1;
+    int checksum_sig = -1;
+    uint32_t counter = 0;
+  };
+  // value of the signal at index sig of MessageLayout::sigs
+  struct PackValue {
+    int sig;
+    double value;
+  };
+
 private:
   const DBC *dbc = NULL;
-  std::map<std::pair<uint32_t, std::string>, Signal> signal_lookup;
   std::map<uint32_t, Msg> message_lookup;
-  std::map<uint32_t, uint32_t> counters;
+  std::unordered_map<uint32_t, MessageLayout> layouts;
 
 public:
   CANPacker(const std::string& dbc_name);
   std::vector<uint8_t> pack(uint32_t address, const std::vector<SignalPackValue> &values);
+  // NULL if the DBC doesn't have the message. The layout lives as long as the packer.
+  MessageLayout *prepare(uint32_t address);
+  // -1 if the message doesn't have the signal
+  int signal_index(const MessageLayout *msg, const std::string &name) const;
+  // Packs into out, which holds msg->size bytes. COUNTER is filled in unless it is
+  // one of the values, CHECKSUM always is.
+  void pack(MessageLayout *msg, const PackValue *values, size_t count, uint8_t *out);
   Msg* lookup_message(uint32_t address);
 };
@@ -1,6 +1,7 @@
 # distutils: language = c++
 # cython: language_level=3
 
+from libc.stddef cimport size_t
 from libc.stdint cimport uint8_t, uint16_t, uint32_t, uint64_t
 from libcpp cimport bool
 from libcpp.pair cimport pair
@@ -8,7 +9,7 @@ from libcpp.string cimport string
 from libcpp.vector cimport vector
 
 
-ctypedef unsigned int (*calc_checksum_type)(uint32_t, const Signal&, const vector[uint8_t] &)
+ctypedef unsigned int (*calc_checksum_type)(uint32_t, const Signal&, const uint8_t *, size_t)
 
 cdef extern from "common_dbc.h":
   ctypedef enum SignalType:
@@ -70,6 +71,21 @@ cdef extern from "common.h":
     CANParser(int, string, vector[pair[uint32_t, int]]) except +
     void update_strings(vector[string]&, vector[SignalValue]&, bool) except +
 
+  cdef cppclass CANParserGroup:
+    CANParserGroup(vector[CANParser *]) except +
+    void update_strings(vector[string]&, vector[vector[SignalValue]]&, bool) except +
+
   cdef cppclass CANPacker:
+   cppclass MessageLayout:
+     uint32_t address
+     unsigned int size
+     vector[Signal] sigs
+
+   cppclass PackValue:
+     int sig
+     double value
+
    CANPacker(string)
    vector[uint8_t] pack(uint32_t, vector[SignalPackValue]&)
+   MessageLayout *prepare(uint32_t)
+   void pack(MessageLayout *, const PackValue *, size_t, uint8_t *)
@@ -38,7 +38,15 @@ struct Signal {
   double factor, offset;
   bool is_little_endian;
   SignalType type;
-  unsigned int (*calc_checksum)(uint32_t address, const Signal &sig, const std::vector<uint8_t> &d);
+  unsigned int (*calc_checksum)(uint32_t address, const Signal &sig, const uint8_t *d, size_t size);
+
+  // extraction plan, filled in by the DBC parser: one 64-bit load at load_byte
+  // (byte swapped for big endian), shifted right by shift and masked
+  bool has_plan;  // false if the signal spans more than one load
+  int load_byte;
+  int end_byte;  // one past the last byte of the signal, shorter frames don't use the plan
+  int shift;
+  uint64_t mask;
 };
 
 struct Msg {
@@ -68,10 +76,11 @@ typedef struct ChecksumState {
   int counter_start_bit;
   bool little_endian;
   SignalType checksum_type;
-  unsigned int (*calc_checksum)(uint32_t address, const Signal &sig, const std::vector<uint8_t> &d);
+  unsigned int (*calc_checksum)(uint32_t address, const Signal &sig, const uint8_t *d, size_t size);
 } ChecksumState;
 
 DBC* dbc_parse(const std::string& dbc_path);
 DBC* dbc_parse_from_stream(const std::string &dbc_name, std::istream &stream, ChecksumState *checksum = nullptr, bool allow_duplicate_msg_name=false);
 const DBC* dbc_lookup(const std::string& dbc_name);
 std::vector<std::string> get_dbc_names();
+const std::string get_dbc_root_path();
@@ -2,7 +2,6 @@
 #include <filesystem>
 #include <fstream>
 #include <map>
-#include <regex>
 #include <set>
 #include <sstream>
 #include <vector>
@@ -14,11 +13,113 @@
 #include "opendbc/can/common.h"
 #include "opendbc/can/common_dbc.h"
 
-std::regex bo_regexp(R"(^BO_ (\w+) (\w+) *: (\w+) (\w+))");
-std::regex sg_regexp(R"(^SG_ (\w+) : (\d+)\|(\d+)@(\d+)([\+|\-]) \(([0-9.+\-eE]+),([0-9.+\-eE]+)\) \[([0-9.+\-eE]+)\|([0-9.+\-eE]+)\] \"(.*)\" (.*))");
-std::regex sgm_regexp(R"(^SG_ (\w+) (\w+) *: (\d+)\|(\d+)@(\d+)([\+|\-]) \(([0-9.+\-eE]+),([0-9.+\-eE]+)\) \[([0-9.+\-eE]+)\|([0-9.+\-eE]+)\] \"(.*)\" (.*))");
-std::regex val_regexp(R"(VAL_ (\w+) (\w+) (\s*[-+]?[0-9]+\s+\".+?\"[^;]*))");
-std::regex val_split_regexp{R"([\"]+)"};  // split on "
+// Hand-written matchers for the BO_, SG_ and VAL_ lines. They accept the same lines as these
+// regular expressions, which made std::regex the bulk of loading a DBC:
+//   BO_ (\w+) (\w+) *: (\w+) (\w+)
+//   SG_ (\w+) (\w+ *)?: (\d+)\|(\d+)@(\d+)([\+|\-]) \(([0-9.+\-eE]+),([0-9.+\-eE]+)\) \[([0-9.+\-eE]+)\|([0-9.+\-eE]+)\] \"(.*)\" (.*)
+//   VAL_ (\w+) (\w+) (\s*[-+]?[0-9]+\s+\".+?\"[^;]*)
+class LineTokenizer {
+public:
+  LineTokenizer(const std::string &line) : line(line) {}
+
+  bool literal(char c) {
+    if (pos < line.size() && line[pos] == c) {
+      ++pos;
+      return true;
+    }
+    return false;
+  }
+  bool literal(const char *str) {
+    size_t len = strlen(str);
+    if (line.compare(pos, len, str) != 0) return false;
+    pos += len;
+    return true;
+  }
+  bool word(std::string &out) { return span(out, [](char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_'; }); }
+  bool digits(std::string &out) { return span(out, [](char c) { return c >= '0' && c <= '9'; }); }
+  bool number(std::string &out) { return span(out, [](char c) { return (c >= '0' && c <= '9') || strchr(".+-eE", c); }); }
+  bool whitespace() {
+    std::string ws;
+    return span(ws, [](char c) { return isspace((unsigned char)c) != 0; });
+  }
+  void spaces() {
+    while (literal(' ')) {}
+  }
+  bool done() const { return pos == line.size(); }
+
+  const std::string &line;
+  size_t pos = 0;
+
+private:
+  template <class F>
+  bool span(std::string &out, F pred) {
+    size_t start = pos;
+    while (pos < line.size() && pred(line[pos])) ++pos;
+    out.assign(line, start, pos - start);
+    return pos > start;
+  }
+};
+
+// BO_ <address> <name>: <size> <transmitter>
+bool match_bo(const std::string &line, std::string m[4]) {
+  LineTokenizer t(line);
+  if (!(t.literal("BO_ ") && t.word(m[0]) && t.literal(' ') && t.word(m[1]))) return false;
+  t.spaces();
+  return t.literal(": ") && t.word(m[2]) && t.literal(' ') && t.word(m[3]) && t.done();
+}
+
+// SG_ <name> [multiplexer]: <start>|<size>@<endianness><sign> (<factor>,<offset>) [<min>|<max>] "<unit>" <receivers>
+bool match_sg(const std::string &line, std::string m[9]) {
+  LineTokenizer t(line);
+  std::string multiplexer, min, max;
+  if (!(t.literal("SG_ ") && t.word(m[0]) && t.literal(' '))) return false;
+  if (!t.literal(':')) {
+    if (!t.word(multiplexer)) return false;
+    t.spaces();
+    if (!t.literal(':')) return false;
+  }
+  if (!(t.literal(' ') && t.digits(m[1]) && t.literal('|') && t.digits(m[2]) && t.literal('@') && t.digits(m[3]))) return false;
+  if (t.pos >= line.size() || !strchr("+|-", line[t.pos])) return false;
+  m[4] = line[t.pos++];
+  if (!(t.literal(" (") && t.number(m[5]) && t.literal(',') && t.number(m[6]) && t.literal(") [") &&
+        t.number(min) && t.literal('|') && t.number(max) && t.literal("] \""))) return false;
+  // unit and receivers
+  return line.find("\" ", t.pos) != std::string::npos;
+}
+
+// VAL_ <address> <signal> <value> "<description>" ... ;
+bool match_val(const std::string &line, std::string m[3]) {
+  LineTokenizer t(line);
+  if (!(t.literal("VAL_ ") && t.word(m[0]) && t.literal(' ') && t.word(m[1]) && t.literal(' '))) return false;
+  const size_t start = t.pos;
+  std::string value;
+  t.whitespace();
+  if (!t.literal('-')) t.literal('+');
+  if (!(t.digits(value) && t.whitespace() && t.literal('"'))) return false;
+  // a description of at least one character, the definitions run until ';'
+  size_t quote = line.find('"', t.pos + 1);
+  if (t.pos >= line.size() || quote == std::string::npos) return false;
+  size_t end = line.find(';', quote + 1);
+  m[2] = line.substr(start, (end == std::string::npos ? line.size() : end) - start);
+  return true;
+}
+
+// splits on runs of '"'
+std::vector<std::string> split_quotes(const std::string &str) {
+  std::vector<std::string> ret;
+  size_t start = 0;
+  while (start < str.size()) {
+    size_t end = str.find('"', start);
+    if (end == std::string::npos) {
+      ret.push_back(str.substr(start));
+      break;
+    }
+    ret.push_back(str.substr(start, end - start));
+    start = str.find_first_not_of('"', end);
+    if (start == std::string::npos) break;
+  }
+  return ret;
+}
 
 #define DBC_ASSERT(condition, message)                             \
   do {                                                             \
@@ -71,6 +172,21 @@ ChecksumState* get_checksum(const std::string& dbc_name) {
   return s;
 }
 
+void set_signal_plan(Signal& s) {
+  const int first_byte = (s.is_little_endian ? s.lsb : s.msb) / 8;
+  const int last_byte = (s.is_little_endian ? s.msb : s.lsb) / 8;
+  s.load_byte = first_byte;
+  s.end_byte = last_byte + 1;
+  if (s.is_little_endian) {
+    s.shift = s.lsb % 8;
+  } else {
+    // the first byte is the most significant one of the swapped load
+    s.shift = (7 - (last_byte - first_byte)) * 8 + s.lsb % 8;
+  }
+  s.has_plan = last_byte - first_byte < 8 && s.shift >= 0 && s.shift + s.size <= 64;
+  s.mask = s.size >= 64 ? ~0ULL : (1ULL << s.size) - 1;
+}
+
 void set_signal_type(Signal& s, ChecksumState* chk, const std::string& dbc_name, int line_num) {
   s.calc_checksum = nullptr;
   if (chk) {
@@ -119,20 +235,19 @@ DBC* dbc_parse_from_stream(const std::string &dbc_name, std::istream &stream, Ch
 
   std::string line;
   int line_num = 0;
-  std::smatch match;
-  // TODO: see if we can speed up the regex statements in this loop, SG_ is specifically the slowest
+  std::string match[9];
   while (std::getline(stream, line)) {
     line = trim(line);
     line_num += 1;
     if (startswith(line, "BO_ ")) {
       // new group
-      bool ret = std::regex_match(line, match, bo_regexp);
+      bool ret = match_bo(line, match);
       DBC_ASSERT(ret, "bad BO: " << line);
 
       Msg& msg = dbc->msgs.emplace_back();
-      address = msg.address = std::stoul(match[1].str());  // could be hex
-      msg.name = match[2].str();
-      msg.size = std::stoul(match[3].str());
+      address = msg.address = std::stoul(match[0]);  // could be hex
+      msg.name = match[1];
+      msg.size = std::stoul(match[2]);
 
       // check for duplicates
       DBC_ASSERT(address_set.find(address) == address_set.end(), "Duplicate message address: " << address << " (" << msg.name << ")");
@@ -144,20 +259,17 @@ DBC* dbc_parse_from_stream(const std::string &dbc_name, std::istream &stream, Ch
       }
     } else if (startswith(line, "SG_ ")) {
       // new signal
-      int offset = 0;
-      if (!std::regex_search(line, match, sg_regexp)) {
-        bool ret = std::regex_search(line, match, sgm_regexp);
-        DBC_ASSERT(ret, "bad SG: " << line);
-        offset = 1;
-      }
+      bool ret = match_sg(line, match);
+      DBC_ASSERT(ret, "bad SG: " << line);
+
       Signal& sig = signals[address].emplace_back();
-      sig.name = match[1].str();
-      sig.start_bit = std::stoi(match[offset + 2].str());
-      sig.size = std::stoi(match[offset + 3].str());
-      sig.is_little_endian = std::stoi(match[offset + 4].str()) == 1;
-      sig.is_signed = match[offset + 5].str() == "-";
-      sig.factor = std::stod(match[offset + 6].str());
-      sig.offset = std::stod(match[offset + 7].str());
+      sig.name = match[0];
+      sig.start_bit = std::stoi(match[1]);
+      sig.size = std::stoi(match[2]);
+      sig.is_little_endian = std::stoi(match[3]) == 1;
+      sig.is_signed = match[4] == "-";
+      sig.factor = std::stod(match[5]);
+      sig.offset = std::stod(match[6]);
       set_signal_type(sig, checksum, dbc_name, line_num);
       if (sig.is_little_endian) {
         sig.lsb = sig.start_bit;
@@ -168,23 +280,22 @@ DBC* dbc_parse_from_stream(const std::string &dbc_name, std::istream &stream, Ch
         sig.msb = sig.start_bit;
       }
       DBC_ASSERT(sig.lsb < (64 * 8) && sig.msb < (64 * 8), "Signal out of bounds: " << line);
+      set_signal_plan(sig);
 
       // Check for duplicate signal names
       DBC_ASSERT(signal_name_sets[address].find(sig.name) == signal_name_sets[address].end(), "Duplicate signal name: " << sig.name);
       signal_name_sets[address].insert(sig.name);
     } else if (startswith(line, "VAL_ ")) {
       // new signal value/definition
-      bool ret = std::regex_search(line, match, val_regexp);
+      bool ret = match_val(line, match);
       DBC_ASSERT(ret, "bad VAL: " << line);
 
       auto& val = dbc->vals.emplace_back();
-      val.address = std::stoul(match[1].str());  // could be hex
-      val.name = match[2].str();
+      val.address = std::stoul(match[0]);  // could be hex
+      val.name = match[1];
 
-      auto defvals = match[3].str();
-      std::sregex_token_iterator it{defvals.begin(), defvals.end(), val_split_regexp, -1};
       // convert strings to UPPER_CASE_WITH_UNDERSCORES
-      std::vector<std::string> words{it, {}};
+      std::vector<std::string> words = split_quotes(match[2]);
       for (auto& w : words) {
         w = trim(w);
         std::transform(w.begin(), w.end(), w.begin(), ::toupper);
@@ -212,9 +323,17 @@ DBC* dbc_parse(const std::string& dbc_path) {
   if (!infile) return nullptr;
 
   const std::string dbc_name = std::filesystem::path(dbc_path).filename();
-
+  const std::string content{std::istreambuf_iterator<char>(infile), std::istreambuf_iterator<char>()};
   std::unique_ptr<ChecksumState> checksum(get_checksum(dbc_name));
-  return dbc_parse_from_stream(dbc_name, infile, checksum.get());
+  const uint64_t key = dbc_cache_key(dbc_name, content, checksum.get());
+  if (DBC *dbc = dbc_cache_load(dbc_name, key, checksum.get())) {
+    return dbc;
+  }
+
+  std::istringstream stream(content);
+  DBC *dbc = dbc_parse_from_stream(dbc_name, stream, checksum.get());
+  dbc_cache_store(dbc_name, key, *dbc);
+  return dbc;
 }
 
 const std::string get_dbc_root_path() {
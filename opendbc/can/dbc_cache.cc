@@ -0,0 +1,297 @@
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <type_traits>
+
+#include "opendbc/can/common.h"
+
+// Parsed DBCs are cached in flat files next to each other, named <dbc name>.<build>.<key>.
+// Loading one is a single mmap and a pass over the records, no text parsing.
+// The key hashes the DBC's contents, its name, its checksum settings, the cache format and
+// the build of this library, so an edited DBC or a changed parser gets a new entry.
+// Several builds (libdbc.so, cabana, the tests) share the directory, each one only replaces
+// its own entries. Entries of other builds are dropped once they are DBC_CACHE_MAX_AGE old.
+// DBC_CACHE_DIR sets the directory, DBC_NO_CACHE=1 turns the cache off.
+
+namespace {
+
+const uint32_t DBC_CACHE_MAGIC = 0x43424444;  // "DDBC"
+const uint32_t DBC_CACHE_VERSION = 2;
+const auto DBC_CACHE_MAX_AGE = std::chrono::hours(24 * 7);
+
+struct DBCCacheHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t key;
+  uint64_t size;  // of the whole file
+  uint64_t hash;  // of everything after the header
+};
+
+// the fixed size part of a Signal
+struct CachedSignal {
+  int32_t start_bit, msb, lsb, size;
+  double factor, offset;
+  int32_t type;
+  uint8_t is_signed, is_little_endian, has_checksum, has_plan;
+  int32_t load_byte, end_byte, shift;
+  uint64_t mask;
+};
+
+uint64_t fnv1a(const void *data, size_t size, uint64_t hash = 0xcbf29ce484222325ULL) {
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ ((const uint8_t *)data)[i]) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+// Identifies the build of the parser, the signal types and plans in the cache are derived by it.
+// The file holding this code changes whenever it is rebuilt.
+uint64_t build_id() {
+  static const uint64_t id = []() {
+    uint64_t hash = fnv1a(&DBC_CACHE_VERSION, sizeof(DBC_CACHE_VERSION));
+    Dl_info info;
+    struct stat st;
+    if (dladdr((void *)&dbc_parse_from_stream, &info) != 0 && info.dli_fname != nullptr && stat(info.dli_fname, &st) == 0) {
+      const int64_t file_id[] = {(int64_t)st.st_size, (int64_t)st.st_mtime, (int64_t)st.st_ino};
+      hash = fnv1a(file_id, sizeof(file_id), hash);
+    } else {
+      hash = fnv1a(__DATE__ __TIME__, sizeof(__DATE__ __TIME__), hash);
+    }
+    return hash;
+  }();
+  return id;
+}
+
+std::string cache_dir() {
+  if (const char *no_cache = getenv("DBC_NO_CACHE"); no_cache && strcmp(no_cache, "1") == 0) return {};
+  if (const char *dir = getenv("DBC_CACHE_DIR")) return dir;
+  if (const char *dir = getenv("XDG_CACHE_HOME")) return std::string(dir) + "/opendbc";
+  if (const char *home = getenv("HOME")) return std::string(home) + "/.cache/opendbc";
+  return {};
+}
+
+std::string hex_id(uint64_t id) {
+  char hex[17];
+  snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)id);
+  return hex;
+}
+
+std::string cache_path(const std::string &dir, const std::string &dbc_name, uint64_t key) {
+  return dir + "/" + dbc_name + "." + hex_id(build_id()) + "." + hex_id(key);
+}
+
+class Writer {
+public:
+  template <class T>
+  void put(const T &v) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    buf.append((const char *)&v, sizeof(v));
+  }
+  void put(const std::string &s) {
+    put((uint32_t)s.size());
+    buf.append(s);
+  }
+  void put(const Signal &sig) {
+    put(sig.name);
+    CachedSignal c = {
+      .start_bit = sig.start_bit, .msb = sig.msb, .lsb = sig.lsb, .size = sig.size,
+      .factor = sig.factor, .offset = sig.offset,
+      .type = sig.type,
+      .is_signed = sig.is_signed, .is_little_endian = sig.is_little_endian,
+      .has_checksum = sig.calc_checksum != nullptr, .has_plan = sig.has_plan,
+      .load_byte = sig.load_byte, .end_byte = sig.end_byte, .shift = sig.shift,
+      .mask = sig.mask,
+    };
+    put(c);
+  }
+  void put(const std::vector<Signal> &sigs) {
+    put((uint32_t)sigs.size());
+    for (const auto &sig : sigs) put(sig);
+  }
+
+  std::string buf;
+};
+
+// Reads the records back, every read is bounds checked so a truncated or corrupt file is just a miss
+class Reader {
+public:
+  Reader(const char *data, size_t size) : p(data), end(data + size) {}
+
+  template <class T>
+  bool get(T &v) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (end - p < (ptrdiff_t)sizeof(v)) return false;
+    memcpy(&v, p, sizeof(v));
+    p += sizeof(v);
+    return true;
+  }
+  bool get(std::string &s) {
+    uint32_t size;
+    if (!get(size) || end - p < (ptrdiff_t)size) return false;
+    s.assign(p, size);
+    p += size;
+    return true;
+  }
+  bool get(Signal &sig, const ChecksumState *checksum) {
+    CachedSignal c;
+    if (!get(sig.name) || !get(c)) return false;
+    if (c.has_checksum && (checksum == nullptr || checksum->calc_checksum == nullptr)) return false;
+    sig.start_bit = c.start_bit;
+    sig.msb = c.msb;
+    sig.lsb = c.lsb;
+    sig.size = c.size;
+    sig.factor = c.factor;
+    sig.offset = c.offset;
+    sig.type = (SignalType)c.type;
+    sig.is_signed = c.is_signed;
+    sig.is_little_endian = c.is_little_endian;
+    sig.calc_checksum = c.has_checksum ? checksum->calc_checksum : nullptr;
+    sig.has_plan = c.has_plan;
+    sig.load_byte = c.load_byte;
+    sig.end_byte = c.end_byte;
+    sig.shift = c.shift;
+    sig.mask = c.mask;
+    return true;
+  }
+  bool get(std::vector<Signal> &sigs, const ChecksumState *checksum) {
+    uint32_t count;
+    if (!get(count) || count > (size_t)(end - p)) return false;
+    sigs.resize(count);
+    for (auto &sig : sigs) {
+      if (!get(sig, checksum)) return false;
+    }
+    return true;
+  }
+  bool done() const { return p == end; }
+
+private:
+  const char *p;
+  const char *end;
+};
+
+bool read_dbc(Reader &r, DBC &dbc, const ChecksumState *checksum) {
+  uint32_t count;
+  if (!r.get(dbc.name) || !r.get(count)) return false;
+  dbc.msgs.resize(count);
+  for (auto &msg : dbc.msgs) {
+    if (!r.get(msg.name) || !r.get(msg.address) || !r.get(msg.size) || !r.get(msg.sigs, checksum)) return false;
+  }
+  if (!r.get(count)) return false;
+  dbc.vals.resize(count);
+  for (auto &val : dbc.vals) {
+    if (!r.get(val.name) || !r.get(val.address) || !r.get(val.def_val) || !r.get(val.sigs, checksum)) return false;
+  }
+  return r.done();
+}
+
+}  // namespace
+
+uint64_t dbc_cache_key(const std::string &dbc_name, const std::string &content, const ChecksumState *checksum) {
+  uint64_t key = build_id();
+  key = fnv1a(dbc_name.c_str(), dbc_name.size() + 1, key);
+  // the checksum settings decide the signal types, the function pointer differs between runs
+  if (checksum != nullptr) {
+    const int32_t settings[] = {checksum->checksum_size, checksum->counter_size, checksum->checksum_start_bit,
+                                checksum->counter_start_bit, checksum->little_endian, checksum->checksum_type};
+    key = fnv1a(settings, sizeof(settings), key);
+  }
+  return fnv1a(content.data(), content.size(), key);
+}
+
+DBC *dbc_cache_load(const std::string &dbc_name, uint64_t key, const ChecksumState *checksum) {
+  const std::string dir = cache_dir();
+  if (dir.empty()) return nullptr;
+
+  int fd = open(cache_path(dir, dbc_name, key).c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return nullptr;
+
+  DBC *dbc = nullptr;
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_size >= sizeof(DBCCacheHeader)) {
+    void *p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p != MAP_FAILED) {
+      const DBCCacheHeader *header = (const DBCCacheHeader *)p;
+      const char *data = (const char *)p + sizeof(DBCCacheHeader);
+      const size_t data_size = st.st_size - sizeof(DBCCacheHeader);
+      if (header->magic == DBC_CACHE_MAGIC && header->version == DBC_CACHE_VERSION &&
+          header->key == key && header->size == st.st_size && header->hash == fnv1a(data, data_size)) {
+        Reader r(data, data_size);
+        dbc = new DBC;
+        if (!read_dbc(r, *dbc, checksum)) {
+          delete dbc;
+          dbc = nullptr;
+        }
+      }
+      munmap(p, st.st_size);
+    }
+  }
+  close(fd);
+  return dbc;
+}
+
+void dbc_cache_store(const std::string &dbc_name, uint64_t key, const DBC &dbc) {
+  const std::string dir = cache_dir();
+  if (dir.empty()) return;
+
+  std::error_code ec;
+  std::filesystem::create_directories(dir, ec);
+  if (ec) return;
+
+  Writer w;
+  w.put(DBCCacheHeader{});
+  w.put(dbc.name);
+  w.put((uint32_t)dbc.msgs.size());
+  for (const auto &msg : dbc.msgs) {
+    w.put(msg.name);
+    w.put(msg.address);
+    w.put(msg.size);
+    w.put(msg.sigs);
+  }
+  w.put((uint32_t)dbc.vals.size());
+  for (const auto &val : dbc.vals) {
+    w.put(val.name);
+    w.put(val.address);
+    w.put(val.def_val);
+    w.put(val.sigs);
+  }
+  DBCCacheHeader header = {.magic = DBC_CACHE_MAGIC, .version = DBC_CACHE_VERSION, .key = key, .size = w.buf.size(),
+                           .hash = fnv1a(w.buf.data() + sizeof(DBCCacheHeader), w.buf.size() - sizeof(DBCCacheHeader))};
+  memcpy(w.buf.data(), &header, sizeof(header));
+
+  // write to a temp file and rename, so readers never see a partial file
+  const std::string path = cache_path(dir, dbc_name, key);
+  std::string tmp_path = path + ".tmp_XXXXXX";
+  int fd = mkstemp(tmp_path.data());
+  if (fd < 0) return;
+  bool ok = write(fd, w.buf.data(), w.buf.size()) == (ssize_t)w.buf.size();
+  close(fd);
+  if (!ok || rename(tmp_path.c_str(), path.c_str()) != 0) {
+    unlink(tmp_path.c_str());
+    return;
+  }
+
+  // Drop the entries of older versions of this DBC stored by this build. The other builds keep
+  // theirs, or they would evict each other on every start, until they look abandoned.
+  const std::string prefix = dbc_name + ".";
+  const std::string build_prefix = prefix + hex_id(build_id()) + ".";
+  const auto now = std::filesystem::file_time_type::clock::now();
+  for (const auto &entry : std::filesystem::directory_iterator(dir, ec)) {
+    const std::string name = entry.path().filename();
+    if (name.size() != prefix.size() + 33 || name.compare(0, prefix.size(), prefix) != 0 || entry.path() == path) {
+      continue;
+    }
+    std::error_code entry_ec;
+    const auto mtime = entry.last_write_time(entry_ec);
+    if (name.compare(0, build_prefix.size(), build_prefix) == 0 || (!entry_ec && now - mtime > DBC_CACHE_MAX_AGE)) {
+      std::filesystem::remove(entry.path(), entry_ec);
+    }
+  }
+}
@@ -1,21 +1,23 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstring>
 #include <map>
 #include <stdexcept>
 #include <utility>
 
 #include "opendbc/can/common.h"
 
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "packing plans assume a little endian host");
 
-void set_value(std::vector<uint8_t> &msg, const Signal &sig, int64_t ival) {
+void set_value(uint8_t *msg, size_t msg_size, const Signal &sig, int64_t ival) {
   int i = sig.lsb / 8;
   int bits = sig.size;
   if (sig.size < 64) {
     ival &= ((1ULL << sig.size) - 1);
   }
 
-  while (i >= 0 && i < msg.size() && bits > 0) {
+  while (i >= 0 && i < msg_size && bits > 0) {
     int shift = (int)(sig.lsb / 8) == i ? sig.lsb % 8 : 0;
     int size = std::min(bits, 8 - shift);
 
@@ -28,67 +30,115 @@ void set_value(std::vector<uint8_t> &msg, const Signal &sig, int64_t ival) {
   }
 }
 
+// The inverse of the parser's extraction plan. buf is zero padded, so the
+// 64-bit load and store can go past the end of the message.
+inline void set_planned_value(uint8_t *buf, size_t size, const Signal &sig, int64_t ival) {
+  if (!sig.has_plan || sig.end_byte > size) {
+    set_value(buf, size, sig, ival);
+    return;
+  }
+
+  uint64_t v;
+  memcpy(&v, buf + sig.load_byte, sizeof(v));
+  if (!sig.is_little_endian) v = __builtin_bswap64(v);
+  v = (v & ~(sig.mask << sig.shift)) | (((uint64_t)ival & sig.mask) << sig.shift);
+  if (!sig.is_little_endian) v = __builtin_bswap64(v);
+  memcpy(buf + sig.load_byte, &v, sizeof(v));
+}
+
 CANPacker::CANPacker(const std::string& dbc_name) {
   dbc = dbc_lookup(dbc_name);
   assert(dbc);
 
   for (const auto& msg : dbc->msgs) {
     message_lookup[msg.address] = msg;
-    for (const auto& sig : msg.sigs) {
-      signal_lookup[std::make_pair(msg.address, sig.name)] = sig;
+
+    auto &layout = layouts[msg.address];
+    layout.address = msg.address;
+    layout.size = msg.size;
+    layout.sigs = msg.sigs;
+    for (int i = 0; i < layout.sigs.size(); i++) {
+      const auto &sig = layout.sigs[i];
+      layout.sig_index[sig.name] = i;
+      if (sig.name == "COUNTER") {
+        layout.counter_sig = i;
+      } else if (sig.name == "CHECKSUM" && sig.calc_checksum != nullptr) {
+        layout.checksum_sig = i;
+      }
     }
   }
   init_crc_lookup_tables();
 }
 
-std::vector<uint8_t> CANPacker::pack(uint32_t address, const std::vector<SignalPackValue> &signals) {
-  std::vector<uint8_t> ret(message_lookup[address].size, 0);
+CANPacker::MessageLayout *CANPacker::prepare(uint32_t address) {
+  auto it = layouts.find(address);
+  return it != layouts.end() ? &it->second : nullptr;
+}
+
+int CANPacker::signal_index(const MessageLayout *msg, const std::string &name) const {
+  auto it = msg->sig_index.find(name);
+  return it != msg->sig_index.end() ? it->second : -1;
+}
+
+void CANPacker::pack(MessageLayout *msg, const PackValue *values, size_t count, uint8_t *out) {
+  const size_t size = std::min<size_t>(msg->size, 64);
+  uint8_t buf[64 + sizeof(uint64_t)] = {};
 
   // set all values for all given signal/value pairs
   bool counter_set = false;
-  for (const auto& sigval : signals) {
-    auto sig_it = signal_lookup.find(std::make_pair(address, sigval.name));
-    if (sig_it == signal_lookup.end()) {
-      // TODO: do something more here. invalid flag like CANParser?
-      WARN("undefined signal %s - %d\n", sigval.name.c_str(), address);
-      continue;
-    }
-    const auto &sig = sig_it->second;
+  for (size_t i = 0; i < count; i++) {
+    const auto &sig = msg->sigs[values[i].sig];
 
-    int64_t ival = (int64_t)(round((sigval.value - sig.offset) / sig.factor));
+    int64_t ival = (int64_t)(round((values[i].value - sig.offset) / sig.factor));
     if (ival < 0) {
       ival = (1ULL << sig.size) + ival;
     }
-    set_value(ret, sig, ival);
+    set_planned_value(buf, size, sig, ival);
 
-    counter_set = counter_set || (sigval.name == "COUNTER");
-    if (counter_set) {
-      counters[address] = sigval.value;
+    if (values[i].sig == msg->counter_sig) {
+      counter_set = true;
+      msg->counter = values[i].value;
     }
   }
 
   // set message counter
-  auto sig_it_counter = signal_lookup.find(std::make_pair(address, "COUNTER"));
-  if (!counter_set && sig_it_counter != signal_lookup.end()) {
-    const auto& sig = sig_it_counter->second;
-
-    if (counters.find(address) == counters.end()) {
-      counters[address] = 0;
-    }
-    set_value(ret, sig, counters[address]);
-    counters[address] = (counters[address] + 1) % (1 << sig.size);
+  if (!counter_set && msg->counter_sig >= 0) {
+    const auto &sig = msg->sigs[msg->counter_sig];
+    set_planned_value(buf, size, sig, msg->counter);
+    msg->counter = (msg->counter + 1) % (1 << sig.size);
   }
 
   // set message checksum
-  auto sig_it_checksum = signal_lookup.find(std::make_pair(address, "CHECKSUM"));
-  if (sig_it_checksum != signal_lookup.end()) {
-    const auto &sig = sig_it_checksum->second;
-    if (sig.calc_checksum != nullptr) {
-      unsigned int checksum = sig.calc_checksum(address, sig, ret);
-      set_value(ret, sig, checksum);
+  if (msg->checksum_sig >= 0) {
+    const auto &sig = msg->sigs[msg->checksum_sig];
+    unsigned int checksum = sig.calc_checksum(msg->address, sig, buf, size);
+    set_planned_value(buf, size, sig, checksum);
+  }
+
+  memcpy(out, buf, size);
+}
+
+std::vector<uint8_t> CANPacker::pack(uint32_t address, const std::vector<SignalPackValue> &signals) {
+  MessageLayout *msg = prepare(address);
+  if (msg == nullptr) {
+    WARN("undefined message %d\n", address);
+    return {};
+  }
+
+  std::vector<PackValue> values;
+  values.reserve(signals.size());
+  for (const auto& sigval : signals) {
+    int idx = signal_index(msg, sigval.name);
+    if (idx < 0) {
+      // TODO: do something more here. invalid flag like CANParser?
+      WARN("undefined signal %s - %d\n", sigval.name.c_str(), address);
+      continue;
     }
+    values.push_back({idx, sigval.value});
   }
 
+  std::vector<uint8_t> ret(msg->size, 0);
+  pack(msg, values.data(), values.size(), ret.data());
   return ret;
 }
 
@@ -1,20 +1,27 @@
 # distutils: language = c++
 # cython: c_string_encoding=ascii, language_level=3
 
-from libc.stdint cimport uint8_t
+from libc.stdint cimport uint8_t, uint32_t
 from libcpp.vector cimport vector
-from libcpp.map cimport map
-from libcpp.string cimport string
 
 from .common cimport CANPacker as cpp_CANPacker
-from .common cimport dbc_lookup, SignalPackValue, DBC
+from .common cimport dbc_lookup, DBC
+
+
+cdef class PreparedMessage:
+  cdef:
+    cpp_CANPacker.MessageLayout *layout
+    readonly uint32_t address
+    readonly dict sig_index
 
 
 cdef class CANPacker:
   cdef:
     cpp_CANPacker *packer
     const DBC *dbc
-    map[string, int] name_to_address
+    dict name_to_address
+    dict prepared
+    vector[cpp_CANPacker.PackValue] values
 
   def __init__(self, dbc_name):
     self.dbc = dbc_lookup(dbc_name)
@@ -22,32 +29,56 @@ cdef class CANPacker:
       raise RuntimeError(f"Can't lookup {dbc_name}")
 
     self.packer = new cpp_CANPacker(dbc_name)
+    self.name_to_address = {}
+    self.prepared = {}
     for i in range(self.dbc[0].msgs.size()):
       msg = self.dbc[0].msgs[i]
-      self.name_to_address[string(msg.name)] = msg.address
+      self.name_to_address[msg.name.decode("utf8")] = msg.address
 
   def __dealloc__(self):
     if self.packer:
       del self.packer
 
-  cdef vector[uint8_t] pack(self, addr, values):
-    cdef vector[SignalPackValue] values_thing
-    values_thing.reserve(len(values))
-    cdef SignalPackValue spv
+  cpdef PreparedMessage prepare(self, name_or_addr):
+    """Resolves a message and the indices of its signals once, later packs of it are
+    lookups in a dict. make_can_msg prepares the messages it is given on first use."""
+    cdef PreparedMessage msg = self.prepared.get(name_or_addr)
+    if msg is not None:
+      return msg
 
-    for name, value in values.iteritems():
-      spv.name = name.encode("utf8")
-      spv.value = value
-      values_thing.push_back(spv)
-
-    return self.packer.pack(addr, values_thing)
-
-  cpdef make_can_msg(self, name_or_addr, bus, values):
-    cdef int addr
+    cdef uint32_t addr
     if isinstance(name_or_addr, int):
       addr = name_or_addr
     else:
-      addr = self.name_to_address[name_or_addr.encode("utf8")]
+      addr = self.name_to_address[name_or_addr]
+
+    cdef cpp_CANPacker.MessageLayout *layout = self.packer.prepare(addr)
+    if layout == NULL:
+      raise KeyError(name_or_addr)
+
+    msg = PreparedMessage()
+    msg.layout = layout
+    msg.address = addr
+    msg.sig_index = {layout.sigs[i].name.decode("utf8"): i for i in range(layout.sigs.size())}
+    self.prepared[name_or_addr] = msg
+    return msg
+
+  cpdef make_can_msg(self, name_or_addr, bus, values):
+    cdef PreparedMessage msg = self.prepared.get(name_or_addr)
+    if msg is None:
+      msg = self.prepare(name_or_addr)
+
+    cdef cpp_CANPacker.PackValue pv
+    self.values.clear()
+    for name, value in values.items():
+      idx = msg.sig_index.get(name)
+      if idx is None:
+        print(f"undefined signal {name} - {msg.address}")
+        continue
+      pv.sig = idx
+      pv.value = value
+      self.values.push_back(pv)
 
-    cdef vector[uint8_t] val = self.pack(addr, values)
-    return [addr, 0, (<char *>&val[0])[:val.size()], bus]
+    cdef uint8_t dat[64]
+    self.packer.pack(msg.layout, self.values.data(), self.values.size(), dat)
+    return [msg.address, 0, (<char *>dat)[:min(msg.layout.size, 64)], bus]
@@ -13,12 +13,12 @@
 #include "cereal/logger/logger.h"
 #include "opendbc/can/common.h"
 
-int64_t get_raw_value(const std::vector<uint8_t> &msg, const Signal &sig) {
+int64_t get_raw_value(const uint8_t *msg, size_t msg_size, const Signal &sig) {
   int64_t ret = 0;
 
   int i = sig.msb / 8;
   int bits = sig.size;
-  while (i >= 0 && i < msg.size() && bits > 0) {
+  while (i >= 0 && i < msg_size && bits > 0) {
     int lsb = (int)(sig.lsb / 8) == i ? sig.lsb : i*8;
     int msb = (int)(sig.msb / 8) == i ? sig.msb : (i+1)*8 - 1;
     int size = msb - lsb + 1;
@@ -32,16 +32,29 @@ int64_t get_raw_value(const std::vector<uint8_t> &msg, const Signal &sig) {
   return ret;
 }
 
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "extraction plans assume a little endian host");
 
-bool MessageState::parse(uint64_t nanos, const std::vector<uint8_t> &dat) {
-  std::vector<double> tmp_vals(parse_sigs.size());
+// buf is zero padded, so the load can read past the end of the frame
+inline int64_t get_planned_value(const uint8_t *buf, const Signal &sig) {
+  uint64_t v;
+  memcpy(&v, buf + sig.load_byte, sizeof(v));
+  if (!sig.is_little_endian) {
+    v = __builtin_bswap64(v);
+  }
+  return (v >> sig.shift) & sig.mask;
+}
+
+bool MessageState::parse(uint64_t nanos, const uint8_t *dat, size_t dat_size) {
   bool checksum_failed = false;
   bool counter_failed = false;
 
+  uint8_t buf[64 + sizeof(uint64_t)] = {};
+  memcpy(buf, dat, std::min<size_t>(dat_size, 64));
+
   for (int i = 0; i < parse_sigs.size(); i++) {
     const auto &sig = parse_sigs[i];
 
-    int64_t tmp = get_raw_value(dat, sig);
+    int64_t tmp = sig.has_plan && sig.end_byte <= dat_size ? get_planned_value(buf, sig) : get_raw_value(dat, dat_size, sig);
     if (sig.is_signed) {
       tmp -= ((tmp >> (sig.size-1)) & 0x1) ? (1ULL << sig.size) : 0;
     }
@@ -49,7 +62,7 @@ bool MessageState::parse(uint64_t nanos, const std::vector<uint8_t> &dat) {
     //DEBUG("parse 0x%X %s -> %ld\n", address, sig.name, tmp);
 
     if (!ignore_checksum) {
-      if (sig.calc_checksum != nullptr && sig.calc_checksum(address, sig, dat) != tmp) {
+      if (sig.calc_checksum != nullptr && sig.calc_checksum(address, sig, dat, dat_size) != tmp) {
         checksum_failed = true;
       }
     }
@@ -79,6 +92,13 @@ bool MessageState::parse(uint64_t nanos, const std::vector<uint8_t> &dat) {
 }
 
 
+// signals are parsed in the order they are laid out in the frame
+void sort_signals(std::vector<Signal> &sigs) {
+  std::stable_sort(sigs.begin(), sigs.end(), [](const Signal &a, const Signal &b) {
+    return a.load_byte < b.load_byte;
+  });
+}
+
 bool MessageState::update_counter_generic(int64_t v, int cnt_size) {
   if (((counter + 1) & ((1 << cnt_size) -1)) != v) {
     counter_fail = std::min(counter_fail + 1, MAX_BAD_COUNTER);
@@ -139,7 +159,9 @@ CANParser::CANParser(int abus, const std::string& dbc_name, const std::vector<st
 
     // track all signals for this message
     state.parse_sigs = msg->sigs;
+    sort_signals(state.parse_sigs);
     state.vals.resize(msg->sigs.size());
+    state.tmp_vals.resize(msg->sigs.size());
     state.all_vals.resize(msg->sigs.size());
   }
 }
@@ -164,8 +186,10 @@ CANParser::CANParser(int abus, const std::string& dbc_name, bool ignore_checksum
     for (const auto& sig : msg.sigs) {
       state.parse_sigs.push_back(sig);
       state.vals.push_back(0);
+      state.tmp_vals.push_back(0);
       state.all_vals.push_back({});
     }
+    sort_signals(state.parse_sigs);
 
     message_states[state.address] = state;
   }
@@ -238,9 +262,7 @@ void CANParser::UpdateCans(uint64_t nanos, const capnp::List<cereal::CanData>::R
     //  continue;
     //}
 
-    std::vector<uint8_t> data(dat.size(), 0);
-    memcpy(data.data(), dat.begin(), dat.size());
-    state_it->second.parse(nanos, data);
+    state_it->second.parse(nanos, dat.begin(), dat.size());
   }
 
   // update bus timeout
@@ -268,9 +290,7 @@ void CANParser::UpdateCans(uint64_t nanos, const capnp::DynamicStruct::Reader& c
 
   auto dat = cmsg.get("dat").as<capnp::Data>();
   if (dat.size() > 64) return; // shouldn't ever happen
-  std::vector<uint8_t> data(dat.size(), 0);
-  memcpy(data.data(), dat.begin(), dat.size());
-  state_it->second.parse(nanos, data);
+  state_it->second.parse(nanos, dat.begin(), dat.size());
 }
 
 void CANParser::UpdateValid(uint64_t nanos) {
@@ -324,3 +344,90 @@ void CANParser::query_latest(std::vector<SignalValue> &vals, uint64_t last_ts) {
     }
   }
 }
+
+CANParserGroup::CANParserGroup(const std::vector<CANParser *> &parsers)
+  : parsers(parsers), aligned_buf(kj::heapArray<capnp::word>(1024)) {
+  std::fill(std::begin(bus_index), std::end(bus_index), -1);
+  for (int p = 0; p < parsers.size(); p++) {
+    int src = parsers[p]->bus;
+    assert(src >= 0 && src < 256);
+    if (bus_index[src] < 0) {
+      bus_index[src] = buses.size();
+      buses.emplace_back().std_ids.resize(0x800, -1);
+    }
+    Bus &bus = buses[bus_index[src]];
+    bus.parsers.push_back(p);
+
+    for (auto &[address, state] : parsers[p]->message_states) {
+      int &first = address < 0x800 ? bus.std_ids[address] : bus.ext_ids.try_emplace(address, -1).first->second;
+      targets.push_back({.state = &state, .next = first});
+      first = targets.size() - 1;
+    }
+  }
+  bus_empty.resize(parsers.size());
+}
+
+#ifndef DYNAMIC_CAPNP
+void CANParserGroup::update_strings(const std::vector<std::string> &data, std::vector<std::vector<SignalValue>> &out, bool sendcan) {
+  uint64_t current_nanos = 0;
+  for (const auto &d : data) {
+    // format for board, make copy due to alignment issues.
+    const size_t buf_size = (d.length() / sizeof(capnp::word)) + 1;
+    if (aligned_buf.size() < buf_size) {
+      aligned_buf = kj::heapArray<capnp::word>(buf_size);
+    }
+    memcpy(aligned_buf.begin(), d.data(), d.length());
+
+    capnp::FlatArrayMessageReader cmsg(aligned_buf.slice(0, buf_size));
+    cereal::Event::Reader event = cmsg.getRoot<cereal::Event>();
+    const uint64_t nanos = event.getLogMonoTime();
+    if (current_nanos == 0) {
+      current_nanos = nanos;
+    }
+
+    std::fill(bus_empty.begin(), bus_empty.end(), true);
+    for (const auto c : sendcan ? event.getSendcan() : event.getCan()) {
+      const int b = bus_index[c.getSrc()];
+      if (b < 0) continue;
+
+      const Bus &bus = buses[b];
+      for (int p : bus.parsers) {
+        bus_empty[p] = false;
+      }
+
+      const uint32_t address = c.getAddress();
+      int t = -1;
+      if (address < 0x800) {
+        t = bus.std_ids[address];
+      } else if (auto it = bus.ext_ids.find(address); it != bus.ext_ids.end()) {
+        t = it->second;
+      }
+      auto dat = c.getDat();
+      if (t < 0 || dat.size() > 64) continue;
+
+      for (; t >= 0; t = targets[t].next) {
+        targets[t].state->parse(nanos, dat.begin(), dat.size());
+      }
+    }
+
+    for (int p = 0; p < parsers.size(); p++) {
+      CANParser *parser = parsers[p];
+      if (parser->first_nanos == 0) {
+        parser->first_nanos = nanos;
+      }
+      parser->last_nanos = nanos;
+      if (!bus_empty[p]) {
+        parser->last_nonempty_nanos = nanos;
+      }
+      parser->bus_timeout = (nanos - parser->last_nonempty_nanos) > parser->bus_timeout_threshold;
+      parser->UpdateValid(nanos);
+    }
+  }
+
+  out.resize(parsers.size());
+  for (int p = 0; p < parsers.size(); p++) {
+    out[p].clear();
+    parsers[p]->query_latest(out[p], current_nanos);
+  }
+}
+#endif
@@ -9,6 +9,7 @@ from libcpp.unordered_set cimport unordered_set
 from libc.stdint cimport uint32_t
 
 from .common cimport CANParser as cpp_CANParser
+from .common cimport CANParserGroup as cpp_CANParserGroup
 from .common cimport dbc_lookup, SignalValue, DBC
 
 import numbers
@@ -71,14 +72,21 @@ cdef class CANParser:
       del self.can
 
   def update_strings(self, strings, sendcan=False):
-    for v in self.vl_all.values():
-      for l in v.values():  # no-cython-lint
-        l.clear()
+    self.clear_vl_all()
 
     cdef vector[SignalValue] new_vals
     cdef unordered_set[uint32_t] updated_addrs
 
     self.can.update_strings(strings, new_vals, sendcan)
+    self.set_values(new_vals, updated_addrs)
+    return updated_addrs
+
+  cdef clear_vl_all(self):
+    for v in self.vl_all.values():
+      for l in v.values():  # no-cython-lint
+        l.clear()
+
+  cdef set_values(self, vector[SignalValue] &new_vals, unordered_set[uint32_t] &updated_addrs):
     cdef vector[SignalValue].iterator it = new_vals.begin()
     cdef SignalValue* cv
     while it != new_vals.end():
@@ -91,8 +99,6 @@ cdef class CANParser:
       updated_addrs.insert(cv.address)
       preinc(it)
 
-    return updated_addrs
-
   @property
   def can_valid(self):
     return self.can.can_valid
@@ -102,6 +108,44 @@ cdef class CANParser:
     return self.can.bus_timeout
 
 
+cdef class CANParserGroup:
+  """Updates the parsers of several buses with one pass over each can message.
+  vl, vl_all and ts_nanos are set as CANParser.update_strings does.
+  Returns the updated addresses of each parser."""
+  cdef:
+    cpp_CANParserGroup *group
+    vector[vector[SignalValue]] updates
+
+  cdef readonly:
+    list parsers
+
+  def __init__(self, parsers):
+    self.parsers = [p for p in parsers if p is not None]
+
+    cdef vector[cpp_CANParser *] parser_v
+    cdef CANParser p
+    for p in self.parsers:
+      parser_v.push_back(p.can)
+    self.group = new cpp_CANParserGroup(parser_v)
+
+  def __dealloc__(self):
+    if self.group:
+      del self.group
+
+  def update_strings(self, strings, sendcan=False):
+    self.group.update_strings(strings, self.updates, sendcan)
+
+    cdef CANParser p
+    cdef unordered_set[uint32_t] updated_addrs
+    ret = []
+    for i, p in enumerate(self.parsers):
+      p.clear_vl_all()
+      updated_addrs.clear()
+      p.set_values(self.updates[i], updated_addrs)
+      ret.append(updated_addrs)
+    return ret
+
+
 cdef class CANDefine():
   cdef:
     const DBC *dbc
@@ -0,0 +1,37 @@
+#!/usr/bin/env python3
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+from opendbc.can.tests import ALL_DBCS
+
+# Time to load every DBC in opendbc from a fresh process: without the binary cache,
+# with an empty cache that gets filled, and from the filled cache.
+# usage: benchmark_dbc_load.py
+
+
+def load_all():
+  from opendbc.can.parser import CANDefine
+  t = time.monotonic()
+  for dbc in ALL_DBCS:
+    CANDefine(dbc)
+  print(f"{(time.monotonic() - t) * 1000:.1f}")
+
+
+if __name__ == "__main__":
+  if len(sys.argv) > 1 and sys.argv[1] == "--load":
+    load_all()
+    sys.exit(0)
+
+  with tempfile.TemporaryDirectory() as cache_dir:
+    runs = [
+      ("no cache", {"DBC_NO_CACHE": "1"}),
+      ("cold cache", {"DBC_CACHE_DIR": cache_dir}),
+      ("warm cache", {"DBC_CACHE_DIR": cache_dir}),
+    ]
+    print(f"loading {len(ALL_DBCS)} DBCs")
+    for name, env in runs:
+      out = subprocess.check_output([sys.executable, __file__, "--load"], env={**os.environ, **env}, text=True)
+      print(f"{name:<12} {float(out):8.1f} ms")
@@ -0,0 +1,41 @@
+#!/usr/bin/env python3
+import argparse
+import time
+
+from opendbc.can.packer import CANPacker
+
+# Packs the messages a carcontroller sends every cycle and reports how many
+# messages/s make_can_msg packs.
+# usage: benchmark_packer.py [--rounds N]
+
+# (dbc, message, values), roughly one 100 Hz Toyota and Honda cycle
+MESSAGES = [
+  ("toyota_nodsu_pt_generated", "STEERING_LKA", {"STEER_REQUEST": 1, "STEER_TORQUE_CMD": -350, "SET_ME_1": 1, "LKA_STATE": 0}),
+  ("toyota_nodsu_pt_generated", "ACC_CONTROL", {"ACCEL_CMD": -1.5, "ACC_TYPE": 1, "ALLOW_LONG_PRESS": 1, "PERMIT_BRAKING": 1,
+                                                "RELEASE_STANDSTILL": 0, "CANCEL_REQ": 0, "ACC_CUT_IN": 0, "ACC_MALFUNCTION": 0}),
+  ("toyota_nodsu_pt_generated", "PCM_CRUISE", {"CRUISE_ACTIVE": 1, "GAS_RELEASED": 1, "CRUISE_STATE": 9}),
+  ("honda_civic_touring_2016_can_generated", "STEERING_CONTROL", {"STEER_TORQUE": 1200, "STEER_TORQUE_REQUEST": 1}),
+  ("honda_civic_touring_2016_can_generated", "LKAS_HUD", {"SET_ME_X41": 0x41, "STEERING_REQUIRED": 0, "SOLID_LANES": 1}),
+]
+
+
+if __name__ == "__main__":
+  parser = argparse.ArgumentParser(description="CANPacker make_can_msg throughput")
+  parser.add_argument("--rounds", type=int, default=5)
+  parser.add_argument("--count", type=int, default=100000)
+  args = parser.parse_args()
+
+  packers = {dbc: CANPacker(dbc) for dbc, _, _ in MESSAGES}
+  msgs = [(packers[dbc], name, values) for dbc, name, values in MESSAGES]
+
+  best = float("inf")
+  for _ in range(args.rounds):
+    t = time.process_time()
+    for _ in range(args.count):
+      for packer, name, values in msgs:
+        packer.make_can_msg(name, 0, values)
+    best = min(best, time.process_time() - t)
+
+  n = args.count * len(msgs)
+  print(f"{n} messages, {len(msgs)} per cycle")
+  print(f"{n / best:.0f} messages/s, {best / n * 1e9:.0f} ns/message")
@@ -0,0 +1,54 @@
+#!/usr/bin/env python3
+import argparse
+import os
+import re
+import time
+
+from opendbc import DBC_PATH
+from opendbc.can.parser import CANParser
+from openpilot.tools.lib.logreader import LogReader
+
+# Replays the `can` messages of a route through CANParser, checking every message
+# of the DBC that shows up on the bus, and reports how many frames/s it parses.
+# usage: benchmark_parser.py <route or segment> <dbc> [--bus N]
+
+
+def dbc_addresses(dbc_name):
+  with open(os.path.join(DBC_PATH, dbc_name + ".dbc")) as f:
+    return {int(m.group(1)) for m in re.finditer(r"^BO_ (\d+) ", f.read(), re.MULTILINE)}
+
+
+if __name__ == "__main__":
+  parser = argparse.ArgumentParser(description="CANParser throughput on a recorded route")
+  parser.add_argument("route", help="route, segment or rlog path")
+  parser.add_argument("dbc", help="DBC name, e.g. toyota_nodsu_pt_generated")
+  parser.add_argument("--bus", type=int, default=0)
+  parser.add_argument("--rounds", type=int, default=5)
+  args = parser.parse_args()
+
+  addresses = dbc_addresses(args.dbc)
+  seen = set()
+  events = []
+  frames = 0
+  for msg in LogReader(args.route):
+    if msg.which() == "can":
+      for c in msg.can:
+        if c.src == args.bus:
+          frames += 1
+          if c.address in addresses:
+            seen.add(c.address)
+      events.append(msg.as_builder().to_bytes())
+
+  if not events:
+    raise SystemExit("no can messages in route")
+
+  best = float("inf")
+  for _ in range(args.rounds):
+    cp = CANParser(args.dbc, [(addr, 0) for addr in sorted(seen)], args.bus)
+    t = time.process_time()
+    for e in events:
+      cp.update_strings([e])
+    best = min(best, time.process_time() - t)
+
+  print(f"{len(events)} can messages, {frames} frames on bus {args.bus}, {len(seen)} messages checked")
+  print(f"{frames / best:.0f} frames/s, {best / len(events) * 1e6:.1f} us/update")
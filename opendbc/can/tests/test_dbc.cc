@@ -0,0 +1,230 @@
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "opendbc/can/common.h"
+// common.h's log macros, catch has its own
+#undef INFO
+#undef WARN
+#include "catch2/catch.hpp"
+
+namespace {
+
+// The fields the regular expressions the tokenizer replaced extract from each line
+struct RegexDBC {
+  std::vector<std::vector<std::string>> bo, sg, val;
+};
+
+RegexDBC regex_parse(const std::string &content) {
+  static const std::regex bo_regexp(R"(^BO_ (\w+) (\w+) *: (\w+) (\w+))");
+  static const std::regex sg_regexp(R"(^SG_ (\w+) : (\d+)\|(\d+)@(\d+)([\+|\-]) \(([0-9.+\-eE]+),([0-9.+\-eE]+)\) \[([0-9.+\-eE]+)\|([0-9.+\-eE]+)\] \"(.*)\" (.*))");
+  static const std::regex sgm_regexp(R"(^SG_ (\w+) (\w+) *: (\d+)\|(\d+)@(\d+)([\+|\-]) \(([0-9.+\-eE]+),([0-9.+\-eE]+)\) \[([0-9.+\-eE]+)\|([0-9.+\-eE]+)\] \"(.*)\" (.*))");
+  static const std::regex val_regexp(R"(VAL_ (\w+) (\w+) (\s*[-+]?[0-9]+\s+\".+?\"[^;]*))");
+
+  RegexDBC ret;
+  std::istringstream stream(content);
+  std::string line;
+  std::smatch match;
+  while (std::getline(stream, line)) {
+    line.erase(line.find_last_not_of(" \t\n\r\f\v") + 1);
+    line.erase(0, line.find_first_not_of(" \t\n\r\f\v"));
+    if (line.rfind("BO_ ", 0) == 0) {
+      REQUIRE(std::regex_match(line, match, bo_regexp));
+      ret.bo.push_back({match[1], match[2], match[3]});
+    } else if (line.rfind("SG_ ", 0) == 0) {
+      int offset = 0;
+      if (!std::regex_search(line, match, sg_regexp)) {
+        REQUIRE(std::regex_search(line, match, sgm_regexp));
+        offset = 1;
+      }
+      ret.sg.push_back({match[1]});
+      for (int i = 2; i <= 7; ++i) ret.sg.back().push_back(match[offset + i]);
+    } else if (line.rfind("VAL_ ", 0) == 0) {
+      REQUIRE(std::regex_search(line, match, val_regexp));
+      ret.val.push_back({match[1], match[2]});
+    }
+  }
+  return ret;
+}
+
+std::string file_contents(const std::string &path) {
+  std::ifstream f(path);
+  return {std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>()};
+}
+
+void require_same(const DBC &a, const DBC &b) {
+  REQUIRE(a.name == b.name);
+  REQUIRE(a.msgs.size() == b.msgs.size());
+  for (size_t i = 0; i < a.msgs.size(); ++i) {
+    REQUIRE(a.msgs[i].name == b.msgs[i].name);
+    REQUIRE(a.msgs[i].address == b.msgs[i].address);
+    REQUIRE(a.msgs[i].size == b.msgs[i].size);
+    REQUIRE(a.msgs[i].sigs.size() == b.msgs[i].sigs.size());
+    for (size_t j = 0; j < a.msgs[i].sigs.size(); ++j) {
+      const Signal &x = a.msgs[i].sigs[j], &y = b.msgs[i].sigs[j];
+      REQUIRE(x.name == y.name);
+      REQUIRE((x.start_bit == y.start_bit && x.msb == y.msb && x.lsb == y.lsb && x.size == y.size));
+      REQUIRE((x.factor == y.factor && x.offset == y.offset && x.type == y.type));
+      REQUIRE((x.is_signed == y.is_signed && x.is_little_endian == y.is_little_endian));
+      REQUIRE(x.calc_checksum == y.calc_checksum);
+    }
+  }
+  REQUIRE(a.vals.size() == b.vals.size());
+  for (size_t i = 0; i < a.vals.size(); ++i) {
+    REQUIRE(a.vals[i].name == b.vals[i].name);
+    REQUIRE(a.vals[i].address == b.vals[i].address);
+    REQUIRE(a.vals[i].def_val == b.vals[i].def_val);
+  }
+}
+
+// A temporary cache directory for one test case
+struct TestCacheDir {
+  TestCacheDir() {
+    char tmp[] = "/tmp/dbc_cache_XXXXXX";
+    path = mkdtemp(tmp);
+    setenv("DBC_CACHE_DIR", path.c_str(), 1);
+  }
+  ~TestCacheDir() {
+    unsetenv("DBC_CACHE_DIR");
+    std::filesystem::remove_all(path);
+  }
+  std::vector<std::string> files() const {
+    std::vector<std::string> ret;
+    for (const auto &entry : std::filesystem::directory_iterator(path)) ret.push_back(entry.path());
+    return ret;
+  }
+  std::string path;
+};
+
+}  // namespace
+
+TEST_CASE("tokenizer parses every DBC like the regular expressions") {
+  const std::vector<std::string> names = get_dbc_names();
+  REQUIRE(names.size() > 20);
+
+  for (const auto &name : names) {
+    CAPTURE(name);
+    const std::string content = file_contents(get_dbc_root_path() + "/" + name + ".dbc");
+    const RegexDBC expected = regex_parse(content);
+
+    std::istringstream stream(content);
+    std::unique_ptr<DBC> dbc(dbc_parse_from_stream(name, stream, nullptr, true));
+    REQUIRE(dbc->msgs.size() == expected.bo.size());
+    size_t sg = 0;
+    for (size_t i = 0; i < dbc->msgs.size(); ++i) {
+      const Msg &msg = dbc->msgs[i];
+      REQUIRE(msg.address == std::stoul(expected.bo[i][0]));
+      REQUIRE(msg.name == expected.bo[i][1]);
+      REQUIRE(msg.size == std::stoul(expected.bo[i][2]));
+      for (const Signal &sig : msg.sigs) {
+        REQUIRE(sg < expected.sg.size());
+        const auto &m = expected.sg[sg++];
+        REQUIRE(sig.name == m[0]);
+        REQUIRE(sig.start_bit == std::stoi(m[1]));
+        REQUIRE(sig.size == std::stoi(m[2]));
+        REQUIRE(sig.is_little_endian == (std::stoi(m[3]) == 1));
+        REQUIRE(sig.is_signed == (m[4] == "-"));
+        REQUIRE(sig.factor == std::stod(m[5]));
+        REQUIRE(sig.offset == std::stod(m[6]));
+      }
+    }
+    REQUIRE(sg == expected.sg.size());
+    REQUIRE(dbc->vals.size() == expected.val.size());
+    for (size_t i = 0; i < dbc->vals.size(); ++i) {
+      REQUIRE(dbc->vals[i].address == std::stoul(expected.val[i][0]));
+      REQUIRE(dbc->vals[i].name == expected.val[i][1]);
+    }
+  }
+}
+
+TEST_CASE("dbc cache") {
+  TestCacheDir cache;
+  const std::string name = "honda_civic_touring_2016_can_generated";
+  const std::string path = get_dbc_root_path() + "/" + name + ".dbc";
+  std::unique_ptr<DBC> parsed(dbc_parse(path));
+  REQUIRE(cache.files().size() == 1);
+  const std::string cache_file = cache.files()[0];
+  const std::string good = file_contents(cache_file);
+
+  SECTION("loads what was parsed") {
+    std::unique_ptr<DBC> loaded(dbc_parse(path));
+    require_same(*loaded, *parsed);
+  }
+
+  SECTION("a truncated file is rejected and rebuilt") {
+    for (size_t size : {(size_t)0, (size_t)16, good.size() / 2, good.size() - 1}) {
+      REQUIRE(truncate(cache_file.c_str(), size) == 0);
+      std::unique_ptr<DBC> loaded(dbc_parse(path));
+      require_same(*loaded, *parsed);
+      REQUIRE(file_contents(cache_file) == good);
+    }
+  }
+
+  SECTION("a corrupt file is rejected and rebuilt") {
+    for (size_t pos : {good.size() / 3, good.size() / 2, good.size() - 1}) {
+      std::string corrupt = good;
+      corrupt[pos] ^= 0x5a;
+      std::ofstream(cache_file, std::ios::binary | std::ios::trunc) << corrupt;
+      std::unique_ptr<DBC> loaded(dbc_parse(path));
+      require_same(*loaded, *parsed);
+      REQUIRE(file_contents(cache_file) == good);
+    }
+  }
+
+  SECTION("a file of another version is ignored") {
+    // the version follows the 4 byte magic
+    std::string stale = good;
+    uint32_t version;
+    memcpy(&version, &stale[4], sizeof(version));
+    version -= 1;
+    memcpy(&stale[4], &version, sizeof(version));
+    std::ofstream(cache_file, std::ios::binary | std::ios::trunc) << stale;
+    std::unique_ptr<DBC> loaded(dbc_parse(path));
+    require_same(*loaded, *parsed);
+    REQUIRE(file_contents(cache_file) == good);
+  }
+
+  SECTION("other builds keep their entries until they are old") {
+    // an older version stored by this build, and entries of two other builds
+    // <dbc file name>.<build>.<key>
+    const std::string build_prefix = cache_file.substr(0, cache_file.size() - 16);
+    const std::string dbc_prefix = cache_file.substr(0, cache_file.size() - 33);
+    const std::string same_build = build_prefix + "0000000000000001";
+    const std::string other_build = dbc_prefix + "0000000000000002.0000000000000003";
+    const std::string old_build = dbc_prefix + "0000000000000004.0000000000000005";
+    for (const std::string &f : {same_build, other_build, old_build}) {
+      std::ofstream(f, std::ios::binary) << good;
+    }
+    std::filesystem::last_write_time(old_build, std::filesystem::file_time_type::clock::now() - std::chrono::hours(24 * 8));
+
+    // a miss stores the entry again
+    REQUIRE(unlink(cache_file.c_str()) == 0);
+    std::unique_ptr<DBC> loaded(dbc_parse(path));
+    require_same(*loaded, *parsed);
+    REQUIRE(std::filesystem::exists(cache_file));
+    REQUIRE(!std::filesystem::exists(same_build));
+    REQUIRE(std::filesystem::exists(other_build));
+    REQUIRE(!std::filesystem::exists(old_build));
+  }
+
+  SECTION("the key depends on the checksum settings") {
+    const std::string content = file_contents(path);
+    ChecksumState honda = {4, 2, 3, 5, false, HONDA_CHECKSUM, &honda_checksum};
+    ChecksumState other = honda;
+    other.checksum_start_bit = 4;
+    const uint64_t key = dbc_cache_key(name, content, &honda);
+    REQUIRE(key != dbc_cache_key(name, content, nullptr));
+    REQUIRE(key != dbc_cache_key(name, content, &other));
+    REQUIRE(key == dbc_cache_key(name, content, &honda));
+    REQUIRE(key != dbc_cache_key(name, content + "\n", &honda));
+  }
+}
@@ -3,7 +3,7 @@ import unittest
 import random
 
 import cereal.messaging as messaging
-from opendbc.can.parser import CANParser
+from opendbc.can.parser import CANParser, CANParserGroup
 from opendbc.can.packer import CANPacker
 from opendbc.can.tests import TEST_DBC
 
@@ -43,6 +43,16 @@ class TestCanParserPacker(unittest.TestCase):
         self.assertEqual(bus, b)
         self.assertEqual(dat[0], i)
 
+  def test_packer_by_address(self):
+    packer = CANPacker(TEST_DBC)
+    values = {"COUNTER": 3, "SIGNED": -100, "64_BIT_LE": 2**40 + 5}
+    by_name = packer.make_can_msg("CAN_FD_MESSAGE", 0, values)
+    by_address = packer.make_can_msg(245, 0, values)
+    self.assertEqual(by_name, by_address)
+
+    with self.assertRaises(KeyError):
+      packer.make_can_msg("NON_EXISTENT_MESSAGE", 0, {})
+
   def test_packer_counter(self):
     msgs = [("CAN_FD_MESSAGE", 0), ]
     packer = CANPacker(TEST_DBC)
@@ -60,6 +70,7 @@ class TestCanParserPacker(unittest.TestCase):
       cnt = random.randint(0, 255)
       msg = packer.make_can_msg("CAN_FD_MESSAGE", 0, {
         "COUNTER": cnt,
+        "SIGNED": -cnt,
       })
       dat = can_list_to_can_capnp([msg, ])
       parser.update_strings([dat])
@@ -372,6 +383,38 @@ class TestCanParserPacker(unittest.TestCase):
       "CHECKSUM": 0,
     })
 
+  def test_parser_group(self):
+    msgs = [("STEERING_CONTROL", 0), ("CAN_FD_MESSAGE", 0)]
+    packer = CANPacker(TEST_DBC)
+    parsers = [CANParser(TEST_DBC, msgs, 0), None, CANParser(TEST_DBC, msgs, 1)]
+    group = CANParserGroup(parsers)
+    single = [CANParser(TEST_DBC, msgs, 0), CANParser(TEST_DBC, msgs, 1)]
+    self.assertEqual(len(group.parsers), 2)
+
+    for i in range(100):
+      steer = i // 10
+      can_msgs = [packer.make_can_msg("STEERING_CONTROL", bus, {"STEER_TORQUE": steer + bus}) for bus in (0, 1, 2)]
+      can_msgs.append(packer.make_can_msg("CAN_FD_MESSAGE", 0, {"SIGNED": -steer}))
+      dat = can_list_to_can_capnp(can_msgs, logMonoTime=int(0.01 * i * 1e9))
+
+      updated = group.update_strings([dat])
+      for cp in single:
+        cp.update_strings([dat])
+      self.assertEqual(updated, [{228, 245}, {228}])
+
+      for p, s in zip(group.parsers, single, strict=True):
+        self.assertEqual(p.vl, s.vl)
+        self.assertEqual(p.vl_all, s.vl_all)
+        self.assertEqual(p.ts_nanos, s.ts_nanos)
+        self.assertEqual(p.can_valid, s.can_valid)
+        self.assertEqual(p.bus_timeout, s.bus_timeout)
+      self.assertEqual(group.parsers[0].vl_all["STEERING_CONTROL"]["STEER_TORQUE"], [steer])
+
+    # every sample is kept, also a value that changes and changes back in one update
+    can_msgs = [packer.make_can_msg("STEERING_CONTROL", 0, {"STEER_TORQUE": v}) for v in (1, 0)]
+    group.update_strings([can_list_to_can_capnp(can_msgs, logMonoTime=int(1e9))])
+    self.assertEqual(group.parsers[0].vl_all["STEERING_CONTROL"]["STEER_TORQUE"], [1, 0])
+
   def test_disallow_duplicate_messages(self):
     CANParser("toyota_nodsu_pt_generated", [("ACC_CONTROL", 5)])
 
@@ -7,6 +7,7 @@
 #include <cassert>
 #include <cerrno>
 #include <chrono>
+#include <cstring>
 #include <future>
 #include <memory>
 #include <thread>
@@ -43,6 +44,11 @@
 #define MIN_IR_POWER 0.0f
 #define CUTOFF_IL 400
 #define SATURATE_IL 1000
+
+// words of the can message per panda: a full receive buffer of 8 byte frames
+// (14 bytes each with the header), 3 words per frame for the list element and data
+#define CAN_RECV_SEGMENT_WORDS (RECV_SIZE / 14 * 3 + 64)
+
 using namespace std::chrono_literals;
 
 std::atomic<bool> ignition(false);
@@ -173,15 +179,24 @@ void can_send_thread(std::vector<Panda *> pandas, bool fake_send) {
 
   // run as fast as messages come in
   while (!do_exit && check_all_connected(pandas)) {
-    std::unique_ptr<Message> msg(subscriber->receive());
-    if (!msg) {
+    const char *data = nullptr;
+    size_t size = subscriber->receiveBorrow(&data);
+    if (size == 0) {
       if (errno == EINTR) {
         do_exit = true;
       }
+      subscriber->releaseBorrow();
+      continue;
+    }
+
+    // copy once out of the socket, skip the message if it was overwritten while copying
+    auto words = aligned_buf.align(data, size);
+    if (!subscriber->releaseBorrow()) {
+      LOGE("sendcan overwritten while receiving");
       continue;
     }
 
-    capnp::FlatArrayMessageReader cmsg(aligned_buf.align(msg.get()));
+    capnp::FlatArrayMessageReader cmsg(words);
     cereal::Event::Reader event = cmsg.getRoot<cereal::Event>();
 
     // Don't send if older than 1 second
@@ -197,33 +212,95 @@ void can_send_thread(std::vector<Panda *> pandas, bool fake_send) {
   }
 }
 
+// Histogram of how old the received frames are when they are published. The panda doesn't
+// timestamp frames, a frame got by a read arrived after the read before it, which bounds its age.
+class CanAgeHistogram {
+public:
+  void add(uint64_t age_ns, uint32_t frames) {
+    int i = 0;
+    while (i < std::size(BUCKETS_MS) && age_ns >= BUCKETS_MS[i] * 1e6) ++i;
+    counts[i] += frames;
+    total_frames += frames;
+    total_age_ns += age_ns * frames;
+  }
+
+  void log(const char *mode) {
+    if (total_frames == 0) return;
+    std::string buckets;
+    for (int i = 0; i < counts.size(); ++i) {
+      buckets += i < std::size(BUCKETS_MS) ? util::string_format(" <%dms:%" PRIu64, BUCKETS_MS[i], counts[i])
+                                           : util::string_format(" >=%dms:%" PRIu64, BUCKETS_MS[i - 1], counts[i]);
+    }
+    LOG("can frame age (%s): %" PRIu64 " frames, mean bound %.2fms,%s", mode, total_frames,
+        total_age_ns / 1e6 / total_frames, buckets.c_str());
+    *this = {};
+  }
+
+private:
+  static constexpr int BUCKETS_MS[] = {1, 2, 5, 10, 20, 50};
+  std::array<uint64_t, std::size(BUCKETS_MS) + 1> counts = {};
+  uint64_t total_frames = 0;
+  double total_age_ns = 0;
+};
+
 void can_recv_thread(std::vector<Panda *> pandas) {
   util::set_thread_name("boardd_can_recv");
 
   PubMaster pm({"can"});
 
-  // run at 100Hz
-  RateKeeper rk("boardd_can_recv", 100);
-  std::vector<can_frame> raw_can_data;
+  // By default the pandas are read and a can message is published at 100Hz. BOARDD_CAN_RECV_HZ reads
+  // them faster, frames wait at most one read period instead of 10ms. Then only batches with frames
+  // are published, and an empty one when nothing was published for 10ms.
+  const float rate = std::max(100.f, util::getenv("BOARDD_CAN_RECV_HZ", 100.f));
+  const bool adaptive = rate > 100.f;
+  const char *mode = adaptive ? "adaptive" : "fixed";
+  LOGW("can recv %s at %.0fHz", mode, rate);
+  RateKeeper rk("boardd_can_recv", rate);
+
+  // Every can message is built in this segment, the frames are written straight from the
+  // receive buffers into it. It fits a full receive buffer of classic CAN frames of every
+  // panda, a bigger message spills over to the heap.
+  kj::Array<capnp::word> segment = kj::heapArray<capnp::word>(CAN_RECV_SEGMENT_WORDS * pandas.size());
+  memset(segment.begin(), 0, segment.asBytes().size());
+
+  CanAgeHistogram frame_age;
+  uint64_t last_read_ns = nanos_since_boot();
+  uint64_t last_publish_ns = 0;
+  uint64_t last_log_ns = last_read_ns;
 
   while (!do_exit && check_all_connected(pandas)) {
+    const uint64_t read_ns = nanos_since_boot();
     bool comms_healthy = true;
-    raw_can_data.clear();
+    uint32_t frames_cnt = 0;
     for (const auto& panda : pandas) {
-      comms_healthy &= panda->can_receive(raw_can_data);
+      comms_healthy &= panda->can_receive();
+      frames_cnt += panda->can_receive_cnt();
+    }
+
+    if (!adaptive || frames_cnt > 0 || !comms_healthy || read_ns - last_publish_ns >= 10e6) {
+      MessageBuilder msg(segment);
+      auto evt = msg.initEvent();
+      evt.setValid(comms_healthy);
+      auto canData = evt.initCan(frames_cnt);
+      uint32_t offset = 0;
+      for (const auto& panda : pandas) {
+        uint32_t cnt = panda->can_receive_cnt();
+        panda->can_unpack(canData, offset);
+        offset += cnt;
+      }
+      pm.send("can", msg);
+
+      last_publish_ns = nanos_since_boot();
+      if (frames_cnt > 0) {
+        frame_age.add(last_publish_ns - last_read_ns, frames_cnt);
+      }
     }
+    last_read_ns = read_ns;
 
-    MessageBuilder msg;
-    auto evt = msg.initEvent();
-    evt.setValid(comms_healthy);
-    auto canData = evt.initCan(raw_can_data.size());
-    for (uint i = 0; i<raw_can_data.size(); i++) {
-      canData[i].setAddress(raw_can_data[i].address);
-      canData[i].setBusTime(raw_can_data[i].busTime);
-      canData[i].setDat(kj::arrayPtr((uint8_t*)raw_can_data[i].dat.data(), raw_can_data[i].dat.size()));
-      canData[i].setSrc(raw_can_data[i].src);
+    if (read_ns - last_log_ns >= 60e9) {
+      frame_age.log(mode);
+      last_log_ns = read_ns;
     }
-    pm.send("can", msg);
 
     rk.keepTime();
   }
@@ -499,6 +576,8 @@ void peripheral_control_thread(Panda *panda, bool no_fan_control) {
   util::set_thread_name("boardd_peripheral_control");
 
   SubMaster sm({"deviceState", "driverCameraState"});
+  const size_t device_state = sm.index("deviceState");
+  const size_t driver_camera_state = sm.index("driverCameraState");
 
   uint64_t last_driver_camera_t = 0;
   uint16_t prev_fan_speed = 999;
@@ -510,17 +589,17 @@ void peripheral_control_thread(Panda *panda, bool no_fan_control) {
   while (!do_exit && panda->connected()) {
     sm.update(1000);
 
-    if (sm.updated("deviceState") && !no_fan_control) {
+    if (sm.updated(device_state) && !no_fan_control) {
       // Fan speed
-      uint16_t fan_speed = sm["deviceState"].getDeviceState().getFanSpeedPercentDesired();
+      uint16_t fan_speed = sm[device_state].getDeviceState().getFanSpeedPercentDesired();
       if (fan_speed != prev_fan_speed || sm.frame % 100 == 0) {
         panda->set_fan_speed(fan_speed);
         prev_fan_speed = fan_speed;
       }
     }
 
-    if (sm.updated("driverCameraState")) {
-      auto event = sm["driverCameraState"];
+    if (sm.updated(driver_camera_state)) {
+      auto event = sm[driver_camera_state];
       int cur_integ_lines = event.getDriverCameraState().getIntegLines();
 
       cur_integ_lines = integ_lines_filter.update(cur_integ_lines);
@@ -212,7 +212,7 @@ void Panda::can_send(capnp::List<cereal::CanData>::Reader can_data_list) {
   });
 }
 
-bool Panda::can_receive(std::vector<can_frame>& out_vec) {
+bool Panda::can_receive() {
   // Check if enough space left in buffer to store RECV_SIZE data
   assert(receive_buffer_size + RECV_SIZE <= sizeof(receive_buffer));
 
@@ -223,19 +223,35 @@ bool Panda::can_receive(std::vector<can_frame>& out_vec) {
   if (recv == RECV_SIZE) {
     LOGW("Panda receive buffer full");
   }
-  receive_buffer_size += recv;
+  if (recv > 0) {
+    receive_buffer_size += recv;
+  }
+
+  if (!scan_can_buffer(receive_buffer, receive_buffer_size, receive_frames_cnt, receive_frames_size)) {
+    // TODO: also reset CAN comms?
+    // keep the frames before the bad one, drop everything after it
+    receive_buffer_size = receive_frames_size;
+    return false;
+  }
+  return true;
+}
 
-  return (recv <= 0) ? true : unpack_can_buffer(receive_buffer, receive_buffer_size, out_vec);
+void Panda::can_unpack(capnp::List<cereal::CanData>::Builder &out, uint32_t offset) {
+  unpack_can_buffer(receive_buffer, receive_buffer_size, receive_frames_size, out, offset);
+  receive_frames_cnt = 0;
+  receive_frames_size = 0;
 }
 
 void Panda::can_reset_communications() {
   handle->control_write(0xc0, 0, 0);
 }
 
-bool Panda::unpack_can_buffer(uint8_t *data, uint32_t &size, std::vector<can_frame> &out_vec) {
-  int pos = 0;
+bool Panda::scan_can_buffer(const uint8_t *data, uint32_t size, uint32_t &frames_cnt, uint32_t &frames_size) {
+  uint32_t pos = 0;
+  bool ret = true;
+  frames_cnt = 0;
 
-  while (pos <= size - sizeof(can_header)) {
+  while (size - pos >= sizeof(can_header)) {
     can_header header;
     memcpy(&header, &data[pos], sizeof(can_header));
 
@@ -246,36 +262,47 @@ bool Panda::unpack_can_buffer(uint8_t *data, uint32_t &size, std::vector<can_fra
     }
 
     if (calculate_checksum(&data[pos], sizeof(can_header) + data_len) != 0) {
-      // TODO: also reset CAN comms?
       LOGE("Panda CAN checksum failed");
-      size = 0;
-      return false;
+      ret = false;
+      break;
     }
 
-    can_frame &canData = out_vec.emplace_back();
-    canData.busTime = 0;
-    canData.address = header.addr;
-    canData.src = header.bus + bus_offset;
+    pos += sizeof(can_header) + data_len;
+    frames_cnt++;
+  }
+
+  frames_size = pos;
+  return ret;
+}
+
+void Panda::unpack_can_buffer(uint8_t *data, uint32_t &size, uint32_t frames_size,
+                              capnp::List<cereal::CanData>::Builder &out, uint32_t offset) {
+  for (uint32_t pos = 0; pos < frames_size; ++offset) {
+    can_header header;
+    memcpy(&header, &data[pos], sizeof(can_header));
+    const uint8_t data_len = dlc_to_len[header.data_len_code];
+
+    auto canData = out[offset];
+    canData.setAddress(header.addr);
+    uint8_t src = header.bus + bus_offset;
     if (header.rejected) {
-      canData.src += CAN_REJECTED_BUS_OFFSET;
+      src += CAN_REJECTED_BUS_OFFSET;
     }
     if (header.returned) {
-      canData.src += CAN_RETURNED_BUS_OFFSET;
+      src += CAN_RETURNED_BUS_OFFSET;
     }
-
-    canData.dat.assign((char *)&data[pos + sizeof(can_header)], data_len);
+    canData.setSrc(src);
+    canData.setDat(kj::arrayPtr(&data[pos + sizeof(can_header)], data_len));
 
     pos += sizeof(can_header) + data_len;
   }
 
   // move the overflowing data to the beginning of the buffer for the next round
-  memmove(data, &data[pos], size - pos);
-  size -= pos;
-
-  return true;
+  memmove(data, &data[frames_size], size - frames_size);
+  size -= frames_size;
 }
 
-uint8_t Panda::calculate_checksum(uint8_t *data, uint32_t len) {
+uint8_t Panda::calculate_checksum(const uint8_t *data, uint32_t len) {
   uint8_t checksum = 0U;
   for (uint32_t i = 0U; i < len; i++) {
     checksum ^= data[i];
@@ -79,17 +79,30 @@ public:
   void set_data_speed_kbps(uint16_t bus, uint16_t speed);
   void set_canfd_non_iso(uint16_t bus, bool non_iso);
   void can_send(capnp::List<cereal::CanData>::Reader can_data_list);
-  bool can_receive(std::vector<can_frame>& out_vec);
+  // Reads the pending CAN data. The complete frames stay in the receive buffer until
+  // can_unpack, can_receive_cnt() tells how many there are. false on a comms error or bad checksum.
+  bool can_receive();
+  uint32_t can_receive_cnt() const { return receive_frames_cnt; }
+  // Writes the received frames straight into out[offset, offset + can_receive_cnt())
+  void can_unpack(capnp::List<cereal::CanData>::Builder &out, uint32_t offset);
   void can_reset_communications();
 
 protected:
   // for unit tests
   uint8_t receive_buffer[RECV_SIZE + sizeof(can_header) + 64];
   uint32_t receive_buffer_size = 0;
+  uint32_t receive_frames_cnt = 0;
+  uint32_t receive_frames_size = 0;
 
   Panda(uint32_t bus_offset) : bus_offset(bus_offset) {}
   void pack_can_buffer(const capnp::List<cereal::CanData>::Reader &can_data_list,
                          std::function<void(uint8_t *, size_t)> write_func);
-  bool unpack_can_buffer(uint8_t *data, uint32_t &size, std::vector<can_frame> &out_vec);
-  uint8_t calculate_checksum(uint8_t *data, uint32_t len);
+  // Counts the complete frames at the start of data and their size in bytes.
+  // false if a checksum failed, only the frames before the bad one are counted.
+  bool scan_can_buffer(const uint8_t *data, uint32_t size, uint32_t &frames_cnt, uint32_t &frames_size);
+  // Writes the frames in the first frames_size bytes of data to out, starting at offset,
+  // and moves the rest to the beginning of the buffer
+  void unpack_can_buffer(uint8_t *data, uint32_t &size, uint32_t frames_size,
+                         capnp::List<cereal::CanData>::Builder &out, uint32_t offset);
+  uint8_t calculate_checksum(const uint8_t *data, uint32_t len);
 };
@@ -11,6 +11,8 @@ struct PandaTest : public Panda {
   void test_can_send();
   void test_can_recv(uint32_t chunk_size = 0);
   void test_chunked_can_recv();
+  void test_bad_checksum();
+  void benchmark_can_recv();
 
   std::map<int, std::string> test_data;
   int can_list_size = 0;
@@ -75,9 +77,23 @@ void PandaTest::test_can_send() {
 
 void PandaTest::test_can_recv(uint32_t rx_chunk_size) {
   std::vector<can_frame> frames;
+  auto unpack = [&](uint8_t *data, uint32_t &size) {
+    uint32_t frames_cnt = 0, frames_size = 0;
+    REQUIRE(this->scan_can_buffer(data, size, frames_cnt, frames_size));
+
+    MessageBuilder out;
+    auto can_list = out.initEvent().initCan(frames_cnt);
+    this->unpack_can_buffer(data, size, frames_size, can_list, 0);
+    for (auto can : can_list) {
+      auto dat = can.getDat();
+      frames.push_back({can.getAddress(), std::string((char *)dat.begin(), dat.size()), can.getBusTime(), can.getSrc()});
+    }
+  };
+
   this->pack_can_buffer(can_data_list, [&](uint8_t *data, uint32_t size) {
     if (rx_chunk_size == 0) {
-      REQUIRE(this->unpack_can_buffer(data, size, frames));
+      unpack(data, size);
+      REQUIRE(size == 0);
     } else {
       this->receive_buffer_size = 0;
       uint32_t pos = 0;
@@ -88,7 +104,7 @@ void PandaTest::test_can_recv(uint32_t rx_chunk_size) {
         this->receive_buffer_size += chunk_size;
         pos += chunk_size;
 
-        REQUIRE(this->unpack_can_buffer(this->receive_buffer, this->receive_buffer_size, frames));
+        unpack(this->receive_buffer, this->receive_buffer_size);
       }
     }
   });
@@ -96,12 +112,48 @@ void PandaTest::test_can_recv(uint32_t rx_chunk_size) {
   REQUIRE(frames.size() == can_list_size);
   for (int i = 0; i < frames.size(); ++i) {
     REQUIRE(frames[i].address == i);
+    REQUIRE(frames[i].src == can_data_list[i].getSrc());
     REQUIRE(test_data.find(frames[i].dat.size()) != test_data.end());
     const std::string &dat = test_data[frames[i].dat.size()];
     REQUIRE(memcmp(dat.data(), frames[i].dat.data(), dat.size()) == 0);
   }
 }
 
+void PandaTest::test_bad_checksum() {
+  std::vector<uint8_t> packed;
+  this->pack_can_buffer(can_data_list, [&](uint8_t *chunk, size_t size) {
+    packed.insert(packed.end(), chunk, &chunk[size]);
+  });
+
+  // corrupt the last frame, the ones before it are still counted
+  packed[packed.size() - 1] ^= 0xff;
+  uint32_t frames_cnt = 0, frames_size = 0;
+  REQUIRE_FALSE(this->scan_can_buffer(packed.data(), packed.size(), frames_cnt, frames_size));
+  REQUIRE(frames_cnt == can_list_size - 1);
+}
+
+void PandaTest::benchmark_can_recv() {
+  std::vector<uint8_t> packed;
+  this->pack_can_buffer(can_data_list, [&](uint8_t *chunk, size_t size) {
+    packed.insert(packed.end(), chunk, &chunk[size]);
+  });
+
+  // what boardd does every cycle: unpack the receive buffer into the reused segment and serialize it
+  kj::Array<capnp::word> segment = kj::heapArray<capnp::word>(0x4000);
+  memset(segment.begin(), 0, segment.asBytes().size());
+  BENCHMARK("unpack " + std::to_string(can_list_size) + " frames") {
+    memcpy(this->receive_buffer, packed.data(), packed.size());
+    this->receive_buffer_size = packed.size();
+    uint32_t frames_cnt = 0, frames_size = 0;
+    this->scan_can_buffer(this->receive_buffer, this->receive_buffer_size, frames_cnt, frames_size);
+
+    MessageBuilder out(segment);
+    auto can_list = out.initEvent().initCan(frames_cnt);
+    this->unpack_can_buffer(this->receive_buffer, this->receive_buffer_size, frames_size, can_list, 0);
+    return out.toBytes().size();
+  };
+}
+
 TEST_CASE("send/recv CAN 2.0 packets") {
   auto bus_offset = GENERATE(0, 4);
   auto can_list_size = GENERATE(1, 3, 5, 10, 30, 60, 100, 200);
@@ -133,3 +185,15 @@ TEST_CASE("send/recv CAN FD packets") {
     test.test_can_recv(0x40);
   }
 }
+
+TEST_CASE("bad CAN checksum") {
+  PandaTest test(0, 10, cereal::PandaState::PandaType::RED_PANDA);
+  test.test_bad_checksum();
+}
+
+TEST_CASE("can_recv benchmark", "[.][benchmark]") {
+  auto hw_type = GENERATE(cereal::PandaState::PandaType::DOS, cereal::PandaState::PandaType::RED_PANDA);
+  auto can_list_size = GENERATE(100, 200);
+  PandaTest test(0, can_list_size, hw_type);
+  test.benchmark_can_recv();
+}
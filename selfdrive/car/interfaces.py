@@ -10,6 +10,7 @@ from typing import Any, Callable, Dict, List, NamedTuple, Optional, Tuple, Union
 from collections.abc import Callable
 
 from cereal import car
+from opendbc.can.parser import CANParserGroup
 from openpilot.common.basedir import BASEDIR
 from openpilot.common.conversions import Conversions as CV
 from openpilot.common.simple_kalman import KF1D, get_kalman_gain
@@ -202,6 +203,7 @@ class CarInterfaceBase(ABC):
       self.cp_body = self.CS.get_body_can_parser(CP)
       self.cp_loopback = self.CS.get_loopback_can_parser(CP)
       self.can_parsers = [self.cp, self.cp_cam, self.cp_adas, self.cp_body, self.cp_loopback]
+    self.can_parser_group = CANParserGroup(self.can_parsers)
 
     self.CC = None
     if CarController is not None:
@@ -371,10 +373,8 @@ class CarInterfaceBase(ABC):
     pass
 
   def update(self, c: car.CarControl, can_strings: list[bytes], frogpilot_variables) -> car.CarState:
-    # parse can
-    for cp in self.can_parsers:
-      if cp is not None:
-        cp.update_strings(can_strings)
+    # parse can, one pass over the messages for all buses
+    self.can_parser_group.update_strings(can_strings)
 
     # get CarState
     ret, fp_ret = self._update(c, frogpilot_variables)
@@ -23,15 +23,25 @@ if __name__ == '__main__':
   tm.setUp()
 
   CC = car.CarControl.new_message()
-  ets = []
-  for _ in tqdm(range(N_RUNS)):
-    start_t = time.process_time_ns()
-    for msg in tm.can_msgs:
-      for cp in tm.CI.can_parsers:
-        if cp is not None:
-          cp.update_strings((msg.as_builder().to_bytes(),))
-    ets.append((time.process_time_ns() - start_t) * 1e-6)
+  can_strings = [msg.as_builder().to_bytes() for msg in tm.can_msgs]
+
+  def each_parser(s):
+    for cp in tm.CI.can_parsers:
+      if cp is not None:
+        cp.update_strings((s,))
+
+  def parser_group(s):
+    tm.CI.can_parser_group.update_strings((s,))
 
   print(f'{len(tm.can_msgs)} CAN packets, {N_RUNS} runs')
-  print(f'{np.mean(ets):.2f} mean ms, {max(ets):.2f} max ms, {min(ets):.2f} min ms, {np.std(ets):.2f} std ms')
-  print(f'{np.mean(ets) / len(tm.can_msgs):.4f} mean ms / CAN packet')
+  for name, update in (('each parser', each_parser), ('parser group', parser_group)):
+    ets = []
+    for _ in tqdm(range(N_RUNS)):
+      start_t = time.process_time_ns()
+      for s in can_strings:
+        update(s)
+      ets.append((time.process_time_ns() - start_t) * 1e-6)
+
+    print(name)
+    print(f'{np.mean(ets):.2f} mean ms, {max(ets):.2f} max ms, {min(ets):.2f} min ms, {np.std(ets):.2f} std ms')
+    print(f'{np.mean(ets) / len(tm.can_msgs):.4f} mean ms / CAN packet')
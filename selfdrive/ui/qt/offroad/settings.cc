@@ -448,6 +448,8 @@ DevicePanel::DevicePanel(SettingsWindow *parent) : ListWidget(parent) {
           std::string command = commandStream.str();
 
           int result = std::system(command.c_str());
+          // the files were replaced behind Params' back
+          params.reloadCache();
 
           if (result == 0) {
             std::cout << "Restore successful from " << sourcePath << " to " << targetPath << std::endl;
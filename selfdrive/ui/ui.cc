@@ -311,119 +311,120 @@ static void update_state(UIState *s) {
 }
 
 void ui_update_params(UIState *s) {
-  auto params = Params();
-  s->scene.is_metric = params.getBool("IsMetric");
-  s->scene.map_on_left = params.getBool("NavSettingLeftSide");
+  // kept around, so the decoded values are reused while the params don't change
+  static Params params;
+  s->scene.is_metric = params.get<ParamKey::IsMetric>();
+  s->scene.map_on_left = params.get<ParamKey::NavSettingLeftSide>();
 }
 
 void ui_update_frogpilot_params(UIState *s) {
-  Params params = Params();
+  static Params params;
   UIScene &scene = s->scene;
 
-  bool always_on_lateral = params.getBool("AlwaysOnLateral");
-  scene.show_aol_status_bar = always_on_lateral && !params.getBool("HideAOLStatusBar");
-
-  scene.conditional_experimental = scene.longitudinal_control && params.getBool("ConditionalExperimental");
-  scene.conditional_speed = scene.conditional_experimental ? params.getInt("CESpeed") : 0;
-  scene.conditional_speed_lead = scene.conditional_experimental ? params.getInt("CESpeedLead") : 0;
-  scene.show_cem_status_bar = scene.conditional_experimental && !params.getBool("HideCEMStatusBar");
-
-  bool custom_onroad_ui = params.getBool("CustomUI");
-  bool custom_paths = custom_onroad_ui && params.getBool("CustomPaths");
-  scene.acceleration_path = custom_paths && params.getBool("AccelerationPath");
-  scene.adjacent_path = custom_paths && params.getBool("AdjacentPath");
-  scene.adjacent_path_metrics = scene.adjacent_path && params.getBool("AdjacentPathMetrics");
-  scene.blind_spot_path = custom_paths && params.getBool("BlindSpotPath");
-  scene.compass = custom_onroad_ui && params.getBool("Compass");
-  scene.pedals_on_ui = custom_onroad_ui && params.getBool("PedalsOnUI");
-  scene.dynamic_pedals_on_ui = scene.pedals_on_ui && params.getBool("DynamicPedalsOnUI");
-  scene.static_pedals_on_ui = scene.pedals_on_ui && params.getBool("StaticPedalsOnUI");
-  scene.road_name_ui = custom_onroad_ui && params.getBool("RoadNameUI");
-  scene.rotating_wheel = custom_onroad_ui && params.getBool("RotatingWheel");
-  scene.wheel_icon = custom_onroad_ui ? params.getInt("WheelIcon") : 0;
-
-  bool custom_theme = params.getBool("CustomTheme");
-  scene.custom_colors = custom_theme ? params.getInt("CustomColors") : 0;
-  scene.custom_icons = custom_theme ? params.getInt("CustomIcons") : 0;
-  scene.custom_signals = custom_theme ? params.getInt("CustomSignals") : 0;
-  scene.holiday_themes = custom_theme && params.getBool("HolidayThemes");
-  scene.random_events = custom_theme && params.getBool("RandomEvents");
-
-  bool developer_ui = params.getBool("DeveloperUI");
-  bool border_metrics = developer_ui && params.getBool("BorderMetrics");
-  scene.show_blind_spot = border_metrics && params.getBool("BlindSpotMetrics");
-  scene.show_signal = border_metrics && params.getBool("SignalMetrics");
-  scene.show_steering = border_metrics && params.getBool("ShowSteering");
-  scene.fps_counter = developer_ui && params.getBool("FPSCounter");
-  scene.lead_info = scene.longitudinal_control && developer_ui && params.getBool("LongitudinalMetrics");
-  scene.numerical_temp = developer_ui && params.getBool("NumericalTemp");
-  scene.fahrenheit = scene.numerical_temp && params.getBool("Fahrenheit");
-  scene.show_jerk = scene.longitudinal_control && developer_ui && params.getBool("LongitudinalMetrics");
-  scene.show_tuning = developer_ui && scene.has_auto_tune && params.getBool("LateralMetrics");
-  scene.sidebar_metrics = developer_ui && params.getBool("SidebarMetrics");
-  scene.is_CPU = scene.sidebar_metrics && params.getBool("ShowCPU");
-  scene.is_GPU = scene.sidebar_metrics && params.getBool("ShowGPU");
-  scene.is_IP = scene.sidebar_metrics && params.getBool("ShowIP");
-  scene.is_memory = scene.sidebar_metrics && params.getBool("ShowMemoryUsage");
-  scene.is_storage_left = scene.sidebar_metrics && params.getBool("ShowStorageLeft");
-  scene.is_storage_used = scene.sidebar_metrics && params.getBool("ShowStorageUsed");
-  scene.use_si = developer_ui && params.getBool("UseSI");
-
-  scene.disable_smoothing_mtsc = params.getBool("MTSCEnabled") && params.getBool("DisableMTSCSmoothing");
-  scene.disable_smoothing_vtsc = params.getBool("VisionTurnControl") && params.getBool("DisableVTSCSmoothing");
-
-  bool driving_personalities = scene.longitudinal_control && params.getBool("DrivingPersonalities");
-  scene.onroad_distance_button = driving_personalities && params.getBool("OnroadDistanceButton");
-  scene.use_kaofui_icons = scene.onroad_distance_button && params.getBool("KaofuiIcons");
-
-  scene.experimental_mode_via_screen = scene.longitudinal_control && params.getBool("ExperimentalModeActivation") && params.getBool("ExperimentalModeViaTap");
-
-  bool lane_detection = params.getBool("NudgelessLaneChange") && params.getInt("LaneDetectionWidth") != 0;
-  scene.lane_detection_width = lane_detection ? params.getInt("LaneDetectionWidth") * (scene.is_metric ? 1 : FOOT_TO_METER) / 10.0f : 2.75f;
-
-  bool longitudinal_tune = scene.longitudinal_control && params.getBool("LongitudinalTune");
+  bool always_on_lateral = params.get<ParamKey::AlwaysOnLateral>();
+  scene.show_aol_status_bar = always_on_lateral && !params.get<ParamKey::HideAOLStatusBar>();
+
+  scene.conditional_experimental = scene.longitudinal_control && params.get<ParamKey::ConditionalExperimental>();
+  scene.conditional_speed = scene.conditional_experimental ? params.get<ParamKey::CESpeed>() : 0;
+  scene.conditional_speed_lead = scene.conditional_experimental ? params.get<ParamKey::CESpeedLead>() : 0;
+  scene.show_cem_status_bar = scene.conditional_experimental && !params.get<ParamKey::HideCEMStatusBar>();
+
+  bool custom_onroad_ui = params.get<ParamKey::CustomUI>();
+  bool custom_paths = custom_onroad_ui && params.get<ParamKey::CustomPaths>();
+  scene.acceleration_path = custom_paths && params.get<ParamKey::AccelerationPath>();
+  scene.adjacent_path = custom_paths && params.get<ParamKey::AdjacentPath>();
+  scene.adjacent_path_metrics = scene.adjacent_path && params.get<ParamKey::AdjacentPathMetrics>();
+  scene.blind_spot_path = custom_paths && params.get<ParamKey::BlindSpotPath>();
+  scene.compass = custom_onroad_ui && params.get<ParamKey::Compass>();
+  scene.pedals_on_ui = custom_onroad_ui && params.get<ParamKey::PedalsOnUI>();
+  scene.dynamic_pedals_on_ui = scene.pedals_on_ui && params.get<ParamKey::DynamicPedalsOnUI>();
+  scene.static_pedals_on_ui = scene.pedals_on_ui && params.get<ParamKey::StaticPedalsOnUI>();
+  scene.road_name_ui = custom_onroad_ui && params.get<ParamKey::RoadNameUI>();
+  scene.rotating_wheel = custom_onroad_ui && params.get<ParamKey::RotatingWheel>();
+  scene.wheel_icon = custom_onroad_ui ? params.get<ParamKey::WheelIcon>() : 0;
+
+  bool custom_theme = params.get<ParamKey::CustomTheme>();
+  scene.custom_colors = custom_theme ? params.get<ParamKey::CustomColors>() : 0;
+  scene.custom_icons = custom_theme ? params.get<ParamKey::CustomIcons>() : 0;
+  scene.custom_signals = custom_theme ? params.get<ParamKey::CustomSignals>() : 0;
+  scene.holiday_themes = custom_theme && params.get<ParamKey::HolidayThemes>();
+  scene.random_events = custom_theme && params.get<ParamKey::RandomEvents>();
+
+  bool developer_ui = params.get<ParamKey::DeveloperUI>();
+  bool border_metrics = developer_ui && params.get<ParamKey::BorderMetrics>();
+  scene.show_blind_spot = border_metrics && params.get<ParamKey::BlindSpotMetrics>();
+  scene.show_signal = border_metrics && params.get<ParamKey::SignalMetrics>();
+  scene.show_steering = border_metrics && params.get<ParamKey::ShowSteering>();
+  scene.fps_counter = developer_ui && params.get<ParamKey::FPSCounter>();
+  scene.lead_info = scene.longitudinal_control && developer_ui && params.get<ParamKey::LongitudinalMetrics>();
+  scene.numerical_temp = developer_ui && params.get<ParamKey::NumericalTemp>();
+  scene.fahrenheit = scene.numerical_temp && params.get<ParamKey::Fahrenheit>();
+  scene.show_jerk = scene.longitudinal_control && developer_ui && params.get<ParamKey::LongitudinalMetrics>();
+  scene.show_tuning = developer_ui && scene.has_auto_tune && params.get<ParamKey::LateralMetrics>();
+  scene.sidebar_metrics = developer_ui && params.get<ParamKey::SidebarMetrics>();
+  scene.is_CPU = scene.sidebar_metrics && params.get<ParamKey::ShowCPU>();
+  scene.is_GPU = scene.sidebar_metrics && params.get<ParamKey::ShowGPU>();
+  scene.is_IP = scene.sidebar_metrics && params.get<ParamKey::ShowIP>();
+  scene.is_memory = scene.sidebar_metrics && params.get<ParamKey::ShowMemoryUsage>();
+  scene.is_storage_left = scene.sidebar_metrics && params.get<ParamKey::ShowStorageLeft>();
+  scene.is_storage_used = scene.sidebar_metrics && params.get<ParamKey::ShowStorageUsed>();
+  scene.use_si = developer_ui && params.get<ParamKey::UseSI>();
+
+  scene.disable_smoothing_mtsc = params.get<ParamKey::MTSCEnabled>() && params.get<ParamKey::DisableMTSCSmoothing>();
+  scene.disable_smoothing_vtsc = params.get<ParamKey::VisionTurnControl>() && params.get<ParamKey::DisableVTSCSmoothing>();
+
+  bool driving_personalities = scene.longitudinal_control && params.get<ParamKey::DrivingPersonalities>();
+  scene.onroad_distance_button = driving_personalities && params.get<ParamKey::OnroadDistanceButton>();
+  scene.use_kaofui_icons = scene.onroad_distance_button && params.get<ParamKey::KaofuiIcons>();
+
+  scene.experimental_mode_via_screen = scene.longitudinal_control && params.get<ParamKey::ExperimentalModeActivation>() && params.get<ParamKey::ExperimentalModeViaTap>();
+
+  bool lane_detection = params.get<ParamKey::NudgelessLaneChange>() && params.get<ParamKey::LaneDetectionWidth>() != 0;
+  scene.lane_detection_width = lane_detection ? params.get<ParamKey::LaneDetectionWidth>() * (scene.is_metric ? 1 : FOOT_TO_METER) / 10.0f : 2.75f;
+
+  bool longitudinal_tune = scene.longitudinal_control && params.get<ParamKey::LongitudinalTune>();
   bool radarless_model = params.get("Model") == "radical-turtle";
-  scene.lead_detection_threshold = longitudinal_tune && !radarless_model ? params.getInt("LeadDetectionThreshold") / 100.0f : 0.5;
-
-  scene.model_ui = params.getBool("ModelUI");
-  scene.dynamic_path_width = scene.model_ui && params.getBool("DynamicPathWidth");
-  scene.hide_lead_marker = scene.model_ui && params.getBool("HideLeadMarker");
-  scene.lane_line_width = params.getInt("LaneLinesWidth") * (scene.is_metric ? 1.0f : INCH_TO_CM) / 200.0f;
-  scene.path_edge_width = params.getInt("PathEdgeWidth");
-  scene.path_width = params.getInt("PathWidth") / 10.0f * (scene.is_metric ? 1.0f : FOOT_TO_METER) / 2.0f;
-  scene.road_edge_width = params.getInt("RoadEdgesWidth") * (scene.is_metric ? 1.0f : INCH_TO_CM) / 200.0f;
-  scene.unlimited_road_ui_length = scene.model_ui && params.getBool("UnlimitedLength");
-
-  bool quality_of_life_controls = params.getBool("QOLControls");
-  scene.reverse_cruise = quality_of_life_controls && params.getBool("ReverseCruise");
-  scene.reverse_cruise_ui = params.getBool("ReverseCruiseUI");
-
-  bool quality_of_life_visuals = params.getBool("QOLVisuals");
-  scene.big_map = quality_of_life_visuals && params.getBool("BigMap");
-  scene.full_map = scene.big_map && params.getBool("FullMap");
-  scene.camera_view = quality_of_life_visuals ? params.getInt("CameraView") : 0;
-  scene.driver_camera = quality_of_life_visuals && params.getBool("DriverCamera");
-  scene.hide_speed = quality_of_life_visuals && params.getBool("HideSpeed");
-  scene.hide_speed_ui = scene.hide_speed && params.getBool("HideSpeedUI");
-  scene.map_style = quality_of_life_visuals ? params.getInt("MapStyle") : 0;
-  scene.wheel_speed = quality_of_life_visuals && params.getBool("WheelSpeed");
-
-  bool screen_management = params.getBool("ScreenManagement");
-  bool hide_ui_elements = screen_management && params.getBool("HideUIElements");
-  scene.hide_alerts = hide_ui_elements && params.getBool("HideAlerts");
-  scene.hide_map_icon = hide_ui_elements && params.getBool("HideMapIcon");
-  scene.hide_max_speed = hide_ui_elements && params.getBool("HideMaxSpeed");
-  scene.screen_brightness = screen_management ? params.getInt("ScreenBrightness") : 101;
-  scene.screen_brightness_onroad = screen_management ? params.getInt("ScreenBrightnessOnroad") : 101;
-  scene.screen_recorder = screen_management && params.getBool("ScreenRecorder");
-  scene.screen_timeout = screen_management ? params.getInt("ScreenTimeout") : 30;
-  scene.screen_timeout_onroad = screen_management ? params.getInt("ScreenTimeoutOnroad") : 10;
-  scene.standby_mode = screen_management && params.getBool("StandbyMode");
-
-  scene.speed_limit_controller = scene.longitudinal_control && params.getBool("SpeedLimitController");
-  scene.show_slc_offset = scene.speed_limit_controller && params.getBool("ShowSLCOffset");
-  scene.show_slc_offset_ui = scene.speed_limit_controller && params.getBool("ShowSLCOffsetUI");
-  scene.use_vienna_slc_sign = scene.speed_limit_controller && params.getBool("UseVienna");
+  scene.lead_detection_threshold = longitudinal_tune && !radarless_model ? params.get<ParamKey::LeadDetectionThreshold>() / 100.0f : 0.5;
+
+  scene.model_ui = params.get<ParamKey::ModelUI>();
+  scene.dynamic_path_width = scene.model_ui && params.get<ParamKey::DynamicPathWidth>();
+  scene.hide_lead_marker = scene.model_ui && params.get<ParamKey::HideLeadMarker>();
+  scene.lane_line_width = params.get<ParamKey::LaneLinesWidth>() * (scene.is_metric ? 1.0f : INCH_TO_CM) / 200.0f;
+  scene.path_edge_width = params.get<ParamKey::PathEdgeWidth>();
+  scene.path_width = params.get<ParamKey::PathWidth>() / 10.0f * (scene.is_metric ? 1.0f : FOOT_TO_METER) / 2.0f;
+  scene.road_edge_width = params.get<ParamKey::RoadEdgesWidth>() * (scene.is_metric ? 1.0f : INCH_TO_CM) / 200.0f;
+  scene.unlimited_road_ui_length = scene.model_ui && params.get<ParamKey::UnlimitedLength>();
+
+  bool quality_of_life_controls = params.get<ParamKey::QOLControls>();
+  scene.reverse_cruise = quality_of_life_controls && params.get<ParamKey::ReverseCruise>();
+  scene.reverse_cruise_ui = params.get<ParamKey::ReverseCruiseUI>();
+
+  bool quality_of_life_visuals = params.get<ParamKey::QOLVisuals>();
+  scene.big_map = quality_of_life_visuals && params.get<ParamKey::BigMap>();
+  scene.full_map = scene.big_map && params.get<ParamKey::FullMap>();
+  scene.camera_view = quality_of_life_visuals ? params.get<ParamKey::CameraView>() : 0;
+  scene.driver_camera = quality_of_life_visuals && params.get<ParamKey::DriverCamera>();
+  scene.hide_speed = quality_of_life_visuals && params.get<ParamKey::HideSpeed>();
+  scene.hide_speed_ui = scene.hide_speed && params.get<ParamKey::HideSpeedUI>();
+  scene.map_style = quality_of_life_visuals ? params.get<ParamKey::MapStyle>() : 0;
+  scene.wheel_speed = quality_of_life_visuals && params.get<ParamKey::WheelSpeed>();
+
+  bool screen_management = params.get<ParamKey::ScreenManagement>();
+  bool hide_ui_elements = screen_management && params.get<ParamKey::HideUIElements>();
+  scene.hide_alerts = hide_ui_elements && params.get<ParamKey::HideAlerts>();
+  scene.hide_map_icon = hide_ui_elements && params.get<ParamKey::HideMapIcon>();
+  scene.hide_max_speed = hide_ui_elements && params.get<ParamKey::HideMaxSpeed>();
+  scene.screen_brightness = screen_management ? params.get<ParamKey::ScreenBrightness>() : 101;
+  scene.screen_brightness_onroad = screen_management ? params.get<ParamKey::ScreenBrightnessOnroad>() : 101;
+  scene.screen_recorder = screen_management && params.get<ParamKey::ScreenRecorder>();
+  scene.screen_timeout = screen_management ? params.get<ParamKey::ScreenTimeout>() : 30;
+  scene.screen_timeout_onroad = screen_management ? params.get<ParamKey::ScreenTimeoutOnroad>() : 10;
+  scene.standby_mode = screen_management && params.get<ParamKey::StandbyMode>();
+
+  scene.speed_limit_controller = scene.longitudinal_control && params.get<ParamKey::SpeedLimitController>();
+  scene.show_slc_offset = scene.speed_limit_controller && params.get<ParamKey::ShowSLCOffset>();
+  scene.show_slc_offset_ui = scene.speed_limit_controller && params.get<ParamKey::ShowSLCOffsetUI>();
+  scene.use_vienna_slc_sign = scene.speed_limit_controller && params.get<ParamKey::UseVienna>();
 }
 
 void UIState::updateStatus() {
@@ -493,14 +494,14 @@ void UIState::update() {
   emit uiUpdate(*this);
 
   // Update FrogPilot variables when they are changed
-  if (paramsMemory.getBool("FrogPilotTogglesUpdated")) {
+  if (paramsMemory.get<ParamKey::FrogPilotTogglesUpdated>()) {
     ui_update_frogpilot_params(this);
   }
 
   // FrogPilot live variables that need to be constantly checked
-  scene.conditional_status = scene.conditional_experimental && scene.enabled ? paramsMemory.getInt("CEStatus") : 0;
-  scene.current_holiday_theme = scene.holiday_themes ? paramsMemory.getInt("CurrentHolidayTheme") : 0;
-  scene.current_random_event = scene.random_events ? paramsMemory.getInt("CurrentRandomEvent") : 0;
+  scene.conditional_status = scene.conditional_experimental && scene.enabled ? paramsMemory.get<ParamKey::CEStatus>() : 0;
+  scene.current_holiday_theme = scene.holiday_themes ? paramsMemory.get<ParamKey::CurrentHolidayTheme>() : 0;
+  scene.current_random_event = scene.random_events ? paramsMemory.get<ParamKey::CurrentRandomEvent>() : 0;
   scene.driver_camera_timer = scene.driver_camera && scene.reverse ? scene.driver_camera_timer + 1 : 0;
 }
 
@@ -121,35 +121,97 @@ static void log_sentinel(LoggerState *log, SentinelType type, int eixt_signal =
   log->write(msg.toBytes(), true);
 }
 
-LoggerState::LoggerState(const std::string &log_root) {
+// class ZstdFile
+
+ZstdFile::ZstdFile(const std::string &path, int level, size_t frame_msgs) : file(path), frame_msgs(frame_msgs) {
+  cctx = ZSTD_createCCtx();
+  assert(cctx != nullptr);
+  ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, level);
+  ZSTD_CCtx_setParameter(cctx, ZSTD_c_checksumFlag, 1);
+  out.resize(ZSTD_CStreamOutSize());
+}
+
+ZstdFile::~ZstdFile() {
+  if (num_msgs > 0) {
+    endFrame();
+  }
+
+  // Seek table in a skippable frame
+  const uint32_t num_frames = seek_table.size() / 2;
+  const uint8_t descriptor = 0;
+  const uint32_t header[] = {ZSTD_SKIPPABLE_MAGIC, (uint32_t)(seek_table.size() * sizeof(uint32_t) + 9)};
+  const uint32_t seekable_magic = ZSTD_SEEKABLE_MAGIC;
+  file.write((void *)header, sizeof(header));
+  file.write(seek_table.data(), seek_table.size() * sizeof(uint32_t));
+  file.write((void *)&num_frames, sizeof(num_frames));
+  file.write((void *)&descriptor, sizeof(descriptor));
+  file.write((void *)&seekable_magic, sizeof(seekable_magic));
+
+  ZSTD_freeCCtx(cctx);
+}
+
+void ZstdFile::write(void* data, size_t size) {
+  compress(data, size, ZSTD_e_continue);
+  frame_size += size;
+  if (++num_msgs >= frame_msgs) {
+    endFrame();
+  }
+}
+
+void ZstdFile::compress(const void *data, size_t size, ZSTD_EndDirective mode) {
+  ZSTD_inBuffer input = {data, size, 0};
+  bool finished = false;
+  while (!finished) {
+    ZSTD_outBuffer output = {out.data(), out.size(), 0};
+    size_t remaining = ZSTD_compressStream2(cctx, &output, &input, mode);
+    assert(!ZSTD_isError(remaining));
+    if (output.pos > 0) {
+      file.write(out.data(), output.pos);
+      frame_compressed_size += output.pos;
+    }
+    finished = mode == ZSTD_e_end ? remaining == 0 : input.pos == input.size;
+  }
+}
+
+void ZstdFile::endFrame() {
+  compress(nullptr, 0, ZSTD_e_end);
+  seek_table.push_back(frame_compressed_size);
+  seek_table.push_back(frame_size);
+  num_msgs = frame_size = frame_compressed_size = 0;
+}
+
+// class LoggerState
+
+LoggerState::LoggerState(const std::string &log_root, bool zstd, size_t queue_size)
+    : zstd(zstd), queue_size(queue_size & ~(sizeof(RecordHeader) - 1)), queue(new uint8_t[queue_size]) {
   route_name = logger_get_identifier("RouteCount");
   route_path = log_root + "/" + route_name;
   init_data = logger_build_init_data();
+  writer = std::thread(&LoggerState::writerThread, this);
 }
 
 LoggerState::~LoggerState() {
-  if (rlog) {
+  if (part >= 0) {
     log_sentinel(this, SentinelType::END_OF_ROUTE, exit_signal);
-    std::remove(lock_file.c_str());
   }
+  push(RECORD_CLOSE, nullptr, 0);
+  writer.join();
 }
 
 bool LoggerState::next() {
-  if (rlog) {
+  if (part >= 0) {
     log_sentinel(this, SentinelType::END_OF_SEGMENT);
-    std::remove(lock_file.c_str());
   }
 
+  // the directory and lock file are created right away, the writer thread
+  // opens the logs once it's done with the previous segment
   segment_path = route_path + "--" + std::to_string(++part);
   bool ret = util::create_directories(segment_path, 0775);
   assert(ret == true);
 
-  const std::string rlog_path = segment_path + "/rlog";
-  lock_file = rlog_path + ".lock";
+  lock_file = segment_path + "/rlog" + (zstd ? ".zst" : "") + ".lock";
   std::ofstream{lock_file};
-
-  rlog.reset(new RawFile(rlog_path));
-  qlog.reset(new RawFile(segment_path + "/qlog"));
+  push(RECORD_OPEN, segment_path.data(), segment_path.size());
 
   // log init data & sentinel type.
   write(init_data.asBytes(), true);
@@ -158,6 +220,159 @@ bool LoggerState::next() {
 }
 
 void LoggerState::write(uint8_t* data, size_t size, bool in_qlog) {
-  rlog->write(data, size);
-  if (in_qlog) qlog->write(data, size);
+  push(in_qlog ? RECORD_RLOG_QLOG : RECORD_RLOG, data, size);
+}
+
+void LoggerState::push(RecordType type, const void *data, size_t size) {
+  const size_t record_size = (sizeof(RecordHeader) + size + sizeof(RecordHeader) - 1) & ~(sizeof(RecordHeader) - 1);
+  assert(record_size <= queue_size / 2);
+
+  uint64_t pos = head.load(std::memory_order_relaxed);
+  size_t offset = pos % queue_size;
+  // records are contiguous, pad to the start of the ring if this one doesn't fit
+  const size_t pad = offset + record_size > queue_size ? queue_size - offset : 0;
+
+  if (pos + pad + record_size > queue_size + tail.load(std::memory_order_acquire)) {
+    uint64_t start = nanos_since_boot();
+    waitForTail(pos + pad + record_size - queue_size);
+    blocked_ms += (nanos_since_boot() - start) / 1e6;
+  }
+
+  if (pad > 0) {
+    *(RecordHeader *)&queue[offset] = {(uint32_t)pad, RECORD_PAD};
+    offset = 0;
+  }
+  *(RecordHeader *)&queue[offset] = {(uint32_t)size, type};
+  if (size > 0) memcpy(&queue[offset + sizeof(RecordHeader)], data, size);
+
+  pos += pad + record_size;
+  max_queue_bytes = std::max(max_queue_bytes, (size_t)(pos - tail.load(std::memory_order_relaxed)));
+  // seq_cst, so either the writer sees the new head or we see it's waiting
+  head.store(pos);
+  if (writer_waiting.load()) {
+    std::lock_guard lk(wait_lock);
+    data_cv.notify_one();
+  }
+}
+
+void LoggerState::waitForTail(uint64_t min_tail) {
+  std::unique_lock lk(wait_lock);
+  producer_waiting = true;
+  space_cv.wait(lk, [&] { return tail.load() >= min_tail; });
+  producer_waiting = false;
+}
+
+void LoggerState::advanceTail(uint64_t pos) {
+  tail.store(pos);
+  if (producer_waiting.load()) {
+    std::lock_guard lk(wait_lock);
+    space_cv.notify_one();
+  }
+}
+
+void LoggerState::flush() {
+  waitForTail(head.load(std::memory_order_relaxed));
+}
+
+LoggerWriterStats LoggerState::writerStats() {
+  LoggerWriterStats stats = {
+    .queue_size = queue_size,
+    .max_queue_bytes = max_queue_bytes,
+    .max_write_ms = max_write_us.exchange(0) / 1e3,
+    .slow_writes = slow_writes.exchange(0),
+    .blocked_ms = blocked_ms,
+  };
+  max_queue_bytes = 0;
+  blocked_ms = 0;
+  return stats;
+}
+
+void LoggerState::writeBatch(std::vector<struct iovec> &rlog_iov, std::vector<struct iovec> &qlog_iov) {
+  if (rlog_iov.empty()) return;
+
+  uint64_t start = nanos_since_boot();
+  rlog->writev(rlog_iov.data(), rlog_iov.size());
+  if (!qlog_iov.empty()) qlog->writev(qlog_iov.data(), qlog_iov.size());
+  uint64_t us = (nanos_since_boot() - start) / 1000;
+
+  if (us > max_write_us.load(std::memory_order_relaxed)) max_write_us = us;
+  if (us > LOGGER_SLOW_WRITE_MS * 1000) slow_writes++;
+  rlog_iov.clear();
+  qlog_iov.clear();
+}
+
+void LoggerState::closeFiles() {
+  // finish the files before unlocking them for upload
+  rlog.reset();
+  qlog.reset();
+  if (!open_lock_file.empty()) {
+    std::remove(open_lock_file.c_str());
+    open_lock_file.clear();
+  }
+}
+
+void LoggerState::writerThread() {
+  util::set_thread_name("loggerd_writer");
+
+  // bound the batch so space is handed back to the producer regularly
+  const size_t max_batch_bytes = std::min(queue_size / 4, (size_t)1024 * 1024);
+  std::vector<struct iovec> rlog_iov, qlog_iov;
+  rlog_iov.reserve(IOV_MAX);
+  qlog_iov.reserve(IOV_MAX);
+
+  uint64_t pos = tail.load(std::memory_order_relaxed);
+  while (true) {
+    const uint64_t end = head.load(std::memory_order_acquire);
+    if (pos == end) {
+      std::unique_lock lk(wait_lock);
+      writer_waiting = true;
+      data_cv.wait(lk, [&] { return head.load() != pos; });
+      writer_waiting = false;
+      continue;
+    }
+
+    size_t batch_bytes = 0;
+    while (pos != end && rlog_iov.size() < IOV_MAX && batch_bytes < max_batch_bytes) {
+      const size_t offset = pos % queue_size;
+      const RecordHeader hdr = *(RecordHeader *)&queue[offset];
+      uint8_t *payload = &queue[offset + sizeof(RecordHeader)];
+
+      if (hdr.type == RECORD_PAD) {
+        pos += hdr.size;
+        continue;
+      }
+      const size_t record_size = (sizeof(RecordHeader) + hdr.size + sizeof(RecordHeader) - 1) & ~(sizeof(RecordHeader) - 1);
+
+      if (hdr.type == RECORD_RLOG || hdr.type == RECORD_RLOG_QLOG) {
+        rlog_iov.push_back({payload, hdr.size});
+        if (hdr.type == RECORD_RLOG_QLOG) qlog_iov.push_back({payload, hdr.size});
+        batch_bytes += hdr.size;
+        pos += record_size;
+        continue;
+      }
+
+      writeBatch(rlog_iov, qlog_iov);
+      closeFiles();
+      if (hdr.type == RECORD_CLOSE) {
+        advanceTail(pos + record_size);
+        return;
+      }
+
+      // RECORD_OPEN
+      const std::string path((char *)payload, hdr.size);
+      const std::string ext = zstd ? ".zst" : "";
+      if (zstd) {
+        rlog.reset(new ZstdFile(path + "/rlog" + ext));
+        qlog.reset(new ZstdFile(path + "/qlog" + ext));
+      } else {
+        rlog.reset(new RawFile(path + "/rlog"));
+        qlog.reset(new RawFile(path + "/qlog"));
+      }
+      open_lock_file = path + "/rlog" + ext + ".lock";
+      pos += record_size;
+    }
+
+    writeBatch(rlog_iov, qlog_iov);
+    advanceTail(pos);
+  }
 }
@@ -1,14 +1,35 @@
 #pragma once
 
+#include <sys/uio.h>
+
+#include <atomic>
 #include <cassert>
+#include <climits>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
+
+#include <zstd.h>
 
 #include "cereal/messaging/messaging.h"
 #include "common/util.h"
 #include "system/hardware/hw.h"
 
-class RawFile {
+class LogFile {
+ public:
+  virtual ~LogFile() {}
+  virtual void write(void* data, size_t size) = 0;
+  inline void write(kj::ArrayPtr<capnp::byte> array) { write(array.begin(), array.size()); }
+  // Writes a batch of messages, iov is modified
+  virtual void writev(struct iovec *iov, int count) {
+    for (int i = 0; i < count; ++i) write(iov[i].iov_base, iov[i].iov_len);
+  }
+};
+
+class RawFile : public LogFile {
  public:
   RawFile(const std::string &path) {
     file = util::safe_fopen(path.c_str(), "wb");
@@ -19,25 +40,89 @@ class RawFile {
     int err = fclose(file);
     assert(err == 0);
   }
-  inline void write(void* data, size_t size) {
+  using LogFile::write;
+  inline void write(void* data, size_t size) override {
     int written = util::safe_fwrite(data, 1, size, file);
     assert(written == size);
   }
-  inline void write(kj::ArrayPtr<capnp::byte> array) { write(array.begin(), array.size()); }
+  void writev(struct iovec *iov, int count) override {
+    util::safe_fflush(file);
+    while (count > 0) {
+      ssize_t written = HANDLE_EINTR(::writev(fileno(file), iov, std::min(count, IOV_MAX)));
+      assert(written >= 0);
+      // skip what made it to the file, a short write can end in the middle of a message
+      for (; count > 0 && written >= (ssize_t)iov->iov_len; ++iov, --count) {
+        written -= iov->iov_len;
+      }
+      if (count > 0) {
+        iov->iov_base = (uint8_t *)iov->iov_base + written;
+        iov->iov_len -= written;
+      }
+    }
+  }
 
  private:
   FILE* file = nullptr;
 };
 
+// Zstd seekable format: independent frames of frame_msgs messages, followed by a skippable
+// frame with the seek table. Regular zstd tools decompress it, and a segment cut short by a
+// crash is still readable up to the last complete frame.
+#define ZSTD_SEEKABLE_MAGIC 0x8F92EAB1
+#define ZSTD_SKIPPABLE_MAGIC 0x184D2A5E
+#define ZSTD_LOG_LEVEL 3
+#define ZSTD_LOG_FRAME_MSGS 1000
+
+class ZstdFile : public LogFile {
+ public:
+  ZstdFile(const std::string &path, int level = ZSTD_LOG_LEVEL, size_t frame_msgs = ZSTD_LOG_FRAME_MSGS);
+  ~ZstdFile();
+  using LogFile::write;
+  void write(void* data, size_t size) override;
+
+ private:
+  void compress(const void *data, size_t size, ZSTD_EndDirective mode);
+  void endFrame();
+
+  RawFile file;
+  ZSTD_CCtx *cctx;
+  std::vector<uint8_t> out;
+  const size_t frame_msgs;
+  size_t num_msgs = 0;
+  uint32_t frame_size = 0, frame_compressed_size = 0;
+  // (compressed size, decompressed size) of each frame
+  std::vector<uint32_t> seek_table;
+};
+
 typedef cereal::Sentinel::SentinelType SentinelType;
 
+#define LOGGER_QUEUE_SIZE (16 * 1024 * 1024)
+#define LOGGER_SLOW_WRITE_MS 100
 
+struct LoggerWriterStats {
+  size_t queue_size;
+  // the rest is since the last call to writerStats()
+  size_t max_queue_bytes;
+  double max_write_ms;
+  uint64_t slow_writes;
+  double blocked_ms;
+};
+
+// The files are written on a separate thread, so a slow disk doesn't hold up the caller.
+// write() copies each message into a lock free single producer single consumer ring,
+// which the writer thread hands to writev in batches. Either side only sleeps on a
+// condition variable while the ring is empty or full, and is woken by the other.
 class LoggerState {
 public:
-  LoggerState(const std::string& log_root = Path::log_root());
+  // With zstd, rlog.zst and qlog.zst are written instead of the uncompressed logs
+  LoggerState(const std::string& log_root = Path::log_root(), bool zstd = getenv("LOGGERD_ZSTD"),
+              size_t queue_size = LOGGER_QUEUE_SIZE);
   ~LoggerState();
   bool next();
   void write(uint8_t* data, size_t size, bool in_qlog);
+  // Waits until the writer thread wrote out everything queued so far
+  void flush();
+  LoggerWriterStats writerStats();
   inline int segment() const { return part; }
   inline const std::string& segmentPath() const { return segment_path; }
   inline const std::string& routeName() const { return route_name; }
@@ -45,10 +130,46 @@ public:
   inline void setExitSignal(int signal) { exit_signal = signal; }
 
 protected:
+  enum RecordType : uint32_t {
+    RECORD_RLOG,
+    RECORD_RLOG_QLOG,
+    RECORD_PAD,   // skip to the start of the ring
+    RECORD_OPEN,  // close the current segment and open the one in the payload
+    RECORD_CLOSE,
+  };
+  struct RecordHeader {
+    uint32_t size;
+    RecordType type;
+  };
+
+  void push(RecordType type, const void *data, size_t size);
+  void waitForTail(uint64_t min_tail);
+  void advanceTail(uint64_t pos);
+  void writerThread();
+  void writeBatch(std::vector<struct iovec> &rlog_iov, std::vector<struct iovec> &qlog_iov);
+  void closeFiles();
+
   int part = -1, exit_signal = 0;
+  bool zstd;
   std::string route_path, route_name, segment_path, lock_file;
   kj::Array<capnp::word> init_data;
-  std::unique_ptr<RawFile> rlog, qlog;
+
+  // ring positions only grow, the writer owns everything between tail and head
+  const size_t queue_size;
+  std::unique_ptr<uint8_t[]> queue;
+  std::atomic<uint64_t> head = 0, tail = 0;
+  // the lock is only taken to sleep, or to wake the other side when it announced it's sleeping
+  std::mutex wait_lock;
+  std::condition_variable data_cv, space_cv;
+  std::atomic<bool> writer_waiting = false, producer_waiting = false;
+  size_t max_queue_bytes = 0;
+  double blocked_ms = 0;
+  std::atomic<uint64_t> max_write_us = 0, slow_writes = 0;
+  std::thread writer;
+
+  // only used by the writer thread
+  std::unique_ptr<LogFile> rlog, qlog;
+  std::string open_lock_file;
 };
 
 kj::Array<capnp::word> logger_build_init_data();
@@ -244,6 +244,7 @@ void loggerd_thread() {
 
   uint64_t msg_count = 0, bytes_count = 0;
   double start_ts = millis_since_boot();
+  double last_stats_ts = start_ts;
   while (!do_exit) {
     // poll for new messages on all sockets
     for (auto sock : poller->poll(1000)) {
@@ -282,6 +283,15 @@ void loggerd_thread() {
         }
       }
     }
+
+    if (millis_since_boot() - last_stats_ts > 10000.) {
+      last_stats_ts = millis_since_boot();
+      LoggerWriterStats stats = s.logger.writerStats();
+      const bool stalled = stats.blocked_ms > 0 || stats.slow_writes > 0;
+      cloudlog(stalled ? CLOUDLOG_WARNING : CLOUDLOG_DEBUG,
+               "writer queue max %zu/%zu KB, max write %.1f ms, %" PRIu64 " slow writes, blocked %.1f ms",
+               stats.max_queue_bytes / 1024, stats.queue_size / 1024, stats.max_write_ms, stats.slow_writes, stats.blocked_ms);
+    }
   }
 
   LOGW("closing logger");
@@ -289,6 +299,7 @@ void loggerd_thread() {
 
   if (do_exit.power_failure) {
     LOGE("power failure");
+    s.logger.flush();
     sync();
     LOGE("sync done");
   }
@@ -0,0 +1,97 @@
+#include <bzlib.h>
+#include <time.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "system/loggerd/logger.h"
+
+// Compares the current path, writing the rlog uncompressed and bz2 compressing it before
+// upload like uploader.py does, with writing the seekable zstd format directly.
+// usage: rlog_compression_bench <rlog or rlog.bz2>
+
+static double cpu_ms() {
+  struct timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static std::string decompress_bz2(const std::string &in) {
+  bz_stream strm = {};
+  int ret = BZ2_bzDecompressInit(&strm, 0, 0);
+  assert(ret == BZ_OK);
+  std::string out(in.size() * 5, '\0');
+  strm.next_in = (char *)in.data();
+  strm.avail_in = in.size();
+  do {
+    if (strm.total_out_lo32 == out.size()) out.resize(out.size() * 2);
+    strm.next_out = &out[strm.total_out_lo32];
+    strm.avail_out = out.size() - strm.total_out_lo32;
+    ret = BZ2_bzDecompress(&strm);
+  } while (ret == BZ_OK);
+  assert(ret == BZ_STREAM_END);
+  out.resize(strm.total_out_lo32);
+  BZ2_bzDecompressEnd(&strm);
+  return out;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    printf("usage: %s <rlog or rlog.bz2>\n", argv[0]);
+    return 1;
+  }
+
+  std::string log = util::read_file(argv[1]);
+  if (log.compare(0, 3, "BZh") == 0) {
+    log = decompress_bz2(log);
+  }
+
+  // Split into messages like loggerd receives them
+  auto words = kj::heapArray<capnp::word>(log.size() / sizeof(capnp::word));
+  memcpy(words.begin(), log.data(), words.size() * sizeof(capnp::word));
+  std::vector<kj::ArrayPtr<const capnp::word>> msgs;
+  kj::ArrayPtr<const capnp::word> remaining = words;
+  while (remaining.size() > 0) {
+    capnp::FlatArrayMessageReader reader(remaining);
+    msgs.push_back(kj::arrayPtr(remaining.begin(), reader.getEnd()));
+    remaining = kj::arrayPtr(reader.getEnd(), remaining.end());
+  }
+
+  const std::string dir = "/tmp/rlog_compression_bench";
+  util::create_directories(dir, 0775);
+
+  // Current path: raw rlog on disk, read back and compressed to bz2 at upload
+  double start = cpu_ms();
+  {
+    RawFile f(dir + "/rlog");
+    for (auto &msg : msgs) f.write((void *)msg.begin(), msg.size() * sizeof(capnp::word));
+  }
+  double raw_write_ms = cpu_ms() - start;
+
+  start = cpu_ms();
+  std::string raw = util::read_file(dir + "/rlog");
+  unsigned int bz2_size = raw.size() * 1.01 + 600;
+  std::string bz2(bz2_size, '\0');
+  int ret = BZ2_bzBuffToBuffCompress(bz2.data(), &bz2_size, raw.data(), raw.size(), 9, 0, 30);
+  assert(ret == BZ_OK);
+  util::write_file((dir + "/rlog.bz2").c_str(), bz2.data(), bz2_size, O_WRONLY | O_CREAT | O_TRUNC);
+  double bz2_ms = cpu_ms() - start;
+
+  // zstd written by loggerd
+  start = cpu_ms();
+  {
+    ZstdFile f(dir + "/rlog.zst");
+    for (auto &msg : msgs) f.write((void *)msg.begin(), msg.size() * sizeof(capnp::word));
+  }
+  double zstd_ms = cpu_ms() - start;
+  size_t zstd_size = util::read_file(dir + "/rlog.zst").size();
+
+  printf("%zu messages, %.2f MB\n", msgs.size(), raw.size() / 1e6);
+  printf("%-10s %12s %12s %14s %14s %8s\n", "", "written MB", "read MB", "loggerd cpu ms", "upload cpu ms", "ratio");
+  printf("%-10s %12.2f %12.2f %14.1f %14.1f %8.2f\n", "raw+bz2", (raw.size() + bz2_size) / 1e6, raw.size() / 1e6,
+         raw_write_ms, bz2_ms, (double)raw.size() / bz2_size);
+  printf("%-10s %12.2f %12.2f %14.1f %14.1f %8.2f\n", "zstd", zstd_size / 1e6, 0.0,
+         zstd_ms, 0.0, (double)raw.size() / zstd_size);
+  return 0;
+}
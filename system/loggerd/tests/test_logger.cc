@@ -3,16 +3,34 @@
 
 typedef cereal::Sentinel::SentinelType SentinelType;
 
-void verify_segment(const std::string &route_path, int segment, int max_segment, int required_event_cnt) {
+std::string decompress_zstd(const std::string &in) {
+  std::string out;
+  std::vector<char> buf(ZSTD_DStreamOutSize());
+  ZSTD_DCtx *dctx = ZSTD_createDCtx();
+  ZSTD_inBuffer input = {in.data(), in.size(), 0};
+  while (input.pos < input.size) {
+    ZSTD_outBuffer output = {buf.data(), buf.size(), 0};
+    size_t ret = ZSTD_decompressStream(dctx, &output, &input);
+    REQUIRE(!ZSTD_isError(ret));
+    out.append(buf.data(), output.pos);
+  }
+  ZSTD_freeDCtx(dctx);
+  return out;
+}
+
+void verify_segment(const std::string &route_path, int segment, int max_segment, int required_event_cnt, const std::string &ext = "") {
   const std::string segment_path = route_path + "--" + std::to_string(segment);
   SentinelType begin_sentinel = segment == 0 ? SentinelType::START_OF_ROUTE : SentinelType::START_OF_SEGMENT;
   SentinelType end_sentinel = segment == max_segment - 1 ? SentinelType::END_OF_ROUTE : SentinelType::END_OF_SEGMENT;
 
-  REQUIRE(!util::file_exists(segment_path + "/rlog.lock"));
+  REQUIRE(!util::file_exists(segment_path + "/rlog" + ext + ".lock"));
   for (const char *fn : {"/rlog", "/qlog"}) {
-    const std::string log_file = segment_path + fn;
+    const std::string log_file = segment_path + fn + ext;
     std::string log = util::read_file(log_file);
     REQUIRE(!log.empty());
+    if (ext == ".zst") {
+      log = decompress_zstd(log);
+    }
     int event_cnt = 0, i = 0;
     kj::ArrayPtr<const capnp::word> words((capnp::word *)log.data(), log.size() / sizeof(capnp::word));
     while (words.size() > 0) {
@@ -72,3 +90,77 @@ TEST_CASE("logger") {
     verify_segment(log_root + "/" + route_name, i, segment_cnt, 1);
   }
 }
+
+TEST_CASE("logger zstd") {
+  const int segment_cnt = 3, msg_cnt = 2500;
+  const std::string log_root = "/tmp/test_logger_zstd";
+  system(("rm " + log_root + " -rf").c_str());
+  std::string route_name;
+  {
+    LoggerState logger(log_root, true);
+    route_name = logger.routeName();
+    for (int i = 0; i < segment_cnt; ++i) {
+      REQUIRE(logger.next());
+      REQUIRE(util::file_exists(logger.segmentPath() + "/rlog.zst.lock"));
+      for (int j = 0; j < msg_cnt; ++j) {
+        write_msg(&logger);
+      }
+    }
+    logger.setExitSignal(1);
+  }
+
+  for (int i = 0; i < segment_cnt; ++i) {
+    const std::string segment_path = log_root + "/" + route_name + "--" + std::to_string(i);
+    verify_segment(log_root + "/" + route_name, i, segment_cnt, msg_cnt, ".zst");
+    REQUIRE(!util::file_exists(segment_path + "/rlog"));
+
+    // the seek table covers every frame in the file
+    std::string log = util::read_file(segment_path + "/rlog.zst");
+    REQUIRE(*(uint32_t *)&log[log.size() - 4] == ZSTD_SEEKABLE_MAGIC);
+    uint32_t num_frames = *(uint32_t *)&log[log.size() - 9];
+    REQUIRE(num_frames == (msg_cnt + 3) / ZSTD_LOG_FRAME_MSGS + 1);
+
+    size_t table_size = num_frames * 8 + 9;
+    size_t offset = 0, decompressed_size = 0;
+    const uint32_t *table = (const uint32_t *)&log[log.size() - table_size];
+    for (int f = 0; f < num_frames; ++f) {
+      REQUIRE(ZSTD_findFrameCompressedSize(&log[offset], table[f * 2]) == table[f * 2]);
+      offset += table[f * 2];
+      decompressed_size += table[f * 2 + 1];
+    }
+    REQUIRE(offset + 8 + table_size == log.size());
+    REQUIRE(decompressed_size == decompress_zstd(log).size());
+  }
+}
+
+TEST_CASE("logger small writer queue") {
+  // the queue wraps and fills up many times per segment
+  const int segment_cnt = 3, msg_cnt = 5000;
+  const size_t queue_size = 16 * 1024;
+  const std::string log_root = "/tmp/test_logger_queue";
+  system(("rm " + log_root + " -rf").c_str());
+  std::string route_name;
+  {
+    LoggerState logger(log_root, false, queue_size);
+    route_name = logger.routeName();
+    for (int i = 0; i < segment_cnt; ++i) {
+      REQUIRE(logger.next());
+      for (int j = 0; j < msg_cnt; ++j) {
+        write_msg(&logger);
+      }
+      // everything queued so far is on disk after a flush
+      logger.flush();
+      MessageBuilder msg;
+      msg.initEvent().initClocks();
+      REQUIRE(util::read_file(logger.segmentPath() + "/rlog").size() > msg_cnt * msg.toBytes().size());
+
+      LoggerWriterStats stats = logger.writerStats();
+      REQUIRE(stats.queue_size == queue_size);
+      REQUIRE(stats.max_queue_bytes <= queue_size);
+    }
+    logger.setExitSignal(1);
+  }
+  for (int i = 0; i < segment_cnt; ++i) {
+    verify_segment(log_root + "/" + route_name, i, segment_cnt, msg_cnt);
+  }
+}
@@ -66,8 +66,6 @@ bool PandaStream::connect() {
 }
 
 void PandaStream::streamThread() {
-  std::vector<can_frame> raw_can_data;
-
   while (!QThread::currentThread()->isInterruptionRequested()) {
     QThread::msleep(1);
 
@@ -79,21 +77,15 @@ void PandaStream::streamThread() {
       }
     }
 
-    raw_can_data.clear();
-    if (!panda->can_receive(raw_can_data)) {
+    if (!panda->can_receive()) {
       qDebug() << "failed to receive";
       continue;
     }
 
     MessageBuilder msg;
     auto evt = msg.initEvent();
-    auto canData = evt.initCan(raw_can_data.size());
-    for (uint i = 0; i<raw_can_data.size(); i++) {
-      canData[i].setAddress(raw_can_data[i].address);
-      canData[i].setBusTime(raw_can_data[i].busTime);
-      canData[i].setDat(kj::arrayPtr((uint8_t*)raw_can_data[i].dat.data(), raw_can_data[i].dat.size()));
-      canData[i].setSrc(raw_can_data[i].src);
-    }
+    auto canData = evt.initCan(panda->can_receive_cnt());
+    panda->can_unpack(canData, 0);
 
     handleEvent(capnp::messageToFlatArray(msg));
 
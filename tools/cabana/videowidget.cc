@@ -257,7 +257,8 @@ void Slider::setTimeRange(double min, double max) {
 void Slider::parseQLog(int segnum, std::shared_ptr<LogReader> qlog) {
  const auto &segments = qobject_cast<ReplayStream *>(can)->route()->segments();
   if (segments.size() > 0 && segnum == segments.rbegin()->first && !qlog->events.empty()) {
-    emit updateMaximumTime(qlog->events.back()->mono_time / 1e9 - can->routeStartTime());
+    // the qlog is loaded with a filter, the last loaded event can be far from the end of the segment
+    emit updateMaximumTime(qlog->lastMonoTime() / 1e9 - can->routeStartTime());
   }
 
   std::mutex mutex;
@@ -4,8 +4,10 @@ from functools import partial
 import multiprocessing
 import capnp
 import enum
+import io
 import os
 import pathlib
+import subprocess
 import sys
 import tqdm
 import urllib.parse
@@ -21,10 +23,29 @@ from openpilot.tools.lib.openpilotci import get_url
 from openpilot.tools.lib.filereader import FileReader, file_exists, internal_source_available
 from openpilot.tools.lib.route import Route, SegmentRange
 
+try:
+  import zstandard
+except ImportError:
+  zstandard = None
+
 LogMessage = type[capnp._DynamicStructReader]
 LogIterable = Iterable[LogMessage]
 RawLogIterable = Iterable[bytes]
 
+ZSTD_MAGIC = b'\x28\xb5\x2f\xfd'
+
+
+def zstd_decompress(dat: bytes) -> bytes:
+  # loggerd writes many independent frames
+  if zstandard is not None:
+    return zstandard.ZstdDecompressor().stream_reader(io.BytesIO(dat), read_across_frames=True).read()
+
+  # zstandard is optional, fall back to the zstd command line tool
+  try:
+    return subprocess.run(["zstd", "-dcq"], input=dat, capture_output=True, check=True).stdout
+  except FileNotFoundError:
+    raise ImportError("reading .zst logs needs the zstandard module or the zstd command line tool") from None
+
 
 class _LogFileReader:
   def __init__(self, fn, canonicalize=True, only_union_types=False, sort_by_time=False, dat=None):
@@ -34,7 +55,7 @@ class _LogFileReader:
     ext = None
     if not dat:
       _, ext = os.path.splitext(urllib.parse.urlparse(fn).path)
-      if ext not in ('', '.bz2'):
+      if ext not in ('', '.bz2', '.zst'):
         # old rlogs weren't bz2 compressed
         raise Exception(f"unknown extension {ext}")
 
@@ -43,6 +64,8 @@ class _LogFileReader:
 
     if ext == ".bz2" or dat.startswith(b'BZh9'):
       dat = bz2.decompress(dat)
+    elif ext == ".zst" or dat.startswith(ZSTD_MAGIC):
+      dat = zstd_decompress(dat)
 
     ents = capnp_log.Event.read_multiple_bytes(dat)
 
@@ -3,6 +3,7 @@ import capnp
 import contextlib
 import io
 import shutil
+import subprocess
 import tempfile
 import os
 import unittest
@@ -255,6 +256,26 @@ class TestLogReader(unittest.TestCase):
       self.assertEqual(len(msgs), num_msgs)
       [m.which() for m in msgs]
 
+  @parameterized.expand([(True,), (False,)])
+  def test_zstd(self, has_zstandard):
+    if shutil.which("zstd") is None:
+      self.skipTest("zstd command line tool not available")
+    if has_zstandard:
+      pytest.importorskip("zstandard")
+
+    num_msgs = 100
+    events = [capnp_log.Event.new_message(logMonoTime=i).to_bytes() for i in range(num_msgs)]
+    with tempfile.TemporaryDirectory() as tmpdir:
+      # loggerd writes one frame per chunk of events
+      fn = os.path.join(tmpdir, "rlog.zst")
+      with open(fn, "wb") as f:
+        for chunk in (events[:num_msgs // 2], events[num_msgs // 2:]):
+          f.write(subprocess.run(["zstd", "-cq"], input=b"".join(chunk), capture_output=True, check=True).stdout)
+
+      with mock.patch("openpilot.tools.lib.logreader.zstandard", None) if not has_zstandard else contextlib.nullcontext():
+        msgs = list(LogReader(fn))
+      self.assertEqual([m.logMonoTime for m in msgs], list(range(num_msgs)))
+
 
 if __name__ == "__main__":
   unittest.main()
@@ -111,12 +111,12 @@ void ConsoleUI::initWindows() {
   w[Win::Stats] = newwin(2, max_width - 2 * BORDER_SIZE, 2, BORDER_SIZE);
   w[Win::Timeline] = newwin(4, max_width - 2 * BORDER_SIZE, 5, BORDER_SIZE);
   w[Win::TimelineDesc] = newwin(1, 100, 10, BORDER_SIZE);
-  w[Win::CarState] = newwin(3, 100, 12, BORDER_SIZE);
-  w[Win::DownloadBar] = newwin(1, 100, 16, BORDER_SIZE);
-  if (int log_height = max_height - 27; log_height > 4) {
-    w[Win::LogBorder] = newwin(log_height, max_width - 2 * (BORDER_SIZE - 1), 17, BORDER_SIZE - 1);
+  w[Win::CarState] = newwin(4, 100, 12, BORDER_SIZE);
+  w[Win::DownloadBar] = newwin(1, 100, 17, BORDER_SIZE);
+  if (int log_height = max_height - 28; log_height > 4) {
+    w[Win::LogBorder] = newwin(log_height, max_width - 2 * (BORDER_SIZE - 1), 18, BORDER_SIZE - 1);
     box(w[Win::LogBorder], 0, 0);
-    w[Win::Log] = newwin(log_height - 2, max_width - 2 * BORDER_SIZE, 18, BORDER_SIZE);
+    w[Win::Log] = newwin(log_height - 2, max_width - 2 * BORDER_SIZE, 19, BORDER_SIZE);
     scrollok(w[Win::Log], true);
   }
   w[Win::Help] = newwin(5, max_width - (2 * BORDER_SIZE), max_height - 6, BORDER_SIZE);
@@ -170,9 +170,8 @@ void ConsoleUI::updateStatus() {
   sm.update(0);
 
   if (status != Status::Paused) {
-    auto events = replay->events();
     uint64_t current_mono_time = replay->routeStartTime() + replay->currentSeconds() * 1e9;
-    bool playing = !events->empty() && events->back()->mono_time > current_mono_time;
+    bool playing = replay->lastEventMonoTime() > current_mono_time;
     status = playing ? Status::Playing : Status::Waiting;
   }
   auto [status_str, status_color] = status_text[status];
@@ -187,6 +186,14 @@ void ConsoleUI::updateStatus() {
   auto angle_offsets = util::string_format("%.2f|%.2f", p.getAngleOffsetAverageDeg(), p.getAngleOffsetDeg());
   write_item(2, 25, "ANGLE OFFSET(AVG|INSTANT): ", angle_offsets, " deg");
 
+  auto &frame_cache = FrameCache::instance();
+  const uint64_t hits = frame_cache.hits(), lookups = hits + frame_cache.misses();
+  auto cache_usage = frame_cache.maxSize() == 0 ? std::string("off")
+                    : util::string_format("%zu/%zu MB, %lu hits %lu misses (%.1f%%)  ", frame_cache.size() >> 20,
+                                          frame_cache.maxSize() >> 20, hits, lookups - hits,
+                                          lookups ? hits * 100.0 / lookups : 0.0);
+  write_item(3, 0, "FRAME CACHE: ", cache_usage, "");
+
   wrefresh(w[Win::CarState]);
 }
 
@@ -50,6 +50,15 @@ FrameReader::FrameReader() {
 }
 
 FrameReader::~FrameReader() {
+  if (prefetch_thread_.joinable()) {
+    {
+      std::lock_guard lk(prefetch_lock_);
+      exit_ = true;
+    }
+    prefetch_cv_.notify_one();
+    prefetch_thread_.join();
+  }
+
   for (AVPacket *pkt : packets) {
     av_packet_free(&pkt);
   }
@@ -72,10 +81,17 @@ bool FrameReader::load(const std::string &url, bool no_hw_decoder, std::atomic<b
     return false;
   }
 
+  file_ = url;
   return load((std::byte *)data.data(), data.size(), no_hw_decoder, abort);
 }
 
 bool FrameReader::load(const std::byte *data, size_t size, bool no_hw_decoder, std::atomic<bool> *abort) {
+  if (file_.empty()) {
+    // not from a file, the frames are cached under a key of their own
+    static std::atomic<uint64_t> memory_id = 0;
+    file_ = "memory:" + std::to_string(++memory_id);
+  }
+
   input_ctx = avformat_alloc_context();
   if (!input_ctx) {
     rError("Error calling avformat_alloc_context");
@@ -141,8 +157,11 @@ bool FrameReader::load(const std::byte *data, size_t size, bool no_hw_decoder, s
     }
     packets.push_back(pkt);
     // some stream seems to contain no keyframes
-    key_frames_count_ += pkt->flags & AV_PKT_FLAG_KEY;
+    if (pkt->flags & AV_PKT_FLAG_KEY) {
+      key_frames_.push_back(packets.size() - 1);
+    }
   }
+  key_frames_count_ = key_frames_.size();
   valid_ = valid_ && !packets.empty();
   return valid_;
 }
@@ -180,7 +199,31 @@ bool FrameReader::get(int idx, VisionBuf *buf) {
   if (!valid_ || idx < 0 || idx >= packets.size()) {
     return false;
   }
-  return decode(idx, buf);
+
+  auto &cache = FrameCache::instance();
+  if (cache.maxSize() == 0) {
+    std::lock_guard lk(decode_lock_);
+    return decode(idx, buf);
+  }
+
+  bool ret = true;
+  if (auto frame = cache.get(file_, idx)) {
+    copyBuffers(frame, buf);
+  } else {
+    ++readers_waiting_;
+    std::unique_lock lk(decode_lock_);
+    --readers_waiting_;
+    // the prefetch thread may have just decoded it
+    if (auto frame = cache.find(file_, idx)) {
+      copyBuffers(frame, buf);
+    } else {
+      ret = decode(idx, buf);
+    }
+    lk.unlock();
+    decode_cv_.notify_one();
+  }
+  prefetch(idx);
+  return ret;
 }
 
 bool FrameReader::decode(int idx, VisionBuf *buf) {
@@ -196,10 +239,24 @@ bool FrameReader::decode(int idx, VisionBuf *buf) {
   }
   prev_idx = idx;
 
+  auto &cache = FrameCache::instance();
   for (int i = from_idx; i <= idx; ++i) {
     AVFrame *f = decodeFrame(packets[i]);
-    if (f && i == idx) {
-      return copyBuffers(f, buf);
+    if (!f) continue;
+
+    // frames decoded on the way are cached too, scrubbing back within the GOP doesn't decode it again
+    if (cache.maxSize() > 0 && !cache.find(file_, i)) {
+      auto frame = std::make_shared<std::vector<uint8_t>>(getYUVSize());
+      copyBuffers(f, frame->data(), frame->data() + width * height, width);
+      cache.put(file_, i, frame);
+      if (i == idx && buf) {
+        copyBuffers(frame, buf);
+      }
+    } else if (i == idx && buf) {
+      copyBuffers(f, buf->y, buf->uv, buf->stride);
+    }
+    if (i == idx) {
+      return true;
     }
   }
   return false;
@@ -231,21 +288,120 @@ AVFrame *FrameReader::decodeFrame(AVPacket *pkt) {
   }
 }
 
-bool FrameReader::copyBuffers(AVFrame *f, VisionBuf *buf) {
-  assert(f != nullptr && buf != nullptr);
+bool FrameReader::copyBuffers(AVFrame *f, uint8_t *y, uint8_t *uv, int stride) {
+  assert(f != nullptr && y != nullptr && uv != nullptr);
   if (hw_pix_fmt == HW_PIX_FMT) {
     for (int i = 0; i < height/2; i++) {
-      memcpy(buf->y + (i*2 + 0)*buf->stride, f->data[0] + (i*2 + 0)*f->linesize[0], width);
-      memcpy(buf->y + (i*2 + 1)*buf->stride, f->data[0] + (i*2 + 1)*f->linesize[0], width);
-      memcpy(buf->uv + i*buf->stride, f->data[1] + i*f->linesize[1], width);
+      memcpy(y + (i*2 + 0)*stride, f->data[0] + (i*2 + 0)*f->linesize[0], width);
+      memcpy(y + (i*2 + 1)*stride, f->data[0] + (i*2 + 1)*f->linesize[0], width);
+      memcpy(uv + i*stride, f->data[1] + i*f->linesize[1], width);
     }
   } else {
     libyuv::I420ToNV12(f->data[0], f->linesize[0],
                        f->data[1], f->linesize[1],
                        f->data[2], f->linesize[2],
-                       buf->y, buf->stride,
-                       buf->uv, buf->stride,
+                       y, stride,
+                       uv, stride,
                        width, height);
   }
   return true;
 }
+
+void FrameReader::copyBuffers(const FrameCache::Frame &frame, VisionBuf *buf) {
+  const uint8_t *y = frame->data();
+  libyuv::CopyPlane(y, width, buf->y, buf->stride, width, height);
+  libyuv::CopyPlane(y + width * height, width, buf->uv, buf->stride, width, height / 2);
+}
+
+void FrameReader::prefetch(int idx) {
+  // without key frames every frame is decoded in sequence anyway
+  if (key_frames_count_ <= 1) return;
+
+  std::call_once(prefetch_once_, [this]() { prefetch_thread_ = std::thread(&FrameReader::prefetchThread, this); });
+  {
+    std::lock_guard lk(prefetch_lock_);
+    prefetch_idx_ = idx;
+  }
+  prefetch_cv_.notify_one();
+}
+
+void FrameReader::prefetchThread() {
+  auto &cache = FrameCache::instance();
+  while (true) {
+    int idx;
+    {
+      std::unique_lock lk(prefetch_lock_);
+      prefetch_cv_.wait(lk, [this]() { return exit_ || prefetch_idx_ >= 0; });
+      if (exit_) break;
+      idx = prefetch_idx_.exchange(-1);
+    }
+
+    // the rest of the current GOP and the next one
+    int to = packets.size() - 1;
+    auto next_key = std::upper_bound(key_frames_.begin(), key_frames_.end(), idx);
+    if (next_key != key_frames_.end() && std::next(next_key) != key_frames_.end()) {
+      to = *std::next(next_key) - 1;
+    }
+
+    // one frame at a time, stops at a new request. get() goes first.
+    for (int i = idx + 1; i <= to && !exit_ && prefetch_idx_ < 0 && cache.maxSize() > 0; ++i) {
+      if (cache.find(file_, i)) continue;
+
+      // readers_waiting_ drops under decode_lock_, so the wakeup after it can't be missed
+      std::unique_lock lk(decode_lock_);
+      decode_cv_.wait(lk, [this]() { return readers_waiting_ == 0; });
+      decode(i, nullptr);
+    }
+  }
+}
+
+// class FrameCache
+
+FrameCache &FrameCache::instance() {
+  static FrameCache cache;
+  return cache;
+}
+
+FrameCache::Frame FrameCache::get(const std::string &file, int idx) {
+  Frame frame = find(file, idx);
+  if (frame) {
+    ++hits_;
+  } else {
+    ++misses_;
+  }
+  return frame;
+}
+
+FrameCache::Frame FrameCache::find(const std::string &file, int idx) {
+  std::lock_guard lk(lock_);
+  auto it = index_.find({file, idx});
+  if (it == index_.end()) return nullptr;
+
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->second;
+}
+
+void FrameCache::put(const std::string &file, int idx, Frame frame) {
+  std::lock_guard lk(lock_);
+  Key key(file, idx);
+  if (index_.count(key)) return;
+
+  size_ += frame->size();
+  lru_.emplace_front(key, std::move(frame));
+  index_[key] = lru_.begin();
+  evict();
+}
+
+void FrameCache::setMaxSize(size_t bytes) {
+  std::lock_guard lk(lock_);
+  max_size_ = bytes;
+  evict();
+}
+
+void FrameCache::evict() {
+  while (size_ > max_size_ && !lru_.empty()) {
+    size_ -= lru_.back().second->size();
+    index_.erase(lru_.back().first);
+    lru_.pop_back();
+  }
+}
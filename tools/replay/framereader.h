@@ -1,7 +1,13 @@
 #pragma once
 
+#include <condition_variable>
+#include <list>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "cereal/visionipc/visionbuf.h"
@@ -16,6 +22,41 @@ struct AVFrameDeleter {
   void operator()(AVFrame* frame) const { av_frame_free(&frame); }
 };
 
+// Off until its cost is measured: with the cache on, every decoded frame is copied into it, and
+// prefetching decodes ahead on another thread. replay turns it on with --frame-cache.
+constexpr size_t DEFAULT_FRAME_CACHE_SIZE = 0;
+
+// Decoded frames of every FrameReader in unpadded NV12, keyed by (file, frame index), so they
+// outlive the segment that decoded them. The least recently used frames are dropped over the size limit.
+// A size of 0 turns it off, frames are then decoded straight into the caller's buffer.
+class FrameCache {
+public:
+  typedef std::shared_ptr<const std::vector<uint8_t>> Frame;
+  static FrameCache &instance();
+  // get() counts a hit or a miss, find() doesn't
+  Frame get(const std::string &file, int idx);
+  Frame find(const std::string &file, int idx);
+  void put(const std::string &file, int idx, Frame frame);
+  void setMaxSize(size_t bytes);
+  inline size_t maxSize() const { return max_size_; }
+  inline size_t size() const { return size_; }
+  inline uint64_t hits() const { return hits_; }
+  inline uint64_t misses() const { return misses_; }
+
+private:
+  typedef std::pair<std::string, int> Key;
+  void evict();
+
+  std::mutex lock_;
+  // most recently used first
+  std::list<std::pair<Key, Frame>> lru_;
+  std::map<Key, std::list<std::pair<Key, Frame>>::iterator> index_;
+  std::atomic<size_t> size_ = 0;
+  std::atomic<size_t> max_size_ = DEFAULT_FRAME_CACHE_SIZE;
+  std::atomic<uint64_t> hits_ = 0;
+  std::atomic<uint64_t> misses_ = 0;
+};
+
 class FrameReader {
 public:
   FrameReader();
@@ -32,11 +73,17 @@ public:
 
 private:
   bool initHardwareDecoder(AVHWDeviceType hw_device_type);
+  // decodes frame idx into buf, if any, and caches the frames decoded on the way. decode_lock_ must be held.
   bool decode(int idx, VisionBuf *buf);
   AVFrame * decodeFrame(AVPacket *pkt);
-  bool copyBuffers(AVFrame *f, VisionBuf *buf);
+  bool copyBuffers(AVFrame *f, uint8_t *y, uint8_t *uv, int stride);
+  void copyBuffers(const FrameCache::Frame &frame, VisionBuf *buf);
+  void prefetch(int idx);
+  void prefetchThread();
 
+  std::string file_;
   std::vector<AVPacket*> packets;
+  std::vector<int> key_frames_;
   std::unique_ptr<AVFrame, AVFrameDeleter>av_frame_, hw_frame;
   AVFormatContext *input_ctx = nullptr;
   AVCodecContext *decoder_ctx = nullptr;
@@ -48,4 +95,16 @@ private:
   AVBufferRef *hw_device_ctx = nullptr;
   int prev_idx = -1;
   inline static std::atomic<bool> has_hw_decoder = true;
+
+  // the decoder is shared by get() and the prefetch thread, which decodes the next GOP ahead of the last get().
+  // get() goes first: the prefetch thread waits on decode_cv_ while readers are waiting for the decoder.
+  std::mutex decode_lock_;
+  std::condition_variable decode_cv_;
+  std::atomic<int> readers_waiting_ = 0;
+  std::once_flag prefetch_once_;
+  std::thread prefetch_thread_;
+  std::mutex prefetch_lock_;
+  std::condition_variable prefetch_cv_;
+  std::atomic<int> prefetch_idx_ = -1;
+  std::atomic<bool> exit_ = false;
 };
@@ -1,6 +1,18 @@
 #include "tools/replay/logreader.h"
 
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
 #include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "common/util.h"
 #include "tools/replay/filereader.h"
 #include "tools/replay/util.h"
 
@@ -27,7 +39,11 @@ Event::Event(const kj::ArrayPtr<const capnp::word> &amsg, bool frame) : reader(a
 
 // class LogReader
 
-LogReader::LogReader(size_t memory_pool_block_size) {
+LogReader::LogReader(const std::vector<bool> &filters, size_t memory_pool_block_size) : filters_(filters) {
+  if (!filters_.empty()) {
+    // only some of the events are materialized, the pool grows if they don't fit
+    memory_pool_block_size /= 10;
+  }
 #ifdef HAS_MEMORY_RESOURCE
   const size_t buf_size = sizeof(Event) * memory_pool_block_size;
   mbr_ = std::make_unique<std::pmr::monotonic_buffer_resource>(buf_size);
@@ -36,20 +52,62 @@ LogReader::LogReader(size_t memory_pool_block_size) {
 }
 
 LogReader::~LogReader() {
+  clear();
+}
+
+void LogReader::clear() {
   for (Event *e : events) {
     delete e;
   }
+  events.clear();
+  skipped_events_.clear();
+#ifdef HAS_MEMORY_RESOURCE
+  mbr_->release();
+#endif
+  raw_.clear();
+  chunks_.clear();
+  chunk_size_ = chunk_parsed_ = 0;
+  parse_failed_ = false;
+  if (cache_map_) {
+    munmap(cache_map_, cache_map_size_);
+    cache_map_ = nullptr;
+    cache_map_size_ = 0;
+  }
 }
 
 bool LogReader::load(const std::string &url, std::atomic<bool> *abort, bool local_cache, int chunk_size, int retries) {
-  raw_ = FileReader(local_cache, chunk_size, retries).read(url, abort);
-  if (raw_.empty()) return false;
+  if (local_cache && loadCache(url)) return true;
 
+  std::string data = FileReader(local_cache, chunk_size, retries).read(url, abort);
+  if (data.empty()) return false;
+
+  bool ret = false;
   if (url.find(".bz2") != std::string::npos) {
-    raw_ = decompressBZ2(raw_, abort);
-    if (raw_.empty()) return false;
+    // the blocks are decompressed in parallel and parsed as they come in
+    auto output = [&](const char *block, size_t size) { append(block, size, abort); };
+    if (decompressBZ2Parallel((const std::byte *)data.data(), data.size(), output, abort)) {
+      ret = finishLoad(abort);
+    } else if (!(abort && *abort)) {
+      // e.g. a truncated file, decompress what can be
+      clear();
+      raw_ = decompressBZ2(data, abort);
+      ret = !raw_.empty() && parse(abort);
+    }
+  } else if (url.find(".zst") != std::string::npos) {
+    raw_ = decompressZST(data, abort);
+    ret = !raw_.empty() && parse(abort);
+  } else {
+    raw_ = std::move(data);
+    ret = parse(abort);
   }
-  return parse(abort);
+
+  if (ret && local_cache && !parse_failed_ && writeCache(url) && !filters_.empty()) {
+    // The skipped events now refer to the mapped cache instead of the decompressed log, only the
+    // pages of the loaded events stay in memory.
+    clear();
+    ret = loadCache(url) || load(url, abort, false, chunk_size, retries);
+  }
+  return ret;
 }
 
 bool LogReader::load(const std::byte *data, size_t size, std::atomic<bool> *abort) {
@@ -58,9 +116,64 @@ bool LogReader::load(const std::byte *data, size_t size, std::atomic<bool> *abor
 }
 
 bool LogReader::parse(std::atomic<bool> *abort) {
+  kj::ArrayPtr<const capnp::word> words((const capnp::word *)raw_.data(), raw_.size() / sizeof(capnp::word));
+  parseEvents(words, abort);
+  return finishLoad(abort);
+}
+
+void LogReader::append(const char *data, size_t size, std::atomic<bool> *abort) {
+  const size_t min_chunk_words = 1 << 20;  // 8 MB
+
+  while (size > 0 && !parse_failed_ && !(abort && *abort)) {
+    size_t capacity = chunks_.empty() ? 0 : chunks_.back().size() * sizeof(capnp::word);
+    if (chunk_size_ == capacity) {
+      // the event at the end doesn't fit, it starts the next chunk
+      const size_t pending = chunk_size_ - chunk_parsed_;
+      auto chunk = kj::heapArray<capnp::word>(std::max(min_chunk_words, pending / sizeof(capnp::word) * 2));
+      if (pending > 0) {
+        memcpy(chunk.begin(), (const char *)chunks_.back().begin() + chunk_parsed_, pending);
+      }
+      chunks_.push_back(std::move(chunk));
+      capacity = chunks_.back().size() * sizeof(capnp::word);
+      chunk_size_ = pending;
+      chunk_parsed_ = 0;
+    }
+
+    const size_t n = std::min(size, capacity - chunk_size_);
+    char *chunk = (char *)chunks_.back().begin();
+    memcpy(chunk + chunk_size_, data, n);
+    chunk_size_ += n;
+    data += n;
+    size -= n;
+
+    kj::ArrayPtr<const capnp::word> words((const capnp::word *)(chunk + chunk_parsed_),
+                                          (chunk_size_ - chunk_parsed_) / sizeof(capnp::word));
+    chunk_parsed_ += parseEvents(words, abort) * sizeof(capnp::word);
+  }
+}
+
+size_t LogReader::parseEvents(kj::ArrayPtr<const capnp::word> words, std::atomic<bool> *abort) {
+  const capnp::word *begin = words.begin();
   try {
-    kj::ArrayPtr<const capnp::word> words((const capnp::word *)raw_.data(), raw_.size() / sizeof(capnp::word));
-    while (words.size() > 0 && !(abort && *abort)) {
+    while (words.size() > 0 && capnp::expectedSizeInWordsFromPrefix(words) <= words.size() && !(abort && *abort)) {
+      if (!filters_.empty()) {
+        capnp::FlatArrayMessageReader reader(words);
+        auto event = reader.getRoot<cereal::Event>();
+        const cereal::Event::Which which = event.which();
+        if (!isWanted(which)) {
+          kj::ArrayPtr<const capnp::word> event_words(words.begin(), reader.getEnd());
+          skipped_events_.push_back({event.getLogMonoTime(), event_words, which, false});
+          if (which == cereal::Event::ROAD_ENCODE_IDX ||
+              which == cereal::Event::DRIVER_ENCODE_IDX ||
+              which == cereal::Event::WIDE_ROAD_ENCODE_IDX) {
+            Event frame_evt(words, true);
+            skipped_events_.push_back({frame_evt.mono_time, event_words, which, true});
+          }
+          words = kj::arrayPtr(reader.getEnd(), words.end());
+          continue;
+        }
+      }
+
 #ifdef HAS_MEMORY_RESOURCE
       Event *evt = new (mbr_.get()) Event(words);
 #else
@@ -88,11 +201,203 @@ bool LogReader::parse(std::atomic<bool> *abort) {
     if (!events.empty()) {
       rWarning("read %zu events from corrupt log", events.size());
     }
+    parse_failed_ = true;
   }
+  return words.begin() - begin;
+}
 
+bool LogReader::finishLoad(std::atomic<bool> *abort) {
   if (!events.empty() && !(abort && *abort)) {
-    std::sort(events.begin(), events.end(), Event::lessThan());
+    // logs are written mostly in order, often there is nothing to sort
+    if (!std::is_sorted(events.begin(), events.end(), Event::lessThan())) {
+      std::sort(events.begin(), events.end(), Event::lessThan());
+    }
     return true;
   }
   return false;
 }
+
+uint64_t LogReader::lastMonoTime() const {
+  uint64_t mono_time = events.empty() ? 0 : events.back()->mono_time;
+  for (const EventRef &e : skipped_events_) {
+    mono_time = std::max(mono_time, e.mono_time);
+  }
+  return mono_time;
+}
+
+// class LogReader: log cache
+
+namespace {
+
+const uint32_t LOG_CACHE_MAGIC = 0x474f4c52;  // "RLOG"
+const uint32_t LOG_CACHE_VERSION = 1;
+
+struct LogCacheHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t source_size;  // of a local log, a remote one doesn't change
+  int64_t source_mtime;
+  uint64_t event_count;
+  uint64_t data_offset;  // bytes from the start of the file
+  uint64_t file_size;
+};
+
+struct LogCacheIndexEntry {
+  uint64_t mono_time;
+  uint64_t offset;  // words from data_offset
+  uint32_t size;  // words
+  uint16_t which;
+  uint8_t frame;
+  uint8_t reserved;
+};
+
+std::string logCachePath(const std::string &url) {
+  return cacheFilePath(url) + ".events";
+}
+
+bool sourceStat(const std::string &url, uint64_t &size, int64_t &mtime) {
+  size = mtime = 0;
+  if (url.find("https://") == 0) return true;
+
+  struct stat st;
+  if (stat(url.c_str(), &st) != 0) return false;
+  size = st.st_size;
+  mtime = st.st_mtime;
+  return true;
+}
+
+}  // namespace
+
+bool LogReader::loadCache(const std::string &url) {
+  uint64_t source_size;
+  int64_t source_mtime;
+  if (!sourceStat(url, source_size, source_mtime)) return false;
+
+  int fd = open(logCachePath(url).c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return false;
+
+  struct stat st;
+  void *p = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && st.st_size >= sizeof(LogCacheHeader)) {
+    p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (p == MAP_FAILED) return false;
+
+  cache_map_ = p;
+  cache_map_size_ = st.st_size;
+
+  const LogCacheHeader *header = (const LogCacheHeader *)p;
+  // the index must fit in the file before its size is computed, event_count could overflow it
+  const size_t max_events = (st.st_size - sizeof(LogCacheHeader)) / sizeof(LogCacheIndexEntry);
+  if (header->magic != LOG_CACHE_MAGIC || header->version != LOG_CACHE_VERSION || header->file_size != st.st_size ||
+      header->source_size != source_size || header->source_mtime != source_mtime || header->event_count == 0 ||
+      header->event_count > max_events || header->data_offset % sizeof(capnp::word) != 0 ||
+      header->data_offset < sizeof(LogCacheHeader) + header->event_count * sizeof(LogCacheIndexEntry) ||
+      header->data_offset > st.st_size) {
+    clear();
+    return false;
+  }
+
+  const LogCacheIndexEntry *index = (const LogCacheIndexEntry *)(header + 1);
+  const capnp::word *data = (const capnp::word *)((const char *)p + header->data_offset);
+  const size_t data_words = (st.st_size - header->data_offset) / sizeof(capnp::word);
+  try {
+    events.reserve(header->event_count);
+    for (size_t i = 0; i < header->event_count; ++i) {
+      const LogCacheIndexEntry &e = index[i];
+      if (e.offset > data_words || e.size == 0 || e.size > data_words - e.offset || e.frame > 1) {
+        throw std::out_of_range("corrupt index entry");
+      }
+      kj::ArrayPtr<const capnp::word> words(data + e.offset, e.size);
+      if (!isWanted((cereal::Event::Which)e.which)) {
+        // the data is left alone, its pages are never read
+        skipped_events_.push_back({e.mono_time, words, (cereal::Event::Which)e.which, (bool)e.frame});
+        continue;
+      }
+#ifdef HAS_MEMORY_RESOURCE
+      Event *evt = new (mbr_.get()) Event(words, (cereal::Event::Which)e.which, e.mono_time, e.frame);
+#else
+      Event *evt = new Event(words, (cereal::Event::Which)e.which, e.mono_time, e.frame);
+#endif
+      events.push_back(evt);
+    }
+  } catch (const std::exception &e) {
+    rWarning("corrupt log cache %s", logCachePath(url).c_str());
+    clear();
+    return false;
+  } catch (const kj::Exception &e) {
+    rWarning("corrupt log cache %s: %s", logCachePath(url).c_str(), e.getDescription().cStr());
+    clear();
+    return false;
+  }
+  return true;
+}
+
+bool LogReader::writeCache(const std::string &url) {
+  const size_t event_count = events.size() + skipped_events_.size();
+  LogCacheHeader header = {.magic = LOG_CACHE_MAGIC, .version = LOG_CACHE_VERSION, .event_count = event_count};
+  if (!sourceStat(url, header.source_size, header.source_mtime)) return false;
+  header.data_offset = sizeof(header) + event_count * sizeof(LogCacheIndexEntry);
+  header.data_offset = (header.data_offset + sizeof(capnp::word) - 1) / sizeof(capnp::word) * sizeof(capnp::word);
+
+  // the data of every event once, frame events share it with their encodeIdx event
+  std::unordered_map<const capnp::word *, uint64_t> offsets;
+  std::vector<kj::ArrayPtr<const capnp::word>> data;
+  uint64_t data_words = 0;
+  std::vector<LogCacheIndexEntry> index;
+  index.reserve(event_count);
+  auto add_event = [&](kj::ArrayPtr<const capnp::word> words, uint64_t mono_time, cereal::Event::Which which, bool frame) {
+    auto [it, inserted] = offsets.try_emplace(words.begin(), data_words);
+    if (inserted) {
+      data.push_back(words);
+      data_words += words.size();
+    }
+    index.push_back({.mono_time = mono_time, .offset = it->second, .size = (uint32_t)words.size(),
+                     .which = (uint16_t)which, .frame = frame});
+  };
+  for (const Event *evt : events) {
+    add_event(evt->words, evt->mono_time, evt->which, evt->frame);
+  }
+  if (!skipped_events_.empty()) {
+    // the cache holds every service, whatever was loaded
+    for (const EventRef &e : skipped_events_) {
+      add_event(e.words, e.mono_time, e.which, e.frame);
+    }
+    std::stable_sort(index.begin(), index.end(), [](auto &l, auto &r) {
+      return l.mono_time < r.mono_time || (l.mono_time == r.mono_time && l.which < r.which);
+    });
+  }
+  header.file_size = header.data_offset + data_words * sizeof(capnp::word);
+
+  // written to a temp file and renamed, readers never see a partial cache
+  const std::string path = logCachePath(url);
+  std::string tmp_path = path + ".tmp_XXXXXX";
+  int fd = mkstemp(tmp_path.data());
+  if (fd < 0) return false;
+
+  std::vector<struct iovec> iov;
+  auto add = [&](const void *p, size_t size) { iov.push_back({(void *)p, size}); };
+  const char padding[sizeof(capnp::word)] = {};
+  add(&header, sizeof(header));
+  add(index.data(), index.size() * sizeof(LogCacheIndexEntry));
+  add(padding, header.data_offset - sizeof(header) - index.size() * sizeof(LogCacheIndexEntry));
+  for (auto &words : data) {
+    add(words.begin(), words.size() * sizeof(capnp::word));
+  }
+
+  bool ok = true;
+  for (size_t i = 0; i < iov.size() && ok; i += IOV_MAX) {
+    const int cnt = std::min<size_t>(IOV_MAX, iov.size() - i);
+    size_t expected = 0;
+    for (int j = 0; j < cnt; ++j) expected += iov[i + j].iov_len;
+    ok = HANDLE_EINTR(writev(fd, &iov[i], cnt)) == (ssize_t)expected;
+  }
+  close(fd);
+  if (!ok || rename(tmp_path.c_str(), path.c_str()) != 0) {
+    rWarning("failed to write log cache %s", path.c_str());
+    unlink(tmp_path.c_str());
+    return false;
+  }
+  return true;
+}
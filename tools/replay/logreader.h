@@ -24,6 +24,13 @@ public:
     this->mono_time = mono_time;
   }
   Event(const kj::ArrayPtr<const capnp::word> &amsg, bool frame = false);
+  // an event of the log cache, the index has its which and mono_time
+  Event(const kj::ArrayPtr<const capnp::word> &amsg, cereal::Event::Which which, uint64_t mono_time, bool frame)
+      : reader(amsg), words(amsg), frame(frame) {
+    this->event = reader.getRoot<cereal::Event>();
+    this->which = which;
+    this->mono_time = mono_time;
+  }
   inline kj::ArrayPtr<const capnp::byte> bytes() const { return words.asBytes(); }
 
   struct lessThan {
@@ -51,16 +58,53 @@ public:
 
 class LogReader {
 public:
-  LogReader(size_t memory_pool_block_size = DEFAULT_EVENT_MEMORY_POOL_BLOCK_SIZE);
+  // filters: the services to load, indexed by cereal::Event::Which, empty for all of them.
+  // Events of the other services are not materialized, only a reference to their data is kept.
+  LogReader(const std::vector<bool> &filters = {}, size_t memory_pool_block_size = DEFAULT_EVENT_MEMORY_POOL_BLOCK_SIZE);
   ~LogReader();
   bool load(const std::string &url, std::atomic<bool> *abort = nullptr,
             bool local_cache = false, int chunk_size = -1, int retries = 0);
   bool load(const std::byte *data, size_t size, std::atomic<bool> *abort = nullptr);
+  // the time of the last event of the log, including the filtered out ones
+  uint64_t lastMonoTime() const;
   std::vector<Event*> events;
 
 private:
   bool parse(std::atomic<bool> *abort);
+  // Appends decompressed log data, the complete events in it are parsed right away
+  void append(const char *data, size_t size, std::atomic<bool> *abort);
+  // Parses the events at the start of words, returns the number of words they take
+  size_t parseEvents(kj::ArrayPtr<const capnp::word> words, std::atomic<bool> *abort);
+  bool finishLoad(std::atomic<bool> *abort);
+  void clear();
+  // The decompressed events of a log and their sorted index, in a file next to the download cache.
+  // It is mmapped on later loads, so there is nothing to decompress or parse, and the pages are
+  // shared by every process that has the log open.
+  bool loadCache(const std::string &url);
+  bool writeCache(const std::string &url);
+  inline bool isWanted(cereal::Event::Which which) const {
+    return filters_.empty() || (which < filters_.size() && filters_[which]);
+  }
+
+  // an event of a filtered out service
+  struct EventRef {
+    uint64_t mono_time;
+    kj::ArrayPtr<const capnp::word> words;
+    cereal::Event::Which which;
+    bool frame;
+  };
+  std::vector<bool> filters_;
+  std::vector<EventRef> skipped_events_;
+
   std::string raw_;
+  // Data of a log loaded by append(). Every event is contiguous and word aligned in one chunk,
+  // an event cut off at the end of a chunk is moved to the next one.
+  std::vector<kj::Array<capnp::word>> chunks_;
+  size_t chunk_size_ = 0;  // bytes written to the last chunk
+  size_t chunk_parsed_ = 0;  // bytes of the last chunk that are parsed
+  bool parse_failed_ = false;
+  void *cache_map_ = nullptr;
+  size_t cache_map_size_ = 0;
 #ifdef HAS_MEMORY_RESOURCE
   std::unique_ptr<std::pmr::monotonic_buffer_resource> mbr_;
 #endif
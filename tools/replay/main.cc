@@ -32,6 +32,7 @@ int main(int argc, char *argv[]) {
   parser.addOption({{"a", "allow"}, "whitelist of services to send", "allow"});
   parser.addOption({{"b", "block"}, "blacklist of services to send", "block"});
   parser.addOption({{"c", "cache"}, "cache <n> segments in memory. default is 5", "n"});
+  parser.addOption({"frame-cache", "cache up to <n> MB of decoded frames, every frame is copied into it. off by default", "n"});
   parser.addOption({{"s", "start"}, "start from <seconds>", "seconds"});
   parser.addOption({"x", QString("playback <speed>. between %1 - %2")
                         .arg(ConsoleUI::speed_array.front()).arg(ConsoleUI::speed_array.back()), "speed"});
@@ -69,6 +70,9 @@ int main(int argc, char *argv[]) {
   if (!parser.value("c").isEmpty()) {
     replay->setSegmentCacheLimit(parser.value("c").toInt());
   }
+  if (!parser.value("frame-cache").isEmpty()) {
+    FrameCache::instance().setMaxSize((size_t)std::max(0, parser.value("frame-cache").toInt()) << 20);
+  }
   if (!parser.value("x").isEmpty()) {
     replay->setSpeed(std::clamp(parser.value("x").toFloat(),
                                 ConsoleUI::speed_array.front(), ConsoleUI::speed_array.back()));
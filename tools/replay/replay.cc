@@ -23,6 +23,13 @@ Replay::Replay(QString route, QStringList allow, QStringList block, SubMaster *s
     }
   }
 
+  // only the published services are loaded, and the ones the stream starts from
+  filters_.resize(sockets_.size());
+  for (int i = 0; i < sockets_.size(); ++i) {
+    filters_[i] = sockets_[i] != nullptr;
+  }
+  filters_[cereal::Event::Which::INIT_DATA] = filters_[cereal::Event::Which::CAR_PARAMS] = true;
+
   std::vector<const char *> s;
   std::copy_if(sockets_.begin(), sockets_.end(), std::back_inserter(s),
                [](const char *name) { return name != nullptr; });
@@ -33,8 +40,6 @@ Replay::Replay(QString route, QStringList allow, QStringList block, SubMaster *s
     pm = std::make_unique<PubMaster>(s);
   }
   route_ = std::make_unique<Route>(route, data_dir);
-  events_ = std::make_unique<std::vector<Event *>>();
-  new_events_ = std::make_unique<std::vector<Event *>>();
 }
 
 Replay::~Replay() {
@@ -89,6 +94,7 @@ void Replay::updateEvents(const std::function<bool()> &lambda) {
   updating_events_ = true;
   {
     std::unique_lock lk(stream_lock_);
+    mergePendingEvents();
     events_updated_ = lambda();
     updating_events_ = false;
   }
@@ -135,9 +141,16 @@ void Replay::buildTimeline() {
     [(int)cereal::ControlsState::AlertStatus::CRITICAL] = TimelineType::AlertCritical,
   };
 
+  // what the timeline and the qLogLoaded receivers use
+  std::vector<bool> filters(sockets_.size());
+  for (auto which : {cereal::Event::Which::INIT_DATA, cereal::Event::Which::CONTROLS_STATE,
+                     cereal::Event::Which::USER_FLAG, cereal::Event::Which::THUMBNAIL}) {
+    filters[which] = true;
+  }
+
   const auto &route_segments = route_->segments();
   for (auto it = route_segments.cbegin(); it != route_segments.cend() && !exit_; ++it) {
-    std::shared_ptr<LogReader> log(new LogReader());
+    std::shared_ptr<LogReader> log(new LogReader(filters));
     if (!log->load(it->second.qlog.toStdString(), &exit_, !hasFlag(REPLAY_FLAG_NO_FILE_CACHE), 0, 3)) continue;
 
     for (const Event *e : log->events) {
@@ -230,7 +243,7 @@ void Replay::queueSegment() {
   auto it = std::find_if(cur, end, [](auto &it) { return !it.second || !it.second->isLoaded(); });
   if (it != end && !it->second) {
     rDebug("loading segment %d...", it->first);
-    it->second = std::make_unique<Segment>(it->first, route_->at(it->first), flags_);
+    it->second = std::make_unique<Segment>(it->first, route_->at(it->first), flags_, filters_);
     QObject::connect(it->second.get(), &Segment::loadFinished, this, &Replay::segmentLoadFinished);
   }
 
@@ -250,11 +263,9 @@ void Replay::queueSegment() {
 
 void Replay::mergeSegments(const SegmentMap::iterator &begin, const SegmentMap::iterator &end) {
   std::vector<int> segments_need_merge;
-  size_t new_events_size = 0;
   for (auto it = begin; it != end; ++it) {
     if (it->second && it->second->isLoaded()) {
       segments_need_merge.push_back(it->first);
-      new_events_size += it->second->log->events.size();
     }
   }
 
@@ -265,28 +276,69 @@ void Replay::mergeSegments(const SegmentMap::iterator &begin, const SegmentMap::
       if (i != segments_need_merge.size() - 1) s += ", ";
     }
     rDebug("merge segments %s", s.c_str());
-    new_events_->clear();
-    new_events_->reserve(new_events_size);
+
+    // only the newly loaded segments are filtered, the merged ones keep their events
+    SegmentEvents new_events;
     for (int n : segments_need_merge) {
-      size_t size = new_events_->size();
+      if (std::binary_search(segments_merged_.begin(), segments_merged_.end(), n)) continue;
+
       const auto &events = segments_[n]->log->events;
-      std::copy_if(events.begin(), events.end(), std::back_inserter(*new_events_),
+      auto &filtered = new_events[n];
+      filtered.reserve(events.size());
+      std::copy_if(events.begin(), events.end(), std::back_inserter(filtered),
                    [this](auto e) { return e->which < sockets_.size() && sockets_[e->which] != nullptr; });
-      std::inplace_merge(new_events_->begin(), new_events_->begin() + size, new_events_->end(), Event::lessThan());
+    }
+    const bool dropped = std::any_of(segments_merged_.begin(), segments_merged_.end(), [&](int n) {
+      return !std::binary_search(segments_need_merge.begin(), segments_need_merge.end(), n);
+    });
+    segments_merged_ = segments_need_merge;
+    {
+      std::lock_guard lk(pending_events_lock_);
+      for (auto &[n, events] : new_events) {
+        pending_events_[n] = std::move(events);
+      }
+      has_pending_events_ = true;
     }
 
     if (stream_thread_) {
       emit segmentsMerged();
     }
-    updateEvents([&]() {
-      events_.swap(new_events_);
-      segments_merged_ = segments_need_merge;
-      // Do not wake up the stream thread if the current segment has not been merged.
-      return isSegmentMerged(current_segment_) || (segments_.count(current_segment_) == 0);
-    });
+    // A streaming thread picks up the new segments itself. The dropped segments are freed after this,
+    // so the stream thread has to let go of them first.
+    if (dropped || !streaming_) {
+      SegmentEvents dropped_events;
+      updateEvents([&]() {
+        for (auto it = merged_events_.begin(); it != merged_events_.end();) {
+          auto cur = it++;
+          if (!std::binary_search(segments_merged_.begin(), segments_merged_.end(), cur->first)) {
+            dropped_events.insert(merged_events_.extract(cur));
+          }
+        }
+        last_event_mono_time_ = 0;
+        for (const auto &[n, events] : merged_events_) {
+          if (!events.empty()) last_event_mono_time_ = std::max<uint64_t>(last_event_mono_time_, events.back()->mono_time);
+        }
+        // Do not wake up the stream thread if the current segment has not been merged.
+        return isSegmentMerged(current_segment_) || (segments_.count(current_segment_) == 0);
+      });
+    }
   }
 }
 
+// must be called with stream_lock_ held
+bool Replay::mergePendingEvents() {
+  if (!has_pending_events_) return false;
+
+  std::lock_guard lk(pending_events_lock_);
+  for (auto &[n, events] : pending_events_) {
+    if (!events.empty()) last_event_mono_time_ = std::max<uint64_t>(last_event_mono_time_, events.back()->mono_time);
+    merged_events_[n] = std::move(events);
+  }
+  pending_events_.clear();
+  has_pending_events_ = false;
+  return true;
+}
+
 void Replay::startStream(const Segment *cur_segment) {
   const auto &events = cur_segment->log->events;
 
@@ -364,16 +416,20 @@ void Replay::publishFrame(const Event *e) {
 void Replay::stream() {
   cereal::Event::Which cur_which = cereal::Event::Which::INIT_DATA;
   double prev_replay_speed = speed_;
+  EventCursor cursor;
   std::unique_lock lk(stream_lock_);
 
   while (true) {
-    stream_cv_.wait(lk, [=]() { return exit_ || (events_updated_ && !paused_); });
+    streaming_ = false;
+    stream_cv_.wait(lk, [=]() { return exit_ || ((events_updated_ || has_pending_events_) && !paused_); });
+    streaming_ = true;
     events_updated_ = false;
     if (exit_) break;
 
+    mergePendingEvents();
     Event cur_event(cur_which, cur_mono_time_);
-    auto eit = std::upper_bound(events_->begin(), events_->end(), &cur_event, Event::lessThan());
-    if (eit == events_->end()) {
+    cursor.seek(merged_events_, &cur_event);
+    if (cursor.done()) {
       rInfo("waiting for events...");
       continue;
     }
@@ -381,8 +437,15 @@ void Replay::stream() {
     uint64_t evt_start_ts = cur_mono_time_;
     uint64_t loop_start_ts = nanos_since_boot();
 
-    for (auto end = events_->end(); !updating_events_ && eit != end; ++eit) {
-      const Event *evt = (*eit);
+    while (!updating_events_) {
+      if (mergePendingEvents()) {
+        // segments loaded while streaming, continue after the last published event
+        Event last_event(cur_which, cur_mono_time_);
+        cursor.seek(merged_events_, &last_event);
+      }
+      if (cursor.done()) break;
+
+      const Event *evt = cursor.next();
       cur_which = evt->which;
       cur_mono_time_ = evt->mono_time;
       setCurrentSegment(toSeconds(cur_mono_time_) / 60);
@@ -417,7 +480,7 @@ void Replay::stream() {
       camera_server_->waitForSent();
     }
 
-    if (eit == events_->end() && !hasFlag(REPLAY_FLAG_NO_LOOP)) {
+    if (cursor.done() && !hasFlag(REPLAY_FLAG_NO_LOOP)) {
       int last_segment = segments_.empty() ? 0 : segments_.rbegin()->first;
       if (current_segment_ >= last_segment && isSegmentMerged(last_segment)) {
         rInfo("reaches the end of route, restart from beginning");
@@ -426,3 +489,38 @@ void Replay::stream() {
     }
   }
 }
+
+// class EventCursor
+
+namespace {
+
+// orders the heads of EventCursor so the earliest event is on top of the heap
+template <class Range>
+bool laterHead(const Range &l, const Range &r) {
+  return Event::lessThan()(*r.first, *l.first);
+}
+
+}  // namespace
+
+void EventCursor::seek(const SegmentEvents &segments, const Event *e) {
+  heads_.clear();
+  for (const auto &[n, events] : segments) {
+    auto it = std::upper_bound(events.begin(), events.end(), e, Event::lessThan());
+    if (it != events.end()) {
+      heads_.emplace_back(it, events.end());
+    }
+  }
+  std::make_heap(heads_.begin(), heads_.end(), laterHead<Range>);
+}
+
+const Event *EventCursor::next() {
+  std::pop_heap(heads_.begin(), heads_.end(), laterHead<Range>);
+  Range &head = heads_.back();
+  const Event *e = *head.first++;
+  if (head.first == head.second) {
+    heads_.pop_back();
+  } else {
+    std::push_heap(heads_.begin(), heads_.end(), laterHead<Range>);
+  }
+  return e;
+}
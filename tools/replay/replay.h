@@ -44,6 +44,24 @@ enum class TimelineType { None, Engaged, AlertInfo, AlertWarning, AlertCritical,
 typedef bool (*replayEventFilter)(const Event *, void *);
 Q_DECLARE_METATYPE(std::shared_ptr<LogReader>);
 
+// the published events of each merged segment, sorted by Event::lessThan
+typedef std::map<int, std::vector<Event *>> SegmentEvents;
+
+// Walks the events of several segments in order, a k-way merge of their sorted events.
+class EventCursor {
+public:
+  // moves the cursor to the first event after e
+  void seek(const SegmentEvents &segments, const Event *e);
+  inline bool done() const { return heads_.empty(); }
+  // returns the current event and moves to the next one
+  const Event *next();
+
+private:
+  typedef std::pair<std::vector<Event *>::const_iterator, std::vector<Event *>::const_iterator> Range;
+  // a min heap of the remaining events of each segment
+  std::vector<Range> heads_;
+};
+
 class Replay : public QObject {
   Q_OBJECT
 
@@ -78,7 +96,7 @@ public:
   inline int totalSeconds() const { return (!segments_.empty()) ? (segments_.rbegin()->first + 1) * 60 : 0; }
   inline void setSpeed(float speed) { speed_ = speed; }
   inline float getSpeed() const { return speed_; }
-  inline const std::vector<Event *> *events() const { return events_.get(); }
+  inline uint64_t lastEventMonoTime() const { return last_event_mono_time_; }
   inline const std::map<int, std::unique_ptr<Segment>> &segments() const { return segments_; }
   inline const std::string &carFingerprint() const { return car_fingerprint_; }
   inline const std::vector<std::tuple<double, double, TimelineType>> getTimeline() {
@@ -104,12 +122,11 @@ protected:
   void queueSegment();
   void mergeSegments(const SegmentMap::iterator &begin, const SegmentMap::iterator &end);
   void updateEvents(const std::function<bool()>& lambda);
+  bool mergePendingEvents();
   void publishMessage(const Event *e);
   void publishFrame(const Event *e);
   void buildTimeline();
-  inline bool isSegmentMerged(int n) {
-    return std::find(segments_merged_.begin(), segments_merged_.end(), n) != segments_merged_.end();
-  }
+  inline bool isSegmentMerged(int n) { return merged_events_.count(n) > 0; }
 
   QThread *stream_thread_ = nullptr;
   std::mutex stream_lock_;
@@ -123,8 +140,16 @@ protected:
   bool events_updated_ = false;
   uint64_t route_start_ts_ = 0;
   std::atomic<uint64_t> cur_mono_time_ = 0;
-  std::unique_ptr<std::vector<Event *>> events_;
-  std::unique_ptr<std::vector<Event *>> new_events_;
+  SegmentEvents merged_events_;
+  std::atomic<uint64_t> last_event_mono_time_ = 0;
+
+  // Events of newly loaded segments. A streaming thread merges them itself, without being
+  // interrupted through updating_events_.
+  std::mutex pending_events_lock_;
+  SegmentEvents pending_events_;
+  std::atomic<bool> has_pending_events_ = false;
+  std::atomic<bool> streaming_ = false;
+  // the segments handed to the stream thread, only used in the main thread
   std::vector<int> segments_merged_;
 
   // messaging
@@ -134,6 +159,8 @@ protected:
   std::unique_ptr<Route> route_;
   std::unique_ptr<CameraServer> camera_server_;
   std::atomic<uint32_t> flags_ = REPLAY_FLAG_NONE;
+  // the services loaded from the logs, indexed by cereal::Event::Which
+  std::vector<bool> filters_;
 
   std::mutex timeline_lock;
   QFuture<void> timeline_future;
@@ -1,4 +1,7 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+
 #include <chrono>
+#include <deque>
 #include <thread>
 
 #include <QDebug>
@@ -70,6 +73,101 @@ TEST_CASE("LogReader") {
     REQUIRE(log.load((std::byte *)corrupt_content.data(), corrupt_content.size()));
     REQUIRE(log.events.size() > 0);
   }
+  SECTION("parallel bz2") {
+    FileReader reader(true);
+    const std::string compressed = reader.read(TEST_RLOG_URL);
+    std::string raw = decompressBZ2(compressed);
+
+    // more than one thread, also on a single core. The parallel path outputs every block on its own,
+    // the serial fallback outputs everything at once.
+    std::string parallel_raw;
+    int num_outputs = 0;
+    auto output = [&](const char *data, size_t size) {
+      parallel_raw.append(data, size);
+      num_outputs++;
+    };
+    REQUIRE(decompressBZ2Parallel((const std::byte *)compressed.data(), compressed.size(), output, nullptr, 4));
+    REQUIRE(num_outputs > 1);
+    REQUIRE(parallel_raw == raw);
+
+    LogReader expected;
+    REQUIRE(expected.load((std::byte *)raw.data(), raw.size()));
+
+    system(("rm " + cacheFilePath(TEST_RLOG_URL) + ".events -f").c_str());
+    LogReader log;
+    REQUIRE(log.load(TEST_RLOG_URL, nullptr, true));
+    REQUIRE(log.events.size() == expected.events.size());
+    for (int i = 0; i < log.events.size(); ++i) {
+      REQUIRE(log.events[i]->mono_time == expected.events[i]->mono_time);
+      REQUIRE(log.events[i]->bytes() == expected.events[i]->bytes());
+    }
+  }
+  SECTION("event cache") {
+    std::string events_cache_file = cacheFilePath(TEST_RLOG_URL) + ".events";
+    system(("rm " + events_cache_file + " -f").c_str());
+    LogReader expected;
+    REQUIRE(expected.load(TEST_RLOG_URL, nullptr, true));
+    REQUIRE(util::file_exists(events_cache_file));
+
+    LogReader log;
+    REQUIRE(log.load(TEST_RLOG_URL, nullptr, true));
+    REQUIRE(log.events.size() == expected.events.size());
+    for (int i = 0; i < log.events.size(); ++i) {
+      REQUIRE(log.events[i]->mono_time == expected.events[i]->mono_time);
+      REQUIRE(log.events[i]->which == expected.events[i]->which);
+      REQUIRE(log.events[i]->frame == expected.events[i]->frame);
+      REQUIRE(log.events[i]->bytes() == expected.events[i]->bytes());
+    }
+
+    // a truncated cache is a miss
+    truncate(events_cache_file.c_str(), util::read_file(events_cache_file).size() / 2);
+    LogReader reload;
+    REQUIRE(reload.load(TEST_RLOG_URL, nullptr, true));
+    REQUIRE(reload.events.size() == expected.events.size());
+
+    // so is a corrupt event count or index entry, the cache was rewritten by the reload
+    auto corrupt = [&](size_t pos, uint64_t value) {
+      std::string cache = util::read_file(events_cache_file);
+      REQUIRE(cache.size() >= pos + sizeof(value));
+      memcpy(cache.data() + pos, &value, sizeof(value));
+      REQUIRE(util::write_file(events_cache_file.c_str(), cache.data(), cache.size()) == 0);
+      LogReader log;
+      REQUIRE(log.load(TEST_RLOG_URL, nullptr, true));
+      REQUIRE(log.events.size() == expected.events.size());
+    };
+    corrupt(24, 1ULL << 60);  // event_count, overflows the index size
+    corrupt(48 + 8, UINT64_MAX);  // offset of the first entry
+  }
+  SECTION("service filter") {
+    LogReader expected;
+    REQUIRE(expected.load(TEST_RLOG_URL));
+    std::vector<Event *> can_events;
+    std::copy_if(expected.events.begin(), expected.events.end(), std::back_inserter(can_events),
+                 [](const Event *e) { return e->which == cereal::Event::Which::CAN; });
+    REQUIRE(can_events.size() > 0);
+
+    std::vector<bool> filters(cereal::Event::Which::CAN + 1);
+    filters[cereal::Event::Which::CAN] = true;
+    auto local_cache = GENERATE(false, true);
+    system(("rm " + cacheFilePath(TEST_RLOG_URL) + ".events -f").c_str());
+    for (int i = 0; i < 2; ++i) {
+      // with the local cache: written by the first load, mmapped by the second
+      LogReader log(filters);
+      REQUIRE(log.load(TEST_RLOG_URL, nullptr, local_cache));
+      REQUIRE(log.events.size() == can_events.size());
+      for (int j = 0; j < log.events.size(); ++j) {
+        REQUIRE(log.events[j]->mono_time == can_events[j]->mono_time);
+        REQUIRE(log.events[j]->bytes() == can_events[j]->bytes());
+      }
+    }
+
+    if (local_cache) {
+      // the cache written by a filtered load has every event
+      LogReader log;
+      REQUIRE(log.load(TEST_RLOG_URL, nullptr, true));
+      REQUIRE(log.events.size() == expected.events.size());
+    }
+  }
 }
 
 void read_segment(int n, const SegmentFile &segment_file, uint32_t flags) {
@@ -105,6 +203,13 @@ void read_segment(int n, const SegmentFile &segment_file, uint32_t flags) {
       for (int i = 0; i < 100; ++i) {
         REQUIRE(fr->get(i, &buf));
       }
+      // with the frame cache on, reading a frame again doesn't decode it
+      FrameCache::instance().setMaxSize(512 << 20);
+      REQUIRE(fr->get(50, &buf));
+      const uint64_t hits = FrameCache::instance().hits();
+      REQUIRE(fr->get(50, &buf));
+      REQUIRE(FrameCache::instance().hits() == hits + 1);
+      FrameCache::instance().setMaxSize(DEFAULT_FRAME_CACHE_SIZE);
     }
 
     loop.quit();
@@ -158,6 +263,25 @@ TEST_CASE("Remote route") {
   }
 }
 
+TEST_CASE("LogReader benchmark", "[.][benchmark]") {
+  std::string data_dir = download_demo_route();
+  Route route(DEMO_ROUTE, QString::fromStdString(data_dir));
+  REQUIRE(route.load());
+
+  for (const auto &[n, segment] : route.segments()) {
+    const std::string rlog = segment.rlog.toStdString();
+    BENCHMARK("segment " + std::to_string(n) + ": decompress, then parse") {
+      std::string raw = decompressBZ2(util::read_file(rlog));
+      LogReader log;
+      return log.load((std::byte *)raw.data(), raw.size());
+    };
+    BENCHMARK("segment " + std::to_string(n) + ": parallel, streaming") {
+      LogReader log;
+      return log.load(rlog);
+    };
+  }
+}
+
 // helper class for unit tests
 class TestReplay : public Replay {
  public:
@@ -179,15 +303,18 @@ void TestReplay::testSeekTo(int seek_to) {
     }
 
     Event cur_event(cereal::Event::Which::INIT_DATA, cur_mono_time_);
-    auto eit = std::upper_bound(events_->begin(), events_->end(), &cur_event, Event::lessThan());
-    if (eit == events_->end()) {
+    EventCursor cursor;
+    cursor.seek(merged_events_, &cur_event);
+    if (cursor.done()) {
       qDebug() << "waiting for events...";
       continue;
     }
 
-    REQUIRE(std::is_sorted(events_->begin(), events_->end(), Event::lessThan()));
+    for (const auto &[n, events] : merged_events_) {
+      REQUIRE(std::is_sorted(events.begin(), events.end(), Event::lessThan()));
+    }
     const int seek_to_segment = seek_to / 60;
-    const int event_seconds = ((*eit)->mono_time - route_start_ts_) / 1e9;
+    const int event_seconds = (cursor.next()->mono_time - route_start_ts_) / 1e9;
     current_segment_ = event_seconds / 60;
     INFO("seek to [" << seek_to << "s segment " << seek_to_segment << "], events [" << event_seconds << "s segment" << current_segment_ << "]");
     REQUIRE(event_seconds >= seek_to);
@@ -213,6 +340,36 @@ void TestReplay::test_seek() {
   thread.join();
 }
 
+TEST_CASE("EventCursor") {
+  // two overlapping segments and one after them
+  std::deque<Event> storage;
+  auto make_events = [&](std::vector<uint64_t> times) {
+    std::vector<Event *> events;
+    for (uint64_t t : times) {
+      events.push_back(&storage.emplace_back(cereal::Event::Which::CAN, t));
+    }
+    return events;
+  };
+  SegmentEvents segments;
+  segments[0] = make_events({1, 3, 5, 7});
+  segments[1] = make_events({2, 4, 6, 8, 10});
+  segments[2] = make_events({11, 12});
+
+  auto read_all = [&](uint64_t after) {
+    Event e(cereal::Event::Which::CAN, after);
+    EventCursor cursor;
+    cursor.seek(segments, &e);
+    std::vector<uint64_t> times;
+    while (!cursor.done()) {
+      times.push_back(cursor.next()->mono_time);
+    }
+    return times;
+  };
+  REQUIRE(read_all(0) == std::vector<uint64_t>{1, 2, 3, 4, 5, 6, 7, 8, 10, 11, 12});
+  REQUIRE(read_all(5) == std::vector<uint64_t>{6, 7, 8, 10, 11, 12});
+  REQUIRE(read_all(12).empty());
+}
+
 TEST_CASE("Replay") {
   TestReplay replay(DEMO_ROUTE);
   REQUIRE(replay.load());
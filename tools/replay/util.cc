@@ -3,17 +3,24 @@
 #include <bzlib.h>
 #include <curl/curl.h>
 #include <openssl/sha.h>
+#include <zstd.h>
 
+#include <algorithm>
+#include <array>
 #include <cstdarg>
 #include <cstring>
 #include <cassert>
 #include <cmath>
+#include <condition_variable>
 #include <fstream>
 #include <iostream>
 #include <map>
 #include <mutex>
 #include <numeric>
+#include <optional>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "common/timing.h"
 #include "common/util.h"
@@ -303,6 +310,241 @@ std::string decompressBZ2(const std::byte *in, size_t in_size, std::atomic<bool>
   return {};
 }
 
+// bz2 blocks are independent, and each one carries its own CRC. A block is cut out of the
+// stream by bit offsets and wrapped in a header and an end of stream marker of its own.
+// The markers aren't byte aligned, and nothing stops the compressed data from containing
+// one, so a wrong split shows up as a block that fails to decompress.
+namespace {
+
+const uint64_t BZ2_BLOCK_MAGIC = 0x314159265359ULL;
+const uint64_t BZ2_EOS_MAGIC = 0x177245385090ULL;
+
+uint64_t readBits(const uint8_t *in, uint64_t pos, int count) {
+  uint64_t v = 0;
+  for (int i = 0; i < count; ++i, ++pos) {
+    v = (v << 1) | ((in[pos / 8] >> (7 - pos % 8)) & 1);
+  }
+  return v;
+}
+
+void writeBits(uint8_t *out, uint64_t pos, uint64_t v, int count) {
+  for (int i = count - 1; i >= 0; --i, ++pos) {
+    out[pos / 8] |= ((v >> i) & 1) << (7 - pos % 8);
+  }
+}
+
+// Bit offset of the next block or end of stream marker at or after pos, and which one it is
+bool findBZ2Marker(const uint8_t *in, size_t in_size, uint64_t pos, uint64_t &found, bool &eos) {
+  const uint64_t mask = (1ULL << 48) - 1;
+  size_t i = pos / 8;
+  uint64_t window = 0;  // the 8 bytes at i
+  for (size_t j = 0; j < 8; ++j) {
+    window = (window << 8) | (i + j < in_size ? in[i + j] : 0);
+  }
+  // a marker starting in byte i fully covers byte i + 1, most bytes are ruled out by that one
+  static const auto second_bytes = []() {
+    std::array<bool, 256> ret = {};
+    for (int shift = 0; shift < 8; ++shift) {
+      ret[(BZ2_BLOCK_MAGIC >> (32 + shift)) & 0xff] = true;
+      ret[(BZ2_EOS_MAGIC >> (32 + shift)) & 0xff] = true;
+    }
+    return ret;
+  }();
+  for (; i + 6 <= in_size; ++i, window = (window << 8) | (i + 7 < in_size ? in[i + 7] : 0)) {
+    if (!second_bytes[(window >> 48) & 0xff]) continue;
+    for (int shift = 0; shift < 8; ++shift) {
+      const uint64_t bit = i * 8 + shift;
+      if (bit < pos || bit + 48 > in_size * 8) continue;
+      const uint64_t v = (window >> (16 - shift)) & mask;
+      if (v == BZ2_BLOCK_MAGIC || v == BZ2_EOS_MAGIC) {
+        found = bit;
+        eos = v == BZ2_EOS_MAGIC;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+struct BZ2Block {
+  uint64_t begin, end;  // bits
+};
+
+// The blocks of the first stream, like decompressBZ2 the rest of the file is ignored
+std::vector<BZ2Block> splitBZ2(const uint8_t *in, size_t in_size) {
+  std::vector<BZ2Block> blocks;
+  if (in_size < 4 + 6 || memcmp(in, "BZh", 3) != 0 || in[3] < '1' || in[3] > '9') return {};
+
+  uint64_t pos = 4 * 8;
+  bool eos = false;
+  uint64_t found;
+  if (!findBZ2Marker(in, in_size, pos, found, eos) || found != pos) return {};
+  while (!eos) {
+    // the marker is followed by the 32 bit block crc
+    if (!findBZ2Marker(in, in_size, pos + 48 + 32, found, eos)) return {};
+    blocks.push_back({pos, found});
+    pos = found;
+  }
+  return blocks;
+}
+
+std::string makeBZ2Stream(const uint8_t *in, size_t in_size, const BZ2Block &block) {
+  const uint64_t bits = block.end - block.begin;
+  std::string stream(4 + (bits + 48 + 32 + 7) / 8, '\0');
+  memcpy(stream.data(), in, 4);  // header and block size
+  uint8_t *out = (uint8_t *)stream.data() + 4;
+
+  const size_t first = block.begin / 8;
+  const int shift = block.begin % 8;
+  const size_t bytes = (bits + 7) / 8;
+  for (size_t i = 0; i < bytes; ++i) {
+    const uint16_t w = in[first + i] << 8 | (first + i + 1 < in_size ? in[first + i + 1] : 0);
+    out[i] = (w << shift) >> 8;
+  }
+  if (bits % 8) {
+    out[bytes - 1] &= 0xff << (8 - bits % 8);
+  }
+
+  // the crc of a stream with one block is the crc of that block
+  writeBits(out, bits, BZ2_EOS_MAGIC, 48);
+  writeBits(out, bits + 48, readBits(in, block.begin + 48, 32), 32);
+  return stream;
+}
+
+}  // namespace
+
+bool decompressBZ2Parallel(const std::byte *in, size_t in_size, const std::function<void(const char *, size_t)> &output,
+                           std::atomic<bool> *abort, int num_threads) {
+  const uint8_t *data = (const uint8_t *)in;
+  const std::vector<BZ2Block> blocks = splitBZ2(data, in_size);
+  if (blocks.empty()) return false;
+
+  const int n = blocks.size();
+  num_threads = std::min<int>(num_threads > 0 ? num_threads : std::thread::hardware_concurrency(), n);
+  if (num_threads <= 1) {
+    // a single block or core, decompressing the blocks separately only adds overhead
+    std::string out = decompressBZ2(in, in_size, abort);
+    if (out.empty()) return false;
+    output(out.data(), out.size());
+    return true;
+  }
+  // blocks decompressed ahead of the output, bounds the memory when output is slower
+  const int window = num_threads * 2;
+
+  std::mutex lock;
+  std::condition_variable cv;
+  std::vector<std::optional<std::string>> results(n);
+  int next = 0, consumed = 0;
+  bool stop = false;
+
+  auto worker = [&]() {
+    while (true) {
+      int i;
+      {
+        std::unique_lock lk(lock);
+        cv.wait(lk, [&]() { return stop || next >= n || next < consumed + window; });
+        if (stop || next >= n) return;
+        i = next++;
+      }
+      std::string stream = makeBZ2Stream(data, in_size, blocks[i]);
+      std::string out = decompressBZ2((const std::byte *)stream.data(), stream.size(), abort);
+      {
+        std::lock_guard lk(lock);
+        results[i] = std::move(out);
+      }
+      cv.notify_all();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back(worker);
+  }
+
+  bool ret = true;
+  for (int i = 0; i < n && ret; ++i) {
+    std::string out;
+    {
+      std::unique_lock lk(lock);
+      cv.wait(lk, [&]() { return results[i].has_value(); });
+      out = std::move(*results[i]);
+      results[i].reset();
+      consumed = i + 1;
+    }
+    cv.notify_all();
+
+    // a block is never empty, this one failed or was aborted
+    ret = !out.empty() && !(abort && *abort);
+    if (ret) output(out.data(), out.size());
+  }
+
+  {
+    std::lock_guard lk(lock);
+    stop = true;
+  }
+  cv.notify_all();
+  for (auto &t : threads) t.join();
+  return ret;
+}
+
+std::string decompressZST(const std::string &in, std::atomic<bool> *abort) {
+  return decompressZST((std::byte *)in.data(), in.size(), abort);
+}
+
+// Reads the seekable format written by loggerd. Its seek table gives the exact output size,
+// files without one (e.g. cut short by a crash) fall back to growing the buffer.
+static size_t zstdSeekableSize(const std::byte *in, size_t in_size) {
+  const size_t footer_size = 9;
+  if (in_size < footer_size + 8) return 0;
+
+  uint32_t num_frames, magic;
+  memcpy(&num_frames, in + in_size - footer_size, sizeof(num_frames));
+  memcpy(&magic, in + in_size - sizeof(magic), sizeof(magic));
+  if (magic != 0x8F92EAB1 || (uint64_t)num_frames * 8 + footer_size + 8 > in_size) return 0;
+
+  size_t size = 0;
+  const std::byte *table = in + in_size - footer_size - num_frames * 8;
+  for (uint32_t i = 0; i < num_frames; ++i) {
+    uint32_t decompressed_size;
+    memcpy(&decompressed_size, table + i * 8 + 4, sizeof(decompressed_size));
+    size += decompressed_size;
+  }
+  return size;
+}
+
+std::string decompressZST(const std::byte *in, size_t in_size, std::atomic<bool> *abort) {
+  if (in_size == 0) return {};
+
+  ZSTD_DCtx *dctx = ZSTD_createDCtx();
+  assert(dctx != nullptr);
+
+  size_t seekable_size = zstdSeekableSize(in, in_size);
+  std::string out(seekable_size > 0 ? seekable_size : in_size * 5, '\0');
+  ZSTD_inBuffer input = {in, in_size, 0};
+  ZSTD_outBuffer output = {out.data(), out.size(), 0};
+  size_t ret = 0;
+  while (input.pos < input.size && !(abort && *abort)) {
+    const size_t prev_in = input.pos, prev_out = output.pos;
+    ret = ZSTD_decompressStream(dctx, &output, &input);
+    if (ZSTD_isError(ret)) {
+      rWarning("decompressZST error : %s", ZSTD_getErrorName(ret));
+      break;
+    }
+    if (input.pos == prev_in && output.pos == prev_out) {
+      if (output.pos < output.size) break;
+      out.resize(out.size() * 2);
+      output = {out.data(), out.size(), output.pos};
+    }
+  }
+
+  ZSTD_freeDCtx(dctx);
+  if (!ZSTD_isError(ret) && !(abort && *abort)) {
+    out.resize(output.pos);
+    return out;
+  }
+  return {};
+}
+
 void precise_nano_sleep(long sleep_ns) {
   const long estimate_ns = 1 * 1e6;  // 1ms
   struct timespec req = {.tv_nsec = estimate_ns};
@@ -24,6 +24,13 @@ std::string sha256(const std::string &str);
 void precise_nano_sleep(long sleep_ns);
 std::string decompressBZ2(const std::string &in, std::atomic<bool> *abort = nullptr);
 std::string decompressBZ2(const std::byte *in, size_t in_size, std::atomic<bool> *abort = nullptr);
+// Decompresses the blocks of a .bz2 file on num_threads threads, 0 for all cores. output gets the data in order,
+// each block as soon as it and the ones before it are done. With a single block or thread the file is
+// decompressed in one piece instead. false if the file can't be split into blocks or a block is corrupt.
+bool decompressBZ2Parallel(const std::byte *in, size_t in_size, const std::function<void(const char *, size_t)> &output,
+                           std::atomic<bool> *abort = nullptr, int num_threads = 0);
+std::string decompressZST(const std::string &in, std::atomic<bool> *abort = nullptr);
+std::string decompressZST(const std::byte *in, size_t in_size, std::atomic<bool> *abort = nullptr);
 std::string getUrlWithoutQuery(const std::string &url);
 size_t getRemoteFileSize(const std::string &url, std::atomic<bool> *abort = nullptr);
 std::string httpGet(const std::string &url, size_t chunk_size = 0, std::atomic<bool> *abort = nullptr);